@@ -142,7 +142,15 @@ bcache::expand_hash_table ()
 const void *
 bcache::insert (const void *addr, int length, bool *added)
 {
-  unsigned long full_hash;
+  return insert_with_hash (addr, length, this->hash (addr, length), added);
+}
+
+/* See bcache.h.  */
+
+const void *
+bcache::insert_with_hash (const void *addr, int length,
+			  unsigned long full_hash, bool *added)
+{
   unsigned short half_hash;
   int hash_index;
   struct bstring *s;
@@ -167,8 +175,6 @@ bcache::insert (const void *addr, int length, bool *added)
   m_total_count++;
   m_total_size += length;
 
-  full_hash = this->hash (addr, length);
-
   half_hash = (full_hash >> 16);
   hash_index = full_hash % m_num_buckets;
 
@@ -22,6 +22,10 @@
 #ifndef BCACHE_H
 #define BCACHE_H 1
 
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
 /* A bcache is a data structure for factoring out duplication in
    read-only structures.  You give the bcache some string of bytes S.
    If the bcache already contains a copy of S, it hands you back a
@@ -154,6 +158,13 @@ struct bcache
 
   const void *insert (const void *addr, int length, bool *added = nullptr);
 
+  /* Like insert, but FULL_HASH is the value of the hash method for
+     the LENGTH bytes at ADDR.  */
+
+  const void *insert_with_hash (const void *addr, int length,
+				unsigned long full_hash,
+				bool *added = nullptr);
+
   /* Print statistics on this bcache's memory usage and efficacity at
      eliminating duplication.  TYPE should be a string describing the
      kind of data this bcache holds.  Statistics are printed using
@@ -161,12 +172,12 @@ struct bcache
   void print_statistics (const char *type);
   int memory_used ();
 
-protected:
-
   /* Hash function to be used for this bcache object.  Defaults to
      fast_hash.  */
   virtual unsigned long hash (const void *addr, int length);
 
+protected:
+
   /* Compare function to be used for this bcache object.  Defaults to
      memcmp.  */
   virtual int compare (const void *left, const void *right, int length);
@@ -205,6 +216,91 @@ struct bcache
   void expand_hash_table ();
 };
 
+/* A bcache that several threads can insert into at the same time.
+
+   The strings are spread over a fixed number of shards according to
+   their hash.  Each shard is a bcache of type T with its own lock, so
+   threads only wait for each other when they insert strings that
+   belong to the same shard.  Equal strings have the same hash, and
+   thus go to the same shard: duplicates are eliminated exactly as
+   they are by a single bcache of type T.
+
+   T must be gdb::bcache or a class derived from it.  */
+
+template<typename T = bcache>
+struct concurrent_bcache
+{
+  concurrent_bcache () = default;
+
+  DISABLE_COPY_AND_ASSIGN (concurrent_bcache);
+
+  /* See bcache::insert.  This can be called from any thread.  */
+
+  const void *insert (const void *addr, int length, bool *added = nullptr)
+  {
+    /* The hash methods don't depend on the state of the bcache, so
+       any shard can compute it without holding its lock.  */
+    unsigned long full_hash = m_shards[0].cache.hash (addr, length);
+    shard &s = m_shards[shard_index (full_hash)];
+
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (s.mutex);
+#endif
+    return s.cache.insert_with_hash (addr, length, full_hash, added);
+  }
+
+  /* Print the statistics of each shard.  See bcache::print_statistics.
+     This must not be called while other threads insert strings.  */
+
+  void print_statistics (const char *type)
+  {
+    for (int i = 0; i < n_shards; ++i)
+      {
+	std::string name = string_printf ("%s, shard %d", type, i);
+
+	m_shards[i].cache.print_statistics (name.c_str ());
+      }
+  }
+
+  /* See bcache::memory_used.  This must not be called while other
+     threads insert strings.  */
+
+  int memory_used ()
+  {
+    int total = 0;
+
+    for (shard &s : m_shards)
+      total += s.cache.memory_used ();
+    return total;
+  }
+
+  /* The number of shards, as a power of 2.  */
+  static constexpr int shard_bits = 4;
+  static constexpr int n_shards = 1 << shard_bits;
+
+private:
+
+  struct shard
+  {
+#if CXX_STD_THREAD
+    std::mutex mutex;
+#endif
+    T cache;
+  };
+
+  /* Return the shard of the strings whose hash is FULL_HASH.  A bcache
+     selects a bucket with the hash modulo a prime, and compares the
+     upper 16 bits of the hashes first.  Mix the hash so that the shard
+     doesn't depend on either.  */
+
+  static int shard_index (unsigned long full_hash)
+  {
+    return ((uint32_t) full_hash * 0x9e3779b1u) >> (32 - shard_bits);
+  }
+
+  shard m_shards[n_shards];
+};
+
 } /* namespace gdb */
 
 #endif /* BCACHE_H */
@@ -79,6 +79,7 @@
 #include "mi/mi-common.h"
 #include "extension.h"
 #include <algorithm>
+#include <unordered_set>
 #include "progspace-and-thread.h"
 #include "gdbsupport/array-view.h"
 #include "gdbsupport/gdb_optional.h"
@@ -13912,12 +13913,126 @@ breakpoint_re_set_one (breakpoint *b)
   b->ops->re_set (b);
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* Incremental re-setting of breakpoints.
 
-void
-breakpoint_re_set (void)
+   Re-setting a breakpoint decodes its location against all the
+   objfiles of the program space.  When shared libraries are loaded,
+   most breakpoints can't find anything in the new objfiles, and
+   re-setting them gives the same locations as before.  So
+   breakpoint_re_set_objfiles first decodes the location of each
+   breakpoint against the objfiles added since the last re-set only,
+   and re-sets just the breakpoints for which something was found.
+
+   When objfiles are removed, the breakpoints with locations in them
+   are re-set.
+
+   Only the breakpoints whose result depends on nothing but the
+   symbols found for their location are re-set incrementally: user
+   breakpoints with a linespec or explicit location, and without a
+   condition or a range.  The others are always re-set.  */
+
+struct breakpoint_re_set_info
 {
+  /* True if OBJFILES is the set of objfiles of the program space
+     when its breakpoints were last re-set.  */
+  bool valid = false;
+
+  /* The objfiles of the program space when its breakpoints were last
+     re-set, minus those removed since.  */
+  std::unordered_set<objfile *> objfiles;
+
+  /* The numbers of the breakpoints with locations in the objfiles
+     removed since the last re-set.  */
+  std::unordered_set<int> stale_breakpoints;
+};
+
+/* Program space key for finding its breakpoint re-set info.  */
+
+static const program_space_key<breakpoint_re_set_info>
+  breakpoint_re_set_info_key;
+
+/* Whether breakpoint_re_set_objfiles only re-sets the breakpoints
+   affected by the objfiles added or removed.  */
+
+static bool breakpoint_re_set_incremental = true;
+
+/* Statistics for "maint print breakpoint-re-set-statistics".  */
+
+static struct
+{
+  /* The number of re-sets considering all the objfiles.  */
+  unsigned int full_passes;
+
+  /* The number of re-sets considering only the objfiles added or
+     removed.  */
+  unsigned int incremental_passes;
+
+  /* The number of breakpoints re-set, and skipped because the
+     objfiles added or removed could not change their locations.  */
+  unsigned int breakpoints_re_set;
+  unsigned int breakpoints_skipped;
+} breakpoint_re_set_stats;
+
+/* Return the breakpoint re-set info of PSPACE, creating it if
+   needed.  */
+
+static breakpoint_re_set_info *
+get_breakpoint_re_set_info (struct program_space *pspace)
+{
+  breakpoint_re_set_info *info = breakpoint_re_set_info_key.get (pspace);
+  if (info == nullptr)
+    info = breakpoint_re_set_info_key.emplace (pspace);
+  return info;
+}
+
+/* Return true if B must be re-set after NEW_OBJFILES were added to
+   the current program space, and the objfiles listed in INFO were
+   removed.  */
+
+static bool
+breakpoint_re_set_needed_p (struct breakpoint *b,
+			    const std::vector<objfile *> &new_objfiles,
+			    const breakpoint_re_set_info *info)
+{
+  if (b->number <= 0
+      || b->ops->re_set != bkpt_re_set
+      || b->ops->decode_location != bkpt_decode_location
+      || b->location == NULL
+      || (event_location_type (b->location.get ()) != LINESPEC_LOCATION
+	  && event_location_type (b->location.get ()) != EXPLICIT_LOCATION)
+      || b->location_range_end != NULL
+      || b->cond_string != NULL)
+    return true;
+
+  if (info->stale_breakpoints.find (b->number)
+      != info->stale_breakpoints.end ())
+    return true;
+
+  /* Decode the location as breakpoint_re_set_one would.  */
+  input_radix = b->input_radix;
+  set_language (b->language);
+
+  return location_found_in_objfiles (b->location.get (),
+				     DECODE_LINE_FUNFIRSTLINE,
+				     current_program_space, new_objfiles);
+}
+
+/* Re-set breakpoint locations for the current program space.  If
+   NEW_OBJFILES is not NULL, only re-set the breakpoints that may have
+   locations in these objfiles, or had locations in the objfiles
+   removed since the last re-set.  */
+
+static void
+breakpoint_re_set_1 (const std::vector<objfile *> *new_objfiles)
+{
+  breakpoint_re_set_info *info
+    = get_breakpoint_re_set_info (current_program_space);
+
+  if (new_objfiles == nullptr)
+    ++breakpoint_re_set_stats.full_passes;
+  else
+    ++breakpoint_re_set_stats.incremental_passes;
+
   {
     scoped_restore_current_language save_language;
     scoped_restore save_input_radix = make_scoped_restore (&input_radix);
@@ -13945,6 +14060,14 @@ breakpoint_re_set (void)
       {
 	try
 	  {
+	    if (new_objfiles != nullptr
+		&& !breakpoint_re_set_needed_p (b, *new_objfiles, info))
+	      {
+		++breakpoint_re_set_stats.breakpoints_skipped;
+		continue;
+	      }
+
+	    ++breakpoint_re_set_stats.breakpoints_re_set;
 	    breakpoint_re_set_one (b);
 	  }
 	catch (const gdb_exception &ex)
@@ -13958,6 +14081,14 @@ breakpoint_re_set (void)
     jit_breakpoint_re_set ();
   }
 
+  /* The breakpoints are now up to date with the objfiles of the
+     program space.  */
+  info->objfiles.clear ();
+  for (objfile *objfile : current_program_space->objfiles ())
+    info->objfiles.insert (objfile);
+  info->stale_breakpoints.clear ();
+  info->valid = true;
+
   create_overlay_event_breakpoint ();
   create_longjmp_master_breakpoint ();
   create_std_terminate_master_breakpoint ();
@@ -13966,6 +14097,92 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 (nullptr);
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (void)
+{
+  breakpoint_re_set_info *info
+    = get_breakpoint_re_set_info (current_program_space);
+
+  if (!breakpoint_re_set_incremental || !info->valid)
+    {
+      breakpoint_re_set_1 (nullptr);
+      return;
+    }
+
+  std::vector<objfile *> new_objfiles;
+  for (objfile *objfile : current_program_space->objfiles ())
+    if (info->objfiles.find (objfile) == info->objfiles.end ())
+      new_objfiles.push_back (objfile);
+
+  breakpoint_re_set_1 (&new_objfiles);
+}
+
+/* This module's 'new_objfile' observer.  */
+
+static void
+breakpoint_re_set_new_objfile (struct objfile *objfile)
+{
+  /* A NULL OBJFILE means that the symbols of the current program
+     space were discarded.  */
+  if (objfile == NULL)
+    get_breakpoint_re_set_info (current_program_space)->valid = false;
+}
+
+/* This module's 'free_objfile' observer, for incremental re-sets.
+   Remember which breakpoints had locations in OBJFILE.  */
+
+static void
+breakpoint_re_set_free_objfile (struct objfile *objfile)
+{
+  breakpoint_re_set_info *info = get_breakpoint_re_set_info (objfile->pspace);
+
+  info->objfiles.erase (objfile);
+  if (!info->valid)
+    return;
+
+  for (breakpoint *b : all_breakpoints ())
+    for (bp_location *loc : b->locations ())
+      {
+	if (loc->pspace != objfile->pspace)
+	  continue;
+
+	if ((loc->symtab != NULL && SYMTAB_OBJFILE (loc->symtab) == objfile)
+	    || is_addr_in_objfile (loc->address, objfile))
+	  {
+	    info->stale_breakpoints.insert (b->number);
+	    break;
+	  }
+      }
+}
+
+/* Implement the "maint print breakpoint-re-set-statistics" command.  */
+
+static void
+maintenance_print_breakpoint_re_set_statistics (const char *args,
+						int from_tty)
+{
+  printf_filtered (_("Breakpoint re-set statistics:\n"));
+  printf_filtered (_("  full passes: %u\n"),
+		   breakpoint_re_set_stats.full_passes);
+  printf_filtered (_("  incremental passes: %u\n"),
+		   breakpoint_re_set_stats.incremental_passes);
+  printf_filtered (_("  breakpoints re-set: %u\n"),
+		   breakpoint_re_set_stats.breakpoints_re_set);
+  printf_filtered (_("  breakpoints skipped: %u\n"),
+		   breakpoint_re_set_stats.breakpoints_skipped);
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -15500,6 +15717,10 @@ _initialize_breakpoint ()
 					 "breakpoint");
   gdb::observers::free_objfile.attach (disable_breakpoints_in_freed_objfile,
 				       "breakpoint");
+  gdb::observers::new_objfile.attach (breakpoint_re_set_new_objfile,
+				      "breakpoint-re-set");
+  gdb::observers::free_objfile.attach (breakpoint_re_set_free_objfile,
+				       "breakpoint-re-set");
   gdb::observers::memory_changed.attach (invalidate_bp_value_on_memory_change,
 					 "breakpoint");
 
@@ -15751,6 +15972,22 @@ Convenience variable \"$bpnum\" contains the number of the last\n\
 breakpoint set."),
 	   &maintenanceinfolist);
 
+  add_setshow_boolean_cmd ("breakpoint-re-set-incremental", class_maintenance,
+			   &breakpoint_re_set_incremental, _("\
+Set whether breakpoints are re-set incrementally when objfiles change."), _("\
+Show whether breakpoints are re-set incrementally when objfiles change."), _("\
+When on, loading or unloading shared libraries only re-sets the\n\
+breakpoints whose locations may be found in them.  When off, all the\n\
+breakpoints are re-set."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("breakpoint-re-set-statistics", class_maintenance,
+	   maintenance_print_breakpoint_re_set_statistics,
+	   _("Print statistics about the re-setting of breakpoints."),
+	   &maintenanceprintlist);
+
   add_basic_prefix_cmd ("catch", class_breakpoint, _("\
 Set catchpoints to catch events."),
 			&catch_cmdlist,
@@ -1276,6 +1276,12 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, but after objfiles were added to or removed
+   from the current program space: only re-set the breakpoints whose
+   locations may change because of them.  */
+
+extern void breakpoint_re_set_objfiles (void);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
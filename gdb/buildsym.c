@@ -33,6 +33,7 @@
 #include "cp-support.h"
 #include "dictionary.h"
 #include "addrmap.h"
+#include "gdbcmd.h"
 #include <algorithm>
 
 /* For cleanup_undefined_stabs_types and finish_global_stabs (somewhat
@@ -54,6 +55,31 @@ struct pending_block
    completed.  */
 
 #define	INITIAL_LINE_VECTOR_LENGTH	1000
+
+/* The implementations of the dictionaries of the global and static
+   blocks, see "maint set global-block-dictionary".  */
+
+static const char dict_hashing_chained[] = "chained";
+static const char dict_hashing_open_addressing[] = "open-addressing";
+static const char *const dict_hashing_enums[] = {
+  dict_hashing_chained,
+  dict_hashing_open_addressing,
+  nullptr
+};
+
+static const char *global_block_dict_hashing = dict_hashing_chained;
+static const char *static_block_dict_hashing = dict_hashing_chained;
+
+/* Return the dict_hashing value for SETTING, one of
+   DICT_HASHING_ENUMS, or NULL for the default.  */
+
+static dict_hashing
+dict_hashing_from_setting (const char *setting)
+{
+  if (setting == dict_hashing_open_addressing)
+    return dict_hashing::open_addressing;
+  return dict_hashing::chained;
+}
 
 
 buildsym_compunit::buildsym_compunit (struct objfile *objfile_,
@@ -237,8 +263,16 @@ buildsym_compunit::finish_block_internal
 	}
       else
 	{
-	  BLOCK_MULTIDICT (block) =
-	    mdict_create_hashed (&m_objfile->objfile_obstack, *listhead);
+	  const char *hashing = nullptr;
+
+	  if (is_global)
+	    hashing = global_block_dict_hashing;
+	  else if (listhead == &m_file_symbols)
+	    hashing = static_block_dict_hashing;
+
+	  BLOCK_MULTIDICT (block)
+	    = mdict_create_hashed (&m_objfile->objfile_obstack, *listhead,
+				   dict_hashing_from_setting (hashing));
 	}
     }
 
@@ -796,6 +830,71 @@ buildsym_compunit::watch_main_source_file_lossage ()
     }
 }
 
+/* Sort the line vector of SUBFILE if needed and return a copy of it
+   allocated on the objfile obstack, or NULL if SUBFILE has no line
+   numbers.  */
+
+struct linetable *
+buildsym_compunit::copy_line_vector (struct subfile *subfile)
+{
+  if (subfile->line_vector == NULL)
+    return NULL;
+
+  int linetablesize = sizeof (struct linetable) +
+    subfile->line_vector->nitems * sizeof (struct linetable_entry);
+
+  const auto lte_is_less_than
+    = [] (const linetable_entry &ln1,
+	  const linetable_entry &ln2) -> bool
+      {
+	if (ln1.pc == ln2.pc
+	    && ((ln1.line == 0) != (ln2.line == 0)))
+	  return ln1.line == 0;
+
+	return (ln1.pc < ln2.pc);
+      };
+
+  /* Like the pending blocks, the line table may be scrambled in
+     reordered executables.  Sort it if OBJF_REORDERED is true.  It
+     is important to preserve the order of lines at the same
+     address, as this maintains the inline function caller/callee
+     relationships, this is why std::stable_sort is used.  */
+  if (m_objfile->flags & OBJF_REORDERED)
+    std::stable_sort (subfile->line_vector->item,
+		      subfile->line_vector->item
+		      + subfile->line_vector->nitems,
+		      lte_is_less_than);
+
+  /* Reallocate the line table on the symbol obstack.  */
+  struct linetable *result = (struct linetable *)
+    obstack_alloc (&m_objfile->objfile_obstack, linetablesize);
+  memcpy (result, subfile->line_vector, linetablesize);
+  return result;
+}
+
+/* See buildsym.h.  */
+
+void
+buildsym_compunit::install_line_tables ()
+{
+  for (struct subfile *subfile = m_subfiles;
+       subfile != NULL;
+       subfile = subfile->next)
+    {
+      if (subfile->line_vector == NULL)
+	continue;
+
+      if (subfile->symtab == NULL)
+	{
+	  subfile->symtab = allocate_symtab (m_compunit_symtab,
+					     subfile->name);
+	  subfile->symtab->language = subfile->language;
+	}
+
+      subfile->symtab->linetable = copy_line_vector (subfile);
+    }
+}
+
 /* Implementation of the first part of end_symtab.  It allows modifying
    STATIC_BLOCK before it gets finalized by end_symtab_from_static_block.
    If the returned value is NULL there is no blockvector created for
@@ -937,36 +1036,6 @@ buildsym_compunit::end_symtab_with_blockvector (struct block *static_block,
        subfile != NULL;
        subfile = subfile->next)
     {
-      int linetablesize = 0;
-
-      if (subfile->line_vector)
-	{
-	  linetablesize = sizeof (struct linetable) +
-	    subfile->line_vector->nitems * sizeof (struct linetable_entry);
-
-	  const auto lte_is_less_than
-	    = [] (const linetable_entry &ln1,
-		  const linetable_entry &ln2) -> bool
-	      {
-		if (ln1.pc == ln2.pc
-		    && ((ln1.line == 0) != (ln2.line == 0)))
-		  return ln1.line == 0;
-
-		return (ln1.pc < ln2.pc);
-	      };
-
-	  /* Like the pending blocks, the line table may be scrambled in
-	     reordered executables.  Sort it if OBJF_REORDERED is true.  It
-	     is important to preserve the order of lines at the same
-	     address, as this maintains the inline function caller/callee
-	     relationships, this is why std::stable_sort is used.  */
-	  if (m_objfile->flags & OBJF_REORDERED)
-	    std::stable_sort (subfile->line_vector->item,
-			      subfile->line_vector->item
-			      + subfile->line_vector->nitems,
-			      lte_is_less_than);
-	}
-
       /* Allocate a symbol table if necessary.  */
       if (subfile->symtab == NULL)
 	subfile->symtab = allocate_symtab (cu, subfile->name);
@@ -974,18 +1043,7 @@ buildsym_compunit::end_symtab_with_blockvector (struct block *static_block,
 
       /* Fill in its components.  */
 
-      if (subfile->line_vector)
-	{
-	  /* Reallocate the line table on the symbol obstack.  */
-	  SYMTAB_LINETABLE (symtab) = (struct linetable *)
-	    obstack_alloc (&m_objfile->objfile_obstack, linetablesize);
-	  memcpy (SYMTAB_LINETABLE (symtab), subfile->line_vector,
-		  linetablesize);
-	}
-      else
-	{
-	  SYMTAB_LINETABLE (symtab) = NULL;
-	}
+      SYMTAB_LINETABLE (symtab) = copy_line_vector (subfile);
 
       /* Use whatever language we have been using for this
 	 subfile, not the one that was deduced in allocate_symtab
@@ -1252,3 +1310,29 @@ buildsym_compunit::pop_context ()
   m_context_stack.pop_back ();
   return result;
 }
+
+void _initialize_buildsym ();
+void
+_initialize_buildsym ()
+{
+  add_setshow_enum_cmd ("global-block-dictionary", class_maintenance,
+			dict_hashing_enums, &global_block_dict_hashing, _("\
+Set the implementation of the symbol dictionaries of global blocks."), _("\
+Show the implementation of the symbol dictionaries of global blocks."), _("\
+\"chained\" uses hash buckets chained through the symbols, which uses\n\
+the least memory.  \"open-addressing\" uses a flat table, which makes\n\
+lookups in large blocks faster.  This only affects the symbol tables\n\
+read after the setting is changed."),
+			NULL, NULL,
+			&maintenance_set_cmdlist,
+			&maintenance_show_cmdlist);
+
+  add_setshow_enum_cmd ("static-block-dictionary", class_maintenance,
+			dict_hashing_enums, &static_block_dict_hashing, _("\
+Set the implementation of the symbol dictionaries of static blocks."), _("\
+Show the implementation of the symbol dictionaries of static blocks."), _("\
+See \"maint set global-block-dictionary\"."),
+			NULL, NULL,
+			&maintenance_set_cmdlist,
+			&maintenance_show_cmdlist);
+}
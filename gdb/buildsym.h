@@ -190,6 +190,20 @@ struct buildsym_compunit
   void record_line (struct subfile *subfile, int line, CORE_ADDR pc,
 		    bool is_stmt);
 
+  /* Note that the line numbers of this compunit will be recorded
+     later, after it is completed, so that it isn't discarded as empty
+     if it has no symbols.  */
+  void defer_line_numbers ()
+  {
+    m_have_line_numbers = true;
+  }
+
+  /* Install the line tables recorded for the subfiles into their
+     symtabs, allocating the symtabs that don't exist yet.  This is for
+     readers that record the line numbers of a compunit that has
+     already been completed.  */
+  void install_line_tables ();
+
   struct compunit_symtab *get_compunit_symtab ()
   {
     return m_compunit_symtab;
@@ -299,6 +313,8 @@ struct buildsym_compunit
 
   void watch_main_source_file_lossage ();
 
+  struct linetable *copy_line_vector (struct subfile *subfile);
+
   struct compunit_symtab *end_symtab_with_blockvector
       (struct block *static_block, int section, int expandable);
 
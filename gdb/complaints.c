@@ -22,6 +22,7 @@
 #include "command.h"
 #include "gdbcmd.h"
 #include "gdbsupport/selftest.h"
+#include "run-on-main-thread.h"
 #include <unordered_map>
 
 /* Map format strings to counters.  */
@@ -34,18 +35,15 @@ static std::unordered_map<const char *, int> counters;
 
 int stop_whining = 0;
 
-/* See complaints.h.  */
+/* The complaint interceptor of the current thread, if any.  */
 
-void
-complaint_internal (const char *fmt, ...)
-{
-  va_list args;
+static thread_local complaint_interceptor *g_complaint_interceptor;
 
-  if (++counters[fmt] > stop_whining)
-    return;
-
-  va_start (args, fmt);
+/* Print the complaint described by FMT and ARGS.  */
 
+static void
+print_complaint (const char *fmt, va_list args)
+{
   if (deprecated_warning_hook)
     (*deprecated_warning_hook) (fmt, args);
   else
@@ -54,12 +52,92 @@ complaint_internal (const char *fmt, ...)
       vfprintf_filtered (gdb_stderr, fmt, args);
       fputs_filtered ("\n", gdb_stderr);
     }
+}
+
+/* Varargs wrapper around print_complaint.  */
+
+static void ATTRIBUTE_PRINTF (1, 2)
+print_complaint_1 (const char *fmt, ...)
+{
+  va_list args;
+
+  va_start (args, fmt);
+  print_complaint (fmt, args);
+  va_end (args);
+}
+
+/* See complaints.h.  */
+
+void
+complaint_internal (const char *fmt, ...)
+{
+  va_list args;
+
+  if (g_complaint_interceptor != nullptr)
+    {
+      va_start (args, fmt);
+      g_complaint_interceptor->m_complaints.emplace_back
+	(fmt, string_vprintf (fmt, args));
+      va_end (args);
+      return;
+    }
 
+  if (++counters[fmt] > stop_whining)
+    return;
+
+  va_start (args, fmt);
+  print_complaint (fmt, args);
   va_end (args);
 }
 
 /* See complaints.h.  */
 
+complaint_interceptor::complaint_interceptor ()
+  : m_saved (g_complaint_interceptor)
+{
+  g_complaint_interceptor = this;
+}
+
+/* See complaints.h.  */
+
+complaint_interceptor::~complaint_interceptor ()
+{
+  g_complaint_interceptor = m_saved;
+}
+
+/* See complaints.h.  */
+
+void
+complaint_interceptor::take (complaint_interceptor &other)
+{
+  for (auto &item : other.m_complaints)
+    m_complaints.push_back (std::move (item));
+  other.m_complaints.clear ();
+}
+
+/* See complaints.h.  */
+
+void
+reissue_complaints (const complaint_list &complaints)
+{
+  gdb_assert (is_main_thread ());
+
+  for (const auto &item : complaints)
+    if (++counters[item.first] <= stop_whining)
+      print_complaint_1 ("%s", item.second.c_str ());
+}
+
+/* See complaints.h.  */
+
+void
+complaint_interceptor::reissue ()
+{
+  reissue_complaints (m_complaints);
+  m_complaints.clear ();
+}
+
+/* See complaints.h.  */
+
 void
 clear_complaints ()
 {
@@ -114,6 +192,28 @@ test_complaints ()
   clear_complaints ();
   CHECK_COMPLAINT ("maintenance complaint 0", 1);
 
+  /* Complaints issued while an interceptor is installed are only
+     printed (and counted) when reissued.  */
+  {
+    complaint_interceptor collected;
+
+    {
+      complaint_interceptor interceptor;
+      CHECK_COMPLAINT_SILENT ("maintenance complaint 2", 0);
+      CHECK_COMPLAINT_SILENT ("maintenance complaint 2", 0);
+      CHECK_COMPLAINT_SILENT ("maintenance complaint 2", 0);
+      collected.take (interceptor);
+    }
+
+    std::string output;
+    execute_fn_to_string (output, [&] () { collected.reissue (); }, false);
+    std::string expected
+      = (_("During symbol reading: ") + std::string ("maintenance complaint 2\n")
+	 + _("During symbol reading: ") + std::string ("maintenance complaint 2\n"));
+    SELF_CHECK (output == expected);
+    SELF_CHECK (counters["maintenance complaint 2"] == 3);
+  }
+
 #undef CHECK_COMPLAINT
 #undef CHECK_COMPLAINT_SILENT
 }
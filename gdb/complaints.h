@@ -46,5 +46,59 @@ extern int stop_whining;
 
 extern void clear_complaints ();
 
+/* Complaints collected by a complaint_interceptor: the format string
+   of each, used to limit the number of complaints of each kind, and
+   the formatted text.  */
+
+typedef std::vector<std::pair<const char *, std::string>> complaint_list;
+
+/* Issue the complaints of COMPLAINTS for real.  This must be called on
+   the main thread.  */
+
+extern void reissue_complaints (const complaint_list &complaints);
+
+/* Collect the complaints issued by the current thread while an
+   instance of this class is alive, instead of printing them.  This is
+   used by code reading symbols in worker threads, as printing is only
+   allowed on the main thread.  The collected complaints can then be
+   issued for real by calling reissue on the main thread.  */
+
+class complaint_interceptor
+{
+public:
+
+  complaint_interceptor ();
+  ~complaint_interceptor ();
+
+  DISABLE_COPY_AND_ASSIGN (complaint_interceptor);
+
+  /* Move the complaints collected by OTHER to this interceptor.  */
+  void take (complaint_interceptor &other);
+
+  /* Issue the collected complaints, and forget about them.  This must
+     be called on the main thread.  */
+  void reissue ();
+
+  /* Return the collected complaints, and forget about them.  This is
+     for complaints that must be issued later than reissue can be
+     called, see reissue_complaints.  */
+  complaint_list release ()
+  {
+    complaint_list result = std::move (m_complaints);
+    m_complaints.clear ();
+    return result;
+  }
+
+private:
+
+  /* The complaints collected so far.  */
+  complaint_list m_complaints;
+
+  /* The interceptor that was installed before this one.  */
+  complaint_interceptor *m_saved;
+
+  friend void complaint_internal (const char *fmt, ...);
+};
+
 
 #endif /* !defined (COMPLAINTS_H) */
@@ -41,6 +41,11 @@
 #include <atomic>
 #include "event-top.h"
 #include "run-on-main-thread.h"
+#include <unordered_map>
+#if CXX_STD_THREAD
+#include <mutex>
+#include <thread>
+#endif
 
 #define d_left(dc) (dc)->u.s_binary.left
 #define d_right(dc) (dc)->u.s_binary.right
@@ -619,19 +624,149 @@ cp_canonicalize_string_no_typedefs (const char *string)
   return cp_canonicalize_string_full (string, NULL, NULL);
 }
 
-/* Parse STRING and convert it to canonical form.  If parsing fails,
-   or if STRING is already canonical, return nullptr.
-   Otherwise return the canonical form.  */
+/* A cache of the results of cp_canonicalize_string.  The canonical
+   form of a name doesn't depend on any symbol, so one cache serves all
+   the objfiles.  The same names come up in many compilation units, in
+   particular the names of template instances declared in headers.
 
-gdb::unique_xmalloc_ptr<char>
-cp_canonicalize_string (const char *string)
+   Several threads may use the cache at the same time.  The names are
+   spread over a fixed number of shards according to their hash, and
+   each shard has its own lock, so that threads only wait for each
+   other when they look up names of the same shard.  */
+
+class canonical_name_cache
+{
+public:
+
+  canonical_name_cache () = default;
+
+  DISABLE_COPY_AND_ASSIGN (canonical_name_cache);
+
+  /* Look up NAME.  If it is in the cache, set *CANONICAL to its
+     canonical form, or to the empty string if NAME is already
+     canonical or can't be parsed, and return true.  Otherwise return
+     false.  */
+
+  bool lookup (const std::string &name, std::string *canonical)
+  {
+    shard &s = get_shard (name);
+
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (s.mutex);
+#endif
+    auto iter = s.names.find (name);
+    if (iter == s.names.end ())
+      {
+	++m_misses;
+	return false;
+      }
+
+    ++m_hits;
+    *canonical = iter->second;
+    return true;
+  }
+
+  /* Record that the canonical form of NAME is CANONICAL, with the
+     same convention as lookup.  When a shard is full, it is emptied
+     first, which bounds the memory used by the cache.  */
+
+  void insert (const std::string &name, const char *canonical)
+  {
+    shard &s = get_shard (name);
+
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (s.mutex);
+#endif
+    if (s.names.size () >= max_shard_entries)
+      s.names.clear ();
+    s.names.emplace (name, canonical);
+  }
+
+  /* Remove all the names from the cache, and reset the statistics.  */
+
+  void clear ()
+  {
+    for (shard &s : m_shards)
+      {
+#if CXX_STD_THREAD
+	std::lock_guard<std::mutex> guard (s.mutex);
+#endif
+	s.names.clear ();
+      }
+
+    m_hits = 0;
+    m_misses = 0;
+  }
+
+  /* Print the number of names in the cache and the number of lookups
+     that found a name or not.  */
+
+  void print_statistics ()
+  {
+    size_t n_names = 0;
+    for (shard &s : m_shards)
+      {
+#if CXX_STD_THREAD
+	std::lock_guard<std::mutex> guard (s.mutex);
+#endif
+	n_names += s.names.size ();
+      }
+
+    printf_filtered (_("  names: %s\n"), pulongest (n_names));
+    printf_filtered (_("  hits: %s\n"), pulongest (m_hits));
+    printf_filtered (_("  misses: %s\n"), pulongest (m_misses));
+  }
+
+private:
+
+  /* The number of shards, as a power of 2.  */
+  static constexpr int shard_bits = 4;
+  static constexpr int n_shards = 1 << shard_bits;
+
+  /* The maximum number of names of a shard.  */
+  static constexpr size_t max_shard_entries = 1 << 16;
+
+  struct shard
+  {
+#if CXX_STD_THREAD
+    std::mutex mutex;
+#endif
+    std::unordered_map<std::string, std::string> names;
+  };
+
+  /* Return the shard of NAME.  The maps of the shards select their
+     buckets with the same hash, so mix it so that the shard doesn't
+     depend on the low bits.  */
+
+  shard &get_shard (const std::string &name)
+  {
+    size_t hash = std::hash<std::string> () (name);
+    return m_shards[((uint32_t) hash * 0x9e3779b1u) >> (32 - shard_bits)];
+  }
+
+  shard m_shards[n_shards];
+
+  std::atomic<ULONGEST> m_hits {0};
+  std::atomic<ULONGEST> m_misses {0};
+};
+
+/* The cache of canonical names, see canonical_name_cache.  */
+
+static canonical_name_cache canonical_names;
+
+/* Whether cp_canonicalize_string uses CANONICAL_NAMES.  */
+
+static bool canonical_name_cache_enabled = true;
+
+/* Parse STRING and convert it to canonical form, without using the
+   cache.  */
+
+static gdb::unique_xmalloc_ptr<char>
+cp_canonicalize_string_uncached (const char *string)
 {
   std::unique_ptr<demangle_parse_info> info;
   unsigned int estimated_len;
 
-  if (cp_already_canonical (string))
-    return nullptr;
-
   info = cp_demangled_name_to_comp (string, NULL);
   if (info == NULL)
     return nullptr;
@@ -642,8 +777,21 @@ cp_canonicalize_string (const char *string)
 
   if (!us)
     {
-      warning (_("internal error: string \"%s\" failed to be canonicalized"),
-	       string);
+      /* We might be in a worker thread, see
+	 dw2_preload_full_comp_units.  If so, arrange for the warning
+	 to be printed by the main thread.  */
+      if (is_main_thread ())
+	warning (_("internal error: string \"%s\" failed to be "
+		   "canonicalized"), string);
+      else
+	{
+	  std::string copy = string;
+	  run_on_main_thread ([=] ()
+	    {
+	      warning (_("internal error: string \"%s\" failed to be "
+			 "canonicalized"), copy.c_str ());
+	    });
+	}
       return nullptr;
     }
 
@@ -653,6 +801,34 @@ cp_canonicalize_string (const char *string)
   return us;
 }
 
+/* Parse STRING and convert it to canonical form.  If parsing fails,
+   or if STRING is already canonical, return nullptr.
+   Otherwise return the canonical form.  This can be called from any
+   thread.  */
+
+gdb::unique_xmalloc_ptr<char>
+cp_canonicalize_string (const char *string)
+{
+  if (cp_already_canonical (string))
+    return nullptr;
+
+  if (!canonical_name_cache_enabled)
+    return cp_canonicalize_string_uncached (string);
+
+  std::string name = string;
+  std::string canonical;
+  if (canonical_names.lookup (name, &canonical))
+    {
+      if (canonical.empty ())
+	return nullptr;
+      return make_unique_xstrdup (canonical.c_str ());
+    }
+
+  gdb::unique_xmalloc_ptr<char> us = cp_canonicalize_string_uncached (string);
+  canonical_names.insert (name, us == nullptr ? "" : us.get ());
+  return us;
+}
+
 /* Convert a mangled name to a demangle_component tree.  *MEMORY is
    set to the block of used memory that should be freed when finished
    with the tree.  DEMANGLED_P is set to the char * that should be
@@ -2162,6 +2338,89 @@ test_cp_remove_params ()
 #undef CHECK_INCOMPL
 }
 
+/* Names and their canonical forms, nullptr when the name is already
+   canonical or can't be parsed.  */
+
+static const struct
+{
+  const char *name;
+  const char *canonical;
+} canonicalize_tests[] =
+{
+  { "foo", nullptr },
+  { "foo(int)", nullptr },
+  { "foo (int)", "foo(int)" },
+  { "foo(const char*)", "foo(char const*)" },
+  { "foo(char const*)", nullptr },
+  { "foo(unsigned)", "foo(unsigned int)" },
+  { "A<int>::f (short int)", "A<int>::f(short)" },
+  { "std::vector<int,std::allocator<int> >",
+    "std::vector<int, std::allocator<int> >" },
+  { "std::vector<int, std::allocator<int> >", nullptr },
+  { "foo(", nullptr },
+};
+
+/* Check that cp_canonicalize_string gives the canonical form of every
+   name of CANONICALIZE_TESTS.  Return the number of mismatches.  */
+
+static int
+check_canonicalize_tests ()
+{
+  int failures = 0;
+
+  for (const auto &test : canonicalize_tests)
+    {
+      gdb::unique_xmalloc_ptr<char> result
+	= cp_canonicalize_string (test.name);
+
+      if ((result == nullptr) != (test.canonical == nullptr)
+	  || (result != nullptr
+	      && strcmp (result.get (), test.canonical) != 0))
+	++failures;
+    }
+
+  return failures;
+}
+
+/* Test cp_canonicalize_string with and without the cache, and from
+   several threads at once.  */
+
+static void
+test_cp_canonicalize_string ()
+{
+  scoped_restore restore_enabled
+    = make_scoped_restore (&canonical_name_cache_enabled, false);
+
+  SELF_CHECK (check_canonicalize_tests () == 0);
+
+  canonical_name_cache_enabled = true;
+  canonical_names.clear ();
+
+  /* Once when the names are not in the cache, and once when they
+     are.  */
+  SELF_CHECK (check_canonicalize_tests () == 0);
+  SELF_CHECK (check_canonicalize_tests () == 0);
+
+#if CXX_STD_THREAD
+  canonical_names.clear ();
+
+  std::atomic<int> failures (0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back ([&] ()
+      {
+	for (int j = 0; j < 100; ++j)
+	  failures += check_canonicalize_tests ();
+      });
+  for (std::thread &thread : threads)
+    thread.join ();
+
+  SELF_CHECK (failures == 0);
+#endif
+
+  canonical_names.clear ();
+}
+
 } // namespace selftests
 
 #endif /* GDB_SELF_CHECK */
@@ -2188,6 +2447,25 @@ first_component_command (const char *arg, int from_tty)
   printf_unfiltered ("%s\n", prefix);
 }
 
+/* Implement "maint print canonical-name-cache-statistics".  */
+
+static void
+maintenance_print_canonical_name_cache_statistics (const char *args,
+						   int from_tty)
+{
+  printf_filtered (_("Canonical name cache statistics:\n"));
+  canonical_names.print_statistics ();
+}
+
+/* Implement "maint flush canonical-name-cache".  */
+
+static void
+maintenance_flush_canonical_name_cache (const char *args, int from_tty)
+{
+  canonical_names.clear ();
+  printf_filtered (_("Canonical name cache flushed.\n"));
+}
+
 /* Implement "info vtbl".  */
 
 static void
@@ -2238,10 +2516,33 @@ display the offending symbol."),
   gdb_demangle_attempt_core_dump = can_dump_core (LIMIT_CUR);
 #endif
 
+  add_setshow_boolean_cmd ("canonical-name-cache", class_maintenance,
+			   &canonical_name_cache_enabled, _("\
+Set whether the canonical forms of C++ names are cached."), _("\
+Show whether the canonical forms of C++ names are cached."), _("\
+When on, GDB remembers the canonical form of each C++ name it parses,\n\
+so that the names that are found in many compilation units are only\n\
+parsed once.  When off, every name is parsed."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("canonical-name-cache-statistics", class_maintenance,
+	   maintenance_print_canonical_name_cache_statistics,
+	   _("Print statistics about the cache of canonical C++ names."),
+	   &maintenanceprintlist);
+
+  add_cmd ("canonical-name-cache", class_maintenance,
+	   maintenance_flush_canonical_name_cache,
+	   _("Flush the cache of canonical C++ names."),
+	   &maintenanceflushlist);
+
 #if GDB_SELF_TEST
   selftests::register_test ("cp_symbol_name_matches",
 			    selftests::test_cp_symbol_name_matches);
   selftests::register_test ("cp_remove_params",
 			    selftests::test_cp_remove_params);
+  selftests::register_test ("cp_canonicalize_string",
+			    selftests::test_cp_canonicalize_string);
 #endif
 }
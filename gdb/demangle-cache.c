@@ -0,0 +1,625 @@
+/* Caching of demangled names across GDB sessions.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "demangle-cache.h"
+
+#include "build-id.h"
+#include "cli/cli-cmds.h"
+#include "cli/cli-decode.h"
+#include "command.h"
+#include "demangle.h"
+#include "hashtab.h"
+#include "objfiles.h"
+#include "observable.h"
+#include "progspace.h"
+#include "gdbsupport/cleanups.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/version.h"
+#include <algorithm>
+
+/* When set to true, show debug messages about the demangle cache.  */
+static bool debug_demangle_cache = false;
+
+/* The demangle cache directory, used for "set/show demangle-cache
+   directory".  */
+static std::string demangle_cache_directory;
+
+/* See demangle-cache.h.  */
+demangle_cache global_demangle_cache;
+
+/* set/show demangle-cache commands.  */
+static cmd_list_element *set_demangle_cache_prefix_list;
+static cmd_list_element *show_demangle_cache_prefix_list;
+
+/* The suffix of the cache files.  */
+#define DEMANGLE_CACHE_SUFFIX ".gdb-demangle"
+
+/* A cache file starts with this header.  It is followed by the
+   entries, each made of the kind, the language and whether the name
+   demangles as three bytes, then of the mangled name and of the
+   demangled name if any, as null-terminated strings.
+
+   The header includes the version of GDB, whose demangler may give
+   different names, the number of languages, as languages are recorded
+   by their value, and the demangling style STYLE, which changes the
+   demangled names.  */
+
+static std::string
+demangle_cache_header (int style)
+{
+  return string_printf ("GDB demangle cache 2 %s %d %d\n",
+			version, (int) nr_languages, style);
+}
+
+/* Return the hash of MANGLED for KIND.  */
+
+static unsigned int
+demangle_cache_hash (unsigned int kind, const char *mangled)
+{
+  return fast_hash (mangled, strlen (mangled), kind);
+}
+
+bfd_demangle_cache::bfd_demangle_cache ()
+  : m_style (current_demangling_style)
+{
+}
+
+/* See demangle-cache.h.  */
+
+bool
+bfd_demangle_cache::parse (std::string &&contents)
+{
+  std::string header = demangle_cache_header (m_style);
+
+  if (contents.compare (0, header.size (), header) != 0)
+    return false;
+
+  m_contents = std::move (contents);
+
+  const char *p = m_contents.data () + header.size ();
+  const char *end = m_contents.data () + m_contents.size ();
+  while (p < end)
+    {
+      entry e;
+
+      if (end - p < 3)
+	break;
+      e.kind = p[0];
+      e.language = p[1];
+      bool has_demangled = p[2] != 0;
+      p += 3;
+
+      const char *nul = (const char *) memchr (p, '\0', end - p);
+      if (nul == nullptr)
+	break;
+      e.mangled = p;
+      p = nul + 1;
+
+      e.demangled = nullptr;
+      if (has_demangled)
+	{
+	  nul = (const char *) memchr (p, '\0', end - p);
+	  if (nul == nullptr)
+	    break;
+	  e.demangled = p;
+	  p = nul + 1;
+	}
+
+      if (e.language >= nr_languages)
+	break;
+
+      e.hash = demangle_cache_hash (e.kind, e.mangled);
+      m_entries.push_back (e);
+    }
+
+  if (p != end)
+    {
+      /* The file is truncated or corrupt.  */
+      m_contents.clear ();
+      m_entries.clear ();
+      return false;
+    }
+
+  /* Keep the first of the entries with the same key.  */
+  std::stable_sort (m_entries.begin (), m_entries.end (),
+		    [] (const entry &a, const entry &b)
+		    {
+		      return a.hash < b.hash;
+		    });
+  return true;
+}
+
+/* See demangle-cache.h.  */
+
+bool
+bfd_demangle_cache::lookup (unsigned int kind, const char *mangled,
+			    enum language *language,
+			    gdb::unique_xmalloc_ptr<char> *demangled) const
+{
+  if (current_demangling_style != m_style)
+    return false;
+
+  unsigned int hash = demangle_cache_hash (kind, mangled);
+  auto it = std::lower_bound (m_entries.begin (), m_entries.end (), hash,
+			      [] (const entry &e, unsigned int h)
+			      {
+				return e.hash < h;
+			      });
+
+  for (; it != m_entries.end () && it->hash == hash; ++it)
+    if (it->kind == kind && strcmp (it->mangled, mangled) == 0)
+      {
+	*language = (enum language) it->language;
+	if (it->demangled != nullptr)
+	  demangled->reset (xstrdup (it->demangled));
+	else
+	  demangled->reset (nullptr);
+	return true;
+      }
+
+  /* The name may also have been demangled earlier in this session,
+     typically for another compilation unit.  */
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  const char *entry = find_recorded (hash, kind, mangled);
+  if (entry == nullptr)
+    return false;
+
+  *language = (enum language) entry[1];
+  if (entry[2] != 0)
+    demangled->reset (xstrdup (entry + 3 + strlen (mangled) + 1));
+  else
+    demangled->reset (nullptr);
+  return true;
+}
+
+/* See demangle-cache.h.  */
+
+const char *
+bfd_demangle_cache::find_recorded (unsigned int hash, unsigned int kind,
+				   const char *mangled) const
+{
+  auto range = m_recorded_index.equal_range (hash);
+
+  for (auto it = range.first; it != range.second; ++it)
+    {
+      const char *entry = m_recorded.data () + it->second;
+
+      if ((unsigned char) entry[0] == kind && strcmp (entry + 3, mangled) == 0)
+	return entry;
+    }
+
+  return nullptr;
+}
+
+/* See demangle-cache.h.  */
+
+void
+bfd_demangle_cache::record (unsigned int kind, const char *mangled,
+			    enum language language, const char *demangled)
+{
+  if (current_demangling_style != m_style)
+    return;
+
+  unsigned int hash = demangle_cache_hash (kind, mangled);
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  /* Another thread may have recorded the name since this one looked it
+     up.  */
+  if (find_recorded (hash, kind, mangled) != nullptr)
+    return;
+
+  m_recorded_index.emplace (hash, m_recorded.size ());
+  m_recorded.push_back (kind);
+  m_recorded.push_back (language);
+  m_recorded.push_back (demangled != nullptr);
+  m_recorded.append (mangled, strlen (mangled) + 1);
+  if (demangled != nullptr)
+    m_recorded.append (demangled, strlen (demangled) + 1);
+  m_dirty = true;
+}
+
+/* See demangle-cache.h.  */
+
+bool
+bfd_demangle_cache::dirty ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  return m_dirty;
+}
+
+/* See demangle-cache.h.  */
+
+std::string
+bfd_demangle_cache::contents ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  m_dirty = false;
+  if (m_contents.empty ())
+    return demangle_cache_header (m_style) + m_recorded;
+  return m_contents + m_recorded;
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache::set_directory (std::string dir)
+{
+  gdb_assert (!dir.empty ());
+
+  m_dir = std::move (dir);
+
+  if (debug_demangle_cache)
+    printf_unfiltered ("demangle cache: now using directory %s\n",
+		       m_dir.c_str ());
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache::enable ()
+{
+  if (debug_demangle_cache)
+    printf_unfiltered ("demangle cache: enabling (%s)\n", m_dir.c_str ());
+
+  m_enabled = true;
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache::disable ()
+{
+  if (debug_demangle_cache)
+    printf_unfiltered ("demangle cache: disabling\n");
+
+  m_enabled = false;
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache::load (objfile_per_bfd_storage *per_bfd)
+{
+  if (!enabled () || per_bfd->demangle_cache != nullptr)
+    return;
+
+  bfd *abfd = per_bfd->get_bfd ();
+  if (abfd == nullptr)
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_get (abfd);
+  if (build_id == nullptr)
+    {
+      if (debug_demangle_cache)
+	printf_unfiltered ("demangle cache: %s has no build id\n",
+			   bfd_get_filename (abfd));
+      return;
+    }
+
+  if (m_dir.empty ())
+    {
+      warning (_("The demangle cache directory name is empty, skipping "
+		 "cache lookup."));
+      return;
+    }
+
+  std::unique_ptr<bfd_demangle_cache> cache (new bfd_demangle_cache);
+  /* A separate debug file has the same build id as its executable,
+     but not the same symbols, so the file name is part of the cache
+     file name too.  Except for BFDs read from memory, such as the
+     vDSO: their name ("system-supplied DSO at 0x...") holds an address
+     that changes from one run to the next.  */
+  if ((abfd->flags & BFD_IN_MEMORY) != 0)
+    cache->name = build_id_to_string (build_id);
+  else
+    {
+      hashval_t filename_hash = htab_hash_string (bfd_get_filename (abfd));
+      cache->name = string_printf ("%s-%08x",
+				   build_id_to_string (build_id).c_str (),
+				   (unsigned int) filename_hash);
+    }
+
+  std::string filename = make_cache_filename (cache->name);
+  if (debug_demangle_cache)
+    printf_unfiltered ("demangle cache: trying to read %s\n",
+		       filename.c_str ());
+
+  gdb_file_up file = gdb_fopen_cloexec (filename, FOPEN_RB);
+  if (file != nullptr)
+    {
+      std::string contents;
+      char buf[8192];
+      size_t n;
+
+      while ((n = fread (buf, 1, sizeof (buf), file.get ())) > 0)
+	contents.append (buf, n);
+
+      if (ferror (file.get ()) || !cache->parse (std::move (contents)))
+	{
+	  if (debug_demangle_cache)
+	    printf_unfiltered ("demangle cache: ignoring invalid file %s\n",
+			       filename.c_str ());
+	}
+    }
+  else if (debug_demangle_cache)
+    printf_unfiltered ("demangle cache: couldn't read %s: %s\n",
+		       filename.c_str (), safe_strerror (errno));
+
+  per_bfd->demangle_cache = std::move (cache);
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache::store (objfile_per_bfd_storage *per_bfd)
+{
+  bfd_demangle_cache *cache = per_bfd->demangle_cache.get ();
+
+  if (!enabled () || cache == nullptr || !cache->dirty ())
+    return;
+
+  std::string filename = make_cache_filename (cache->name);
+
+  try
+    {
+      /* Try to create the containing directory.  */
+      if (!mkdir_recursive (m_dir.c_str ()))
+	{
+	  warning (_("demangle cache: could not make cache directory: %s"),
+		   safe_strerror (errno));
+	  return;
+	}
+
+      if (debug_demangle_cache)
+	printf_unfiltered ("demangle cache: writing %s\n", filename.c_str ());
+
+      /* Write to a temporary file first, so that other GDB sessions
+	 never read a partial file.  */
+      gdb::char_vector filename_temp = make_temp_filename (filename);
+      scoped_fd out_file_fd = gdb_mkostemp_cloexec (filename_temp.data (),
+						    O_BINARY);
+      if (out_file_fd.get () == -1)
+	perror_with_name (("mkstemp"));
+
+      gdb::unlinker unlink_file (filename_temp.data ());
+      {
+	gdb_file_up out_file = out_file_fd.to_file ("wb");
+	if (out_file == nullptr)
+	  error (_("Can't open `%s' for writing"), filename_temp.data ());
+
+	std::string contents = cache->contents ();
+	if (fwrite (contents.data (), 1, contents.size (), out_file.get ())
+	    != contents.size ()
+	    || fflush (out_file.get ()) != 0)
+	  error (_("couldn't write %s: %s"), filename_temp.data (),
+		 safe_strerror (errno));
+      }
+
+      unlink_file.keep ();
+      if (rename (filename_temp.data (), filename.c_str ()) != 0)
+	perror_with_name (("rename"));
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (debug_demangle_cache)
+	printf_unfiltered ("demangle cache: couldn't store %s: %s\n",
+			   filename.c_str (), except.what ());
+    }
+}
+
+/* See demangle-cache.h.  */
+
+std::string
+demangle_cache::make_cache_filename (const std::string &name) const
+{
+  return m_dir + SLASH_STRING + name + DEMANGLE_CACHE_SUFFIX;
+}
+
+/* This module's 'free_objfile' observer.  Names may have been
+   demangled since the symbols of OBJFILE were read.  */
+
+static void
+demangle_cache_free_objfile (struct objfile *objfile)
+{
+  global_demangle_cache.store (objfile->per_bfd);
+}
+
+/* Likewise for the objfiles still loaded when GDB exits.  */
+
+static void
+demangle_cache_final_cleanup (void *arg)
+{
+  for (struct program_space *pspace : program_spaces)
+    for (objfile *objfile : pspace->objfiles ())
+      global_demangle_cache.store (objfile->per_bfd);
+}
+
+/* True when we are executing "show demangle-cache".  This is used to
+   improve the printout a little bit.  */
+static bool in_show_demangle_cache_command = false;
+
+/* "show demangle-cache" handler.  */
+
+static void
+show_demangle_cache_command (const char *arg, int from_tty)
+{
+  /* Note that we are executing "show demangle-cache".  */
+  auto restore_flag
+    = make_scoped_restore (&in_show_demangle_cache_command, true);
+
+  /* Call all "show demangle-cache" subcommands.  */
+  cmd_show_list (show_demangle_cache_prefix_list, from_tty);
+
+  printf_unfiltered ("\n");
+  printf_unfiltered
+    (_("The demangle cache is currently %s.\n"),
+     global_demangle_cache.enabled () ? _("enabled") : _("disabled"));
+}
+
+/* "set/show demangle-cache enabled" set callback.  */
+
+static void
+set_demangle_cache_enabled_command (bool value)
+{
+  if (value)
+    global_demangle_cache.enable ();
+  else
+    global_demangle_cache.disable ();
+}
+
+/* "set/show demangle-cache enabled" get callback.  */
+
+static bool
+get_demangle_cache_enabled_command ()
+{
+  return global_demangle_cache.enabled ();
+}
+
+/* "set/show demangle-cache enabled" show callback.  */
+
+static void
+show_demangle_cache_enabled_command (ui_file *stream, int from_tty,
+				     cmd_list_element *cmd, const char *value)
+{
+  fprintf_filtered (stream, _("The demangle cache is %s.\n"), value);
+}
+
+/* "set demangle-cache directory" handler.  */
+
+static void
+set_demangle_cache_directory_command (const char *arg, int from_tty,
+				      cmd_list_element *element)
+{
+  /* Make sure the demangle cache directory is absolute and
+     tilde-expanded.  */
+  gdb::unique_xmalloc_ptr<char> abs
+    = gdb_abspath (demangle_cache_directory.c_str ());
+  demangle_cache_directory = abs.get ();
+  global_demangle_cache.set_directory (demangle_cache_directory);
+}
+
+/* "show demangle-cache stats" handler.  */
+
+static void
+show_demangle_cache_stats_command (const char *arg, int from_tty)
+{
+  const char *indent = "";
+
+  /* If this command is invoked through "show demangle-cache", make the
+     display a bit nicer.  */
+  if (in_show_demangle_cache_command)
+    {
+      indent = "  ";
+      printf_unfiltered ("\n");
+    }
+
+  unsigned int hits = global_demangle_cache.n_hits ();
+  unsigned int misses = global_demangle_cache.n_misses ();
+
+  printf_unfiltered (_("%s  Cache hits (this session): %u\n"),
+		     indent, hits);
+  printf_unfiltered (_("%sCache misses (this session): %u\n"),
+		     indent, misses);
+  if (hits + misses > 0)
+    printf_unfiltered (_("%s    Hit rate (this session): %d%%\n"),
+		       indent, (int) (hits * 100.0 / (hits + misses)));
+}
+
+void _initialize_demangle_cache ();
+void
+_initialize_demangle_cache ()
+{
+  /* Set the default demangle cache directory.  */
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    {
+      demangle_cache_directory = cache_dir;
+      global_demangle_cache.set_directory (std::move (cache_dir));
+    }
+
+  gdb::observers::free_objfile.attach (demangle_cache_free_objfile,
+				      "demangle-cache");
+  make_final_cleanup (demangle_cache_final_cleanup, nullptr);
+
+  /* set demangle-cache */
+  add_basic_prefix_cmd ("demangle-cache", class_files,
+			_("Set demangle-cache options."),
+			&set_demangle_cache_prefix_list,
+			false, &setlist);
+
+  /* show demangle-cache */
+  add_prefix_cmd ("demangle-cache", class_files, show_demangle_cache_command,
+		  _("Show demangle-cache options."),
+		  &show_demangle_cache_prefix_list,
+		  false, &showlist);
+
+  /* set/show demangle-cache enabled */
+  add_setshow_boolean_cmd ("enabled", class_files,
+			   _("Enable the demangle cache."),
+			   _("Show whether the demangle cache is enabled."),
+			   _("\
+When on, the demangled names of the symbols of the files with a build id\n\
+are saved in the demangle cache directory, and read from there the next\n\
+time the same files are loaded."),
+			   set_demangle_cache_enabled_command,
+			   get_demangle_cache_enabled_command,
+			   show_demangle_cache_enabled_command,
+			   &set_demangle_cache_prefix_list,
+			   &show_demangle_cache_prefix_list);
+
+  /* set demangle-cache directory */
+  add_setshow_filename_cmd ("directory", class_files,
+			    &demangle_cache_directory,
+			    _("Set the directory of the demangle cache."),
+			    _("Show the directory of the demangle cache."),
+			    NULL,
+			    set_demangle_cache_directory_command, NULL,
+			    &set_demangle_cache_prefix_list,
+			    &show_demangle_cache_prefix_list);
+
+  /* show demangle-cache stats */
+  add_cmd ("stats", class_files, show_demangle_cache_stats_command,
+	   _("Show some stats about the demangle cache."),
+	   &show_demangle_cache_prefix_list);
+
+  /* set debug demangle-cache */
+  add_setshow_boolean_cmd ("demangle-cache", class_maintenance,
+			   &debug_demangle_cache,
+			   _("Set display of demangle-cache debug messages."),
+			   _("Show display of demangle-cache debug messages."),
+			   _("\
+When non-zero, debugging output for the demangle cache is displayed."),
+			    NULL, NULL,
+			    &setdebuglist, &showdebuglist);
+}
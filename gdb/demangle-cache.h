@@ -0,0 +1,192 @@
+/* Caching of demangled names across GDB sessions.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DEMANGLE_CACHE_H
+#define DEMANGLE_CACHE_H
+
+#include <atomic>
+#include <unordered_map>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
+struct objfile_per_bfd_storage;
+
+/* The demangled names of the symbols of one BFD, as found in the
+   demangle cache, and the names demangled since they were read.
+
+   Each entry maps a mangled name and a kind to a language and a
+   demangled name, or to the fact that the name doesn't demangle.  The
+   kind is the language passed to symbol_find_demangled_name, or
+   PHYSNAME_KIND for the names demangled by the DWARF reader.
+
+   The entries read from the cache are not modified afterwards, so
+   they can be looked up from any thread.  The entries recorded since
+   are protected by a mutex.  */
+
+class bfd_demangle_cache
+{
+public:
+  /* The kind of the entries for the names demangled by
+     dwarf2_physname.  */
+  static constexpr unsigned int physname_kind = 255;
+
+  bfd_demangle_cache ();
+
+  /* Parse the contents of a cache file, CONTENTS.  Return false if it
+     is not a valid cache file.  */
+  bool parse (std::string &&contents);
+
+  /* Look up MANGLED, demangled for KIND, in the entries read from the
+     cache and in those recorded since.  If found, set *LANGUAGE and
+     *DEMANGLED, which is NULL if the name doesn't demangle, and return
+     true.  This can be called from any thread.  */
+  bool lookup (unsigned int kind, const char *mangled,
+	       enum language *language,
+	       gdb::unique_xmalloc_ptr<char> *demangled) const;
+
+  /* Record that MANGLED, demangled for KIND, gives LANGUAGE and
+     DEMANGLED, unless it was already recorded.  This can be called
+     from any thread.  */
+  void record (unsigned int kind, const char *mangled,
+	       enum language language, const char *demangled);
+
+  /* Return true if names were recorded since the last call to
+     contents.  */
+  bool dirty ();
+
+  /* Return the contents of the cache file holding all the entries.  */
+  std::string contents ();
+
+  /* The name of the cache file of the BFD, without the directory and
+     the suffix.  */
+  std::string name;
+
+private:
+
+  /* Return the start of the entry of M_RECORDED for MANGLED and KIND,
+     whose hash is HASH, or NULL if there is none.  M_MUTEX must be
+     held.  */
+  const char *find_recorded (unsigned int hash, unsigned int kind,
+			     const char *mangled) const;
+
+  struct entry
+  {
+    /* The hash of the mangled name and the kind.  */
+    unsigned int hash;
+    unsigned char kind;
+    unsigned char language;
+    const char *mangled;
+
+    /* NULL if the name doesn't demangle.  */
+    const char *demangled;
+  };
+
+  /* The demangling style when the cache was created.  The entries
+     are not used if it changes.  */
+  int m_style;
+
+  /* The contents of the file, to which the entries point.  */
+  std::string m_contents;
+
+  /* The entries of the file, sorted by hash.  */
+  std::vector<entry> m_entries;
+
+  /* The entries recorded in this session, in the format of the
+     file.  */
+  std::string m_recorded;
+
+  /* Map the hash of each entry of M_RECORDED to its offset in it.  */
+  std::unordered_multimap<unsigned int, size_t> m_recorded_index;
+
+  /* Whether entries were recorded since the last call to contents.  */
+  bool m_dirty = false;
+
+#if CXX_STD_THREAD
+  /* Protects M_RECORDED, M_RECORDED_INDEX and M_DIRTY.  */
+  mutable std::mutex m_mutex;
+#endif
+};
+
+/* Class to manage the access to the demangle cache.  */
+
+class demangle_cache
+{
+public:
+  /* Change the directory used to save/load cache files.  */
+  void set_directory (std::string dir);
+
+  /* Return true if the usage of the cache is enabled.  */
+  bool enabled () const
+  {
+    return m_enabled;
+  }
+
+  /* Enable the cache.  */
+  void enable ();
+
+  /* Disable the cache.  */
+  void disable ();
+
+  /* Read the cache file of the BFD of PER_BFD, if the cache is
+     enabled and this wasn't done yet.  Afterwards, the names are looked
+     up in PER_BFD->demangle_cache.  */
+  void load (objfile_per_bfd_storage *per_bfd);
+
+  /* Write the cache file of the BFD of PER_BFD if names were demangled
+     since it was read.  */
+  void store (objfile_per_bfd_storage *per_bfd);
+
+  /* Return the number of cache hits.  */
+  unsigned int n_hits () const
+  { return m_n_hits; }
+
+  /* Record a cache hit.  This can be called from any thread.  */
+  void hit ()
+  { m_n_hits++; }
+
+  /* Return the number of cache misses.  */
+  unsigned int n_misses () const
+  { return m_n_misses; }
+
+  /* Record a cache miss.  This can be called from any thread.  */
+  void miss ()
+  { m_n_misses++; }
+
+private:
+
+  /* Compute the absolute filename of the cache file called NAME.  */
+  std::string make_cache_filename (const std::string &name) const;
+
+  /* The base directory where we are storing and looking up cache
+     files.  */
+  std::string m_dir;
+
+  /* Whether the cache is enabled.  */
+  bool m_enabled = false;
+
+  /* Number of cache hits and misses during this GDB session.  */
+  std::atomic<unsigned int> m_n_hits {0};
+  std::atomic<unsigned int> m_n_misses {0};
+};
+
+/* The global instance of the demangle cache.  */
+extern demangle_cache global_demangle_cache;
+
+#endif /* DEMANGLE_CACHE_H */
@@ -95,6 +95,8 @@ enum dict_type
     DICT_HASHED,
     /* Symbols are stored in an expandable hash table.  */
     DICT_HASHED_EXPANDABLE,
+    /* Symbols are stored in a fixed-size open addressing hash table.  */
+    DICT_OPEN_HASHED,
     /* Symbols are stored in a fixed-size array.  */
     DICT_LINEAR,
     /* Symbols are stored in an expandable array.  */
@@ -147,6 +149,24 @@ struct dictionary_hashed_expandable
   int nsyms;
 };
 
+/* An open addressing hash table.  Instead of following the chain of
+   a bucket through the symbols, a lookup scans a flat array of one
+   byte tags, DICT_OPEN_HASHED_GROUP_SIZE at a time, and only looks at
+   the symbols whose tag matches.  */
+
+struct dictionary_open_hashed
+{
+  /* The number of slots, a power of two.  */
+  int nslots;
+  struct symbol **slots;
+  /* The tag of each slot: zero if the slot is empty, otherwise a few
+     bits of the hash of the symbol in the slot, with the high bit
+     set.  */
+  gdb_byte *tags;
+  /* How many symbols we have.  */
+  int nsyms;
+};
+
 struct dictionary_linear
 {
   int nsyms;
@@ -172,6 +192,7 @@ struct dictionary
   {
     struct dictionary_hashed hashed;
     struct dictionary_hashed_expandable hashed_expandable;
+    struct dictionary_open_hashed open_hashed;
     struct dictionary_linear linear;
     struct dictionary_linear_expandable linear_expandable;
   }
@@ -191,6 +212,12 @@ struct dictionary
 
 #define DICT_HASHED_EXPANDABLE_NSYMS(d)	(d)->data.hashed_expandable.nsyms
 
+#define DICT_OPEN_HASHED_NSLOTS(d)	(d)->data.open_hashed.nslots
+#define DICT_OPEN_HASHED_SLOTS(d)	(d)->data.open_hashed.slots
+#define DICT_OPEN_HASHED_SLOT(d,i)	DICT_OPEN_HASHED_SLOTS (d) [i]
+#define DICT_OPEN_HASHED_TAGS(d)	(d)->data.open_hashed.tags
+#define DICT_OPEN_HASHED_NSYMS(d)	(d)->data.open_hashed.nsyms
+
 /* These can be used for DICT_LINEAR_EXPANDABLEs, too.  */
 
 #define DICT_LINEAR_NSYMS(d)		(d)->data.linear.nsyms
@@ -209,6 +236,12 @@ struct dictionary
 
 #define DICT_HASHTABLE_SIZE(n)	((n)/5 + 1)
 
+/* The number of consecutive tags of a DICT_OPEN_HASHED dictionary
+   that are scanned at once.  The slots are probed by groups of that
+   size.  */
+
+#define DICT_OPEN_HASHED_GROUP_SIZE 8
+
 /* Accessor macros for dict_iterators; they're here rather than
    dictionary.h because code elsewhere should treat dict_iterators as
    opaque.  */
@@ -259,6 +292,23 @@ static void add_symbol_hashed_expandable (struct dictionary *dict,
 
 static int size_hashed_expandable (const struct dictionary *dict);
 
+/* Functions for DICT_OPEN_HASHED.  */
+
+static struct symbol *iterator_first_open_hashed
+  (const struct dictionary *dict, struct dict_iterator *iterator);
+
+static struct symbol *iterator_next_open_hashed
+  (struct dict_iterator *iterator);
+
+static struct symbol *iter_match_first_open_hashed
+  (const struct dictionary *dict, const lookup_name_info &name,
+   struct dict_iterator *iterator);
+
+static struct symbol *iter_match_next_open_hashed
+  (const lookup_name_info &name, struct dict_iterator *iterator);
+
+static int size_open_hashed (const struct dictionary *dict);
+
 /* Functions for DICT_LINEAR and DICT_LINEAR_EXPANDABLE
    dictionaries.  */
 
@@ -309,6 +359,18 @@ static const struct dict_vector dict_hashed_expandable_vector =
     size_hashed_expandable,		/* size */
   };
 
+static const struct dict_vector dict_open_hashed_vector =
+  {
+    DICT_OPEN_HASHED,			/* type */
+    free_obstack,			/* free */
+    add_symbol_nonexpandable,		/* add_symbol */
+    iterator_first_open_hashed,		/* iterator_first */
+    iterator_next_open_hashed,		/* iterator_next */
+    iter_match_first_open_hashed,	/* iter_name_first */
+    iter_match_next_open_hashed,	/* iter_name_next */
+    size_open_hashed,			/* size */
+  };
+
 static const struct dict_vector dict_linear_vector =
   {
     DICT_LINEAR,			/* type */
@@ -343,6 +405,9 @@ static void insert_symbol_hashed (struct dictionary *dict,
 
 static void expand_hashtable (struct dictionary *dict);
 
+static void insert_symbol_open_hashed (struct dictionary *dict,
+				       struct symbol *sym);
+
 /* The creation functions.  */
 
 /* Create a hashed dictionary of a given language.  */
@@ -389,6 +454,41 @@ dict_create_hashed_expandable (enum language language)
   return retval;
 }
 
+/* Create an open addressing hashed dictionary of a given language.  */
+
+static struct dictionary *
+dict_create_open_hashed (struct obstack *obstack,
+			 enum language language,
+			 const std::vector<symbol *> &symbol_list)
+{
+  /* Allocate the dictionary.  */
+  struct dictionary *retval = XOBNEW (obstack, struct dictionary);
+  DICT_VECTOR (retval) = &dict_open_hashed_vector;
+  DICT_LANGUAGE (retval) = language_def (language);
+
+  /* Allocate space for symbols.  Keep the table at most 80% full, so
+     that a probe usually ends in the first group.  */
+  int nsyms = symbol_list.size ();
+  int nslots = DICT_OPEN_HASHED_GROUP_SIZE;
+  while (nslots < nsyms + nsyms / 4)
+    nslots *= 2;
+  DICT_OPEN_HASHED_NSLOTS (retval) = nslots;
+  DICT_OPEN_HASHED_SLOTS (retval)
+    = XOBNEWVEC (obstack, struct symbol *, nslots);
+  gdb_byte *tags = XOBNEWVEC (obstack, gdb_byte, nslots);
+  memset (tags, 0, nslots);
+  DICT_OPEN_HASHED_TAGS (retval) = tags;
+  DICT_OPEN_HASHED_NSYMS (retval) = nsyms;
+
+  /* Now fill the slots.  Insert the symbols in reverse order, so that
+     symbols with the same name are found in the same order as in a
+     DICT_HASHED dictionary.  */
+  for (auto sym = symbol_list.rbegin (); sym != symbol_list.rend (); ++sym)
+    insert_symbol_open_hashed (retval, *sym);
+
+  return retval;
+}
+
 /* Create a linear dictionary of a given language.  */
 
 static struct dictionary *
@@ -795,6 +895,220 @@ language_defn::search_name_hash (const char *string0) const
   return hash;
 }
 
+/* Functions for DICT_OPEN_HASHED.  */
+
+/* Compute the first group to probe for HASH in DICT, and the tag of
+   HASH.  The search name hashes are not well mixed, so mix them
+   before using some of their bits.  */
+
+static void
+open_hashed_probe_start (const struct dictionary *dict, unsigned int hash,
+			 int *group, gdb_byte *tag)
+{
+  unsigned int mixed = hash * 0x9e3779b1;
+  int ngroups = DICT_OPEN_HASHED_NSLOTS (dict) / DICT_OPEN_HASHED_GROUP_SIZE;
+
+  *tag = (mixed & 0x7f) | 0x80;
+  *group = (mixed >> 7) & (ngroups - 1);
+}
+
+/* Load the group of tags starting at TAGS as a word.  */
+
+static inline uint64_t
+open_hashed_load_group (const gdb_byte *tags)
+{
+  gdb_static_assert (DICT_OPEN_HASHED_GROUP_SIZE == sizeof (uint64_t));
+
+  uint64_t word;
+  memcpy (&word, tags, sizeof (word));
+  return word;
+}
+
+/* Return non-zero if one of the tags in WORD, a group of tags, may be
+   TAG.  This may return false positives, but no false negatives.  */
+
+static inline uint64_t
+open_hashed_group_may_match (uint64_t word, gdb_byte tag)
+{
+  const uint64_t lsbs = 0x0101010101010101ull;
+  const uint64_t msbs = 0x8080808080808080ull;
+
+  /* The bytes of WORD that are TAG are zero in X.  */
+  uint64_t x = word ^ (lsbs * tag);
+  return (x - lsbs) & ~x & msbs;
+}
+
+/* Return non-zero if one of the tags in WORD, a group of tags, is an
+   empty slot.  */
+
+static inline uint64_t
+open_hashed_group_has_empty (uint64_t word)
+{
+  /* The tags of the slots in use have their high bit set.  */
+  return ~word & 0x8080808080808080ull;
+}
+
+/* Find the first symbol of DICT matching NAME, starting from SLOT in
+   the probe sequence for NAME.  Update ITERATOR and return the
+   symbol, or NULL if there is none.  */
+
+static struct symbol *
+open_hashed_find (const struct dictionary *dict,
+		  const lookup_name_info &name, int slot,
+		  struct dict_iterator *iterator)
+{
+  const language_defn *lang = DICT_LANGUAGE (dict);
+  symbol_name_matcher_ftype *matches_name
+    = lang->get_symbol_name_matcher (name);
+  const gdb_byte *tags = DICT_OPEN_HASHED_TAGS (dict);
+  int nslots = DICT_OPEN_HASHED_NSLOTS (dict);
+  int group;
+  gdb_byte tag;
+
+  open_hashed_probe_start (dict, name.search_name_hash (lang->la_language),
+			   &group, &tag);
+  if (slot < 0)
+    slot = group * DICT_OPEN_HASHED_GROUP_SIZE;
+
+  while (true)
+    {
+      int group_start = slot & ~(DICT_OPEN_HASHED_GROUP_SIZE - 1);
+      uint64_t word = open_hashed_load_group (&tags[group_start]);
+
+      if (open_hashed_group_may_match (word, tag))
+	{
+	  for (; slot < group_start + DICT_OPEN_HASHED_GROUP_SIZE; ++slot)
+	    {
+	      if (tags[slot] != tag)
+		continue;
+
+	      struct symbol *sym = DICT_OPEN_HASHED_SLOT (dict, slot);
+
+	      /* Warning: the order of arguments to compare matters!  */
+	      if (matches_name (sym->search_name (), name, NULL))
+		{
+		  DICT_ITERATOR_INDEX (iterator) = slot;
+		  return sym;
+		}
+	    }
+	}
+
+      /* The symbols are put in the first empty slot of their probe
+	 sequence, and are never removed.  So if this group has an empty
+	 slot, there is nothing further.  Since the table is never full,
+	 this ends the loop.  */
+      if (open_hashed_group_has_empty (word))
+	break;
+
+      slot = (group_start + DICT_OPEN_HASHED_GROUP_SIZE) & (nslots - 1);
+    }
+
+  DICT_ITERATOR_INDEX (iterator) = nslots;
+  return NULL;
+}
+
+static struct symbol *
+iterator_first_open_hashed (const struct dictionary *dict,
+			    struct dict_iterator *iterator)
+{
+  DICT_ITERATOR_DICT (iterator) = dict;
+  DICT_ITERATOR_INDEX (iterator) = -1;
+  return iterator_next_open_hashed (iterator);
+}
+
+static struct symbol *
+iterator_next_open_hashed (struct dict_iterator *iterator)
+{
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  const gdb_byte *tags = DICT_OPEN_HASHED_TAGS (dict);
+  int nslots = DICT_OPEN_HASHED_NSLOTS (dict);
+
+  for (int i = DICT_ITERATOR_INDEX (iterator) + 1; i < nslots; ++i)
+    {
+      if (tags[i] != 0)
+	{
+	  DICT_ITERATOR_INDEX (iterator) = i;
+	  return DICT_OPEN_HASHED_SLOT (dict, i);
+	}
+    }
+
+  DICT_ITERATOR_INDEX (iterator) = nslots;
+  return NULL;
+}
+
+static struct symbol *
+iter_match_first_open_hashed (const struct dictionary *dict,
+			      const lookup_name_info &name,
+			      struct dict_iterator *iterator)
+{
+  DICT_ITERATOR_DICT (iterator) = dict;
+  return open_hashed_find (dict, name, -1, iterator);
+}
+
+static struct symbol *
+iter_match_next_open_hashed (const lookup_name_info &name,
+			     struct dict_iterator *iterator)
+{
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  int slot = DICT_ITERATOR_INDEX (iterator) + 1;
+
+  /* If the previous match was the last slot of its group, the probe
+     sequence only goes on if that group is full.  */
+  if (slot % DICT_OPEN_HASHED_GROUP_SIZE == 0)
+    {
+      const gdb_byte *tags = DICT_OPEN_HASHED_TAGS (dict);
+      uint64_t word
+	= open_hashed_load_group (&tags[slot - DICT_OPEN_HASHED_GROUP_SIZE]);
+
+      if (open_hashed_group_has_empty (word))
+	{
+	  DICT_ITERATOR_INDEX (iterator) = DICT_OPEN_HASHED_NSLOTS (dict);
+	  return NULL;
+	}
+      slot &= DICT_OPEN_HASHED_NSLOTS (dict) - 1;
+    }
+
+  return open_hashed_find (dict, name, slot, iterator);
+}
+
+/* Insert SYM into DICT, in the first empty slot of its probe
+   sequence.  */
+
+static void
+insert_symbol_open_hashed (struct dictionary *dict, struct symbol *sym)
+{
+  gdb_byte *tags = DICT_OPEN_HASHED_TAGS (dict);
+  int nslots = DICT_OPEN_HASHED_NSLOTS (dict);
+  int group;
+  gdb_byte tag;
+
+  /* We don't want to insert a symbol into a dictionary of a different
+     language.  The two may not use the same hashing algorithm.  */
+  gdb_assert (sym->language () == DICT_LANGUAGE (dict)->la_language);
+
+  open_hashed_probe_start (dict,
+			   search_name_hash (sym->language (),
+					     sym->search_name ()),
+			   &group, &tag);
+
+  for (int slot = group * DICT_OPEN_HASHED_GROUP_SIZE;;
+       slot = (slot + 1) & (nslots - 1))
+    {
+      if (tags[slot] == 0)
+	{
+	  tags[slot] = tag;
+	  DICT_OPEN_HASHED_SLOT (dict, slot) = sym;
+	  return;
+	}
+    }
+}
+
+static int
+size_open_hashed (const struct dictionary *dict)
+{
+  return DICT_OPEN_HASHED_NSYMS (dict);
+}
+
 /* Functions for DICT_LINEAR and DICT_LINEAR_EXPANDABLE.  */
 
 static struct symbol *
@@ -947,7 +1261,8 @@ collate_pending_symbols_by_language (const struct pending *symbol_list)
 
 struct multidictionary *
 mdict_create_hashed (struct obstack *obstack,
-		     const struct pending *symbol_list)
+		     const struct pending *symbol_list,
+		     dict_hashing hashing)
 {
   struct multidictionary *retval
     = XOBNEW (obstack, struct multidictionary);
@@ -965,8 +1280,12 @@ mdict_create_hashed (struct obstack *obstack,
       enum language language = pair.first;
       std::vector<symbol *> symlist = pair.second;
 
-      retval->dictionaries[idx++]
-	= dict_create_hashed (obstack, language, symlist);
+      if (hashing == dict_hashing::open_addressing)
+	retval->dictionaries[idx++]
+	  = dict_create_open_hashed (obstack, language, symlist);
+      else
+	retval->dictionaries[idx++]
+	  = dict_create_hashed (obstack, language, symlist);
     }
 
   return retval;
@@ -1049,6 +1368,7 @@ mdict_free (struct multidictionary *mdict)
   switch (type)
     {
     case DICT_HASHED:
+    case DICT_OPEN_HASHED:
     case DICT_LINEAR:
       /* Memory was allocated on an obstack when created.  */
       break;
@@ -1093,6 +1413,7 @@ create_new_language_dictionary (struct multidictionary *mdict,
   switch (mdict->dictionaries[0]->vector->type)
     {
     case DICT_HASHED:
+    case DICT_OPEN_HASHED:
     case DICT_LINEAR:
       internal_error (__FILE__, __LINE__,
 		      _("create_new_language_dictionary: attempted to expand "
@@ -40,13 +40,29 @@ struct language_defn;
 /* The creation functions for various implementations of
    multi-language dictionaries.  */
 
+/* The implementations of fixed-size hashed dictionaries.  */
+
+enum class dict_hashing
+{
+  /* Each hash bucket is a list of symbols.  This uses the least
+     memory.  */
+  chained,
+
+  /* The symbols are stored in a flat open addressing table, along
+     with a few bits of their hash.  This makes lookups in large
+     dictionaries faster, at the cost of some memory.  */
+  open_addressing,
+};
+
 /* Create a multi-language dictionary of symbols implemented via
-   a fixed-size hashtable.  All memory it uses is allocated on
-   OBSTACK; the environment is initialized from SYMBOL_LIST.  */
+   a fixed-size hashtable, using HASHING.  All memory it uses is
+   allocated on OBSTACK; the environment is initialized from
+   SYMBOL_LIST.  */
 
 extern struct multidictionary *
   mdict_create_hashed (struct obstack *obstack,
-		       const struct pending *symbol_list);
+		       const struct pending *symbol_list,
+		       dict_hashing hashing = dict_hashing::chained);
 
 /* Create a multi-language dictionary of symbols, implemented
    via a hashtable that grows as necessary.  The initial dictionary of
@@ -75,6 +75,44 @@ abbrev_table::add_abbrev (struct abbrev_info *abbrev)
   *slot = abbrev;
 }
 
+/* Return the number of bytes an attribute of form FORM takes in a
+   DIE, if that doesn't depend on the value or on the unit header;
+   otherwise return -1.  */
+
+static int
+constant_form_size (dwarf_form form)
+{
+  switch (form)
+    {
+    case DW_FORM_flag_present:
+    case DW_FORM_implicit_const:
+      return 0;
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+    case DW_FORM_flag:
+    case DW_FORM_strx1:
+      return 1;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+    case DW_FORM_strx2:
+      return 2;
+    case DW_FORM_strx3:
+      return 3;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+    case DW_FORM_strx4:
+      return 4;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+      return 8;
+    case DW_FORM_data16:
+      return 16;
+    default:
+      return -1;
+    }
+}
+
 /* Read in an abbrev table.  */
 
 abbrev_table_up
@@ -117,6 +155,11 @@ abbrev_table::read (struct dwarf2_section_info *section,
 
       /* Now read in declarations.  */
       int num_attrs = 0;
+      int num_die_attrs = 0;
+      /* The size of the attributes read so far, or -1 if it isn't
+	 constant.  */
+      int size = 0;
+      int sibling_offset = -1;
       for (;;)
 	{
 	  struct attr_abbrev cur_attr;
@@ -142,13 +185,126 @@ abbrev_table::read (struct dwarf2_section_info *section,
 	    break;
 
 	  ++num_attrs;
+	  if (abbrev_attr_stored_in_die (cur_attr.name))
+	    ++num_die_attrs;
+	  if (cur_attr.name == DW_AT_sibling
+	      && cur_attr.form == DW_FORM_ref4
+	      && size != -1)
+	    sibling_offset = size;
+	  /* skip_one_die checks a DW_AT_sibling of any other form, and
+	     complains about it if it is bad, so don't let it skip such a
+	     DIE by size.  */
+	  if (cur_attr.name == DW_AT_sibling
+	      && cur_attr.form != DW_FORM_ref4)
+	    size = -1;
+	  if (size != -1)
+	    {
+	      int form_size = constant_form_size (cur_attr.form);
+	      if (form_size == -1)
+		size = -1;
+	      else
+		size += form_size;
+	    }
 	  obstack_grow (obstack, &cur_attr, sizeof (cur_attr));
 	}
 
       cur_abbrev = (struct abbrev_info *) obstack_finish (obstack);
       cur_abbrev->num_attrs = num_attrs;
+      cur_abbrev->num_die_attrs = num_die_attrs;
+      if (size > 0 && size <= (unsigned short) -1)
+	cur_abbrev->size_if_constant = size;
+      else
+	cur_abbrev->size_if_constant = 0;
+      if (sibling_offset >= 0 && sibling_offset < (unsigned short) -1)
+	cur_abbrev->sibling_offset = sibling_offset;
+      else
+	cur_abbrev->sibling_offset = (unsigned short) -1;
       abbrev_table->add_abbrev (cur_abbrev);
     }
 
+  abbrev_table->m_size = (abbrev_ptr - section->buffer
+			  - to_underlying (sect_off));
   return abbrev_table;
 }
+
+/* See abbrev.h.  */
+
+abbrev_table *
+abbrev_cache::find_or_read (struct dwarf2_section_info *section,
+			    sect_offset sect_off)
+{
+  auto key = std::make_pair (section, sect_off);
+
+  {
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+    auto iter = m_tables.find (key);
+    if (iter != m_tables.end ())
+      {
+	++m_hits;
+	m_bytes_saved += iter->second->size ();
+	return iter->second.get ();
+      }
+  }
+
+  /* Read the table without holding the lock, so that threads reading
+     different tables don't wait for each other.  */
+  abbrev_table_up table = abbrev_table::read (section, sect_off);
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+  /* If another thread read the same table in the meantime, ours is
+     simply discarded.  */
+  auto result = m_tables.emplace (key, std::move (table));
+  if (result.second)
+    m_size += result.first->second->size ();
+  ++m_misses;
+  return result.first->second.get ();
+}
+
+/* See abbrev.h.  */
+
+size_t
+abbrev_cache::size () const
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  return m_size;
+}
+
+/* See abbrev.h.  */
+
+void
+abbrev_cache::clear ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  m_tables.clear ();
+  m_size = 0;
+}
+
+/* See abbrev.h.  */
+
+void
+abbrev_cache::print_statistics () const
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_mutex);
+#endif
+
+  unsigned long lookups = m_hits + m_misses;
+  if (lookups == 0)
+    return;
+
+  printf_filtered (_("  Number of abbrev tables read: %lu\n"), m_misses);
+  printf_filtered (_("  Abbrev table cache hits: %lu (%d%% of lookups)\n"),
+		   m_hits, (int) (m_hits * 100 / lookups));
+  printf_filtered (_("  Abbrev bytes not re-parsed due to cache: %lu\n"),
+		   m_bytes_saved);
+}
@@ -27,7 +27,16 @@
 #ifndef GDB_DWARF2_ABBREV_H
 #define GDB_DWARF2_ABBREV_H
 
+#include "dwarf2.h"
+#include "gdbtypes.h"
+#include "gdb_obstack.h"
 #include "hashtab.h"
+#include <map>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
+struct dwarf2_section_info;
 
 struct attr_abbrev
 {
@@ -49,11 +58,41 @@ struct abbrev_info
   unsigned short has_children;
   /* Number of attributes.  */
   unsigned short num_attrs;
+  /* Number of attributes stored in a full DIE using this abbrev.
+     This is NUM_ATTRS less those for which abbrev_attr_stored_in_die
+     is false.  */
+  unsigned short num_die_attrs;
+  /* If the attributes of a DIE using this abbrev always take the same
+     number of bytes, that number; otherwise 0.  */
+  unsigned short size_if_constant;
+  /* If this abbrev has a DW_AT_sibling attribute of form
+     DW_FORM_ref4 that is always at the same offset from the end of the
+     abbrev number, that offset; otherwise (unsigned short) -1.  */
+  unsigned short sibling_offset;
   /* An array of attribute descriptions, allocated using the struct
      hack.  */
   struct attr_abbrev attrs[1];
 };
 
+/* Return true if an attribute named NAME should be stored in a full
+   DIE.  Attributes that are never looked at once the DIE tree is built
+   aren't, to save memory.  */
+
+static inline bool
+abbrev_attr_stored_in_die (dwarf_attribute name)
+{
+  switch (name)
+    {
+    case DW_AT_sibling:
+      /* The DIE tree already links the siblings.  */
+    case DW_AT_decl_column:
+      /* GDB does not track columns.  */
+      return false;
+    default:
+      return true;
+    }
+}
+
 struct abbrev_table;
 typedef std::unique_ptr<struct abbrev_table> abbrev_table_up;
 
@@ -85,6 +124,10 @@ struct abbrev_table
      This is used as a sanity check when the table is used.  */
   const sect_offset sect_off;
 
+  /* Return the number of section bytes this table was read from.  */
+  size_t size () const
+  { return m_size; }
+
 private:
 
   explicit abbrev_table (sect_offset off);
@@ -99,6 +142,62 @@ struct abbrev_table
 
   /* Storage for the abbrev table.  */
   auto_obstack m_abbrev_obstack;
+
+  /* Number of section bytes the table was read from.  */
+  size_t m_size = 0;
+};
+
+/* A cache of abbrev tables, keyed by section and offset.  Many units
+   typically share a handful of abbrev tables, so this avoids parsing
+   the same table over and over again.  The cached tables live until
+   the cache is cleared, and the cache may be used from multiple
+   threads.  */
+
+class abbrev_cache
+{
+public:
+  abbrev_cache () = default;
+  DISABLE_COPY_AND_ASSIGN (abbrev_cache);
+
+  /* Return the abbrev table at SECT_OFF in SECTION, reading it if it
+     isn't in the cache yet.  The caller is responsible for ensuring
+     that the section has already been read.  */
+  abbrev_table *find_or_read (struct dwarf2_section_info *section,
+			      sect_offset sect_off);
+
+  /* Return the number of section bytes the cached tables were read
+     from.  */
+  size_t size () const;
+
+  /* Release all the cached tables.  None of the tables returned by
+     find_or_read may still be in use.  */
+  void clear ();
+
+  /* Print the cache statistics, as done by "maint print statistics".  */
+  void print_statistics () const;
+
+private:
+
+  /* The cached tables.  */
+  std::map<std::pair<dwarf2_section_info *, sect_offset>,
+	   abbrev_table_up> m_tables;
+
+  /* Number of section bytes the tables in M_TABLES were read from.  */
+  size_t m_size = 0;
+
+  /* Number of lookups satisfied from the cache.  */
+  unsigned long m_hits = 0;
+
+  /* Number of tables that had to be read.  */
+  unsigned long m_misses = 0;
+
+  /* Number of section bytes that cache hits did not have to parse.  */
+  unsigned long m_bytes_saved = 0;
+
+#if CXX_STD_THREAD
+  /* Protects all of the above.  */
+  mutable std::mutex m_mutex;
+#endif
 };
 
 #endif /* GDB_DWARF2_ABBREV_H */
@@ -20,6 +20,8 @@
 #include "defs.h"
 #include "dwarf2/cu.h"
 #include "dwarf2/read.h"
+#include "dwarf2/attribute.h"
+#include "dwarf2/die.h"
 
 /* Initialize dwarf2_cu to read PER_CU, in the context of PER_OBJFILE.  */
 
@@ -83,6 +85,50 @@ dwarf2_cu::start_symtab (const char *name, const char *comp_dir,
   return get_builder ()->get_compunit_symtab ();
 }
 
+/* See cu.h.  */
+
+void
+dwarf2_cu::reopen_symtab_for_lines (struct compunit_symtab *cust,
+				    const char *name)
+{
+  gdb_assert (m_builder == nullptr);
+
+  m_builder.reset (new struct buildsym_compunit
+		   (this->per_objfile->objfile, name,
+		    COMPUNIT_DIRNAME (cust), per_cu->lang, 0, cust));
+
+  /* start_symtab's builder starts with a subfile for the main source
+     file; do the same, so that file names from the line header resolve
+     to the same subfiles as they did then.  */
+  get_builder ()->start_subfile (name);
+}
+
+/* See cu.h.  */
+
+void
+dwarf2_cu::add_die (struct die_info *die)
+{
+  gdb_assert (die_index.empty ()
+	      || die_index.back ()->sect_off < die->sect_off);
+  die_index.push_back (die);
+}
+
+/* See cu.h.  */
+
+struct die_info *
+dwarf2_cu::find_die (sect_offset sect_off) const
+{
+  auto iter = std::lower_bound (die_index.begin (), die_index.end (),
+				sect_off,
+				[] (const die_info *die, sect_offset off)
+				{
+				  return die->sect_off < off;
+				});
+  if (iter == die_index.end () || (*iter)->sect_off != sect_off)
+    return nullptr;
+  return *iter;
+}
+
 /* See read.h.  */
 
 struct type *
@@ -24,6 +24,8 @@
 #include "dwarf2/comp-unit-head.h"
 #include "gdbsupport/gdb_optional.h"
 
+struct psymtab_cu_scan;
+
 /* Type used for delaying computation of method physnames.
    See comments for compute_delayed_physnames.  */
 struct delayed_method_info
@@ -65,9 +67,23 @@ struct dwarf2_cu
 					const char *comp_dir,
 					CORE_ADDR low_pc);
 
+  /* Reopen CUST, an already completed compunit, so that the line
+     numbers of this CU can be recorded into it.  NAME is as was passed
+     to start_symtab when CUST was created.  */
+  void reopen_symtab_for_lines (struct compunit_symtab *cust,
+				const char *name);
+
   /* Reset the builder.  */
   void reset_builder () { m_builder.reset (); }
 
+  /* Add DIE to die_index.  DIEs must be added in increasing order of
+     their offsets.  */
+  void add_die (struct die_info *die);
+
+  /* Return the full DIE of this CU at SECT_OFF, or NULL if there is
+     none.  */
+  struct die_info *find_die (sect_offset sect_off) const;
+
   /* Return a type that is a generic pointer type, the size of which
      matches the address size given in the compilation unit header for
      this CU.  */
@@ -133,6 +149,12 @@ struct dwarf2_cu
      with partial_die->offset.SECT_OFF as hash.  */
   htab_t partial_dies = nullptr;
 
+  /* Non-NULL while the partial DIEs of this CU are scanned on behalf
+     of a psymtab_cu_scan, possibly on a worker thread.  What the scan
+     finds is then recorded there, instead of in the psymtab storage of
+     the objfile.  */
+  struct psymtab_cu_scan *psymtab_scan = nullptr;
+
   /* Storage for things with the same lifetime as this read-in compilation
      unit, including partial DIEs.  */
   auto_obstack comp_unit_obstack;
@@ -146,15 +168,21 @@ struct dwarf2_cu
   /* How many compilation units ago was this CU last referenced?  */
   int last_used = 0;
 
-  /* A hash table of DIE cu_offset for following references with
-     die_info->offset.sect_off as hash.  */
-  htab_t die_hash = nullptr;
+  /* The full DIEs of this CU other than its top-level DIE, in the
+     order they were read.  This is also the order of their offsets,
+     so references to DIEs are followed with a binary search.  */
+  std::vector<struct die_info *> die_index;
 
   /* Full DIEs if read in.  */
   struct die_info *dies = nullptr;
 
   /* Header data from the line table, during full symbol processing.  */
   struct line_header *line_header = nullptr;
+
+  /* If non-NULL, the object that decodes the line number program of
+     this CU when it is first needed.  It is owned by the
+     dwarf2_per_objfile.  */
+  struct line_table_reader *line_table_reader = nullptr;
   /* Non-NULL if LINE_HEADER is owned by this DWARF_CU.  Otherwise,
      it's owned by dwarf2_per_bfd::line_header_hash.  If non-NULL,
      this is the DW_TAG_compile_unit die for this CU.  We'll hold on
@@ -31,12 +31,14 @@
 #include "dwarf2/loc.h"
 #include "dwarf2/read.h"
 #include "frame.h"
+#include "gdbcmd.h"
 #include "gdbsupport/underlying.h"
 #include "gdbarch.h"
 #include "gdbthread.h"
 #include "inferior.h"
 #include "objfiles.h"
 #include "observable.h"
+#include <unordered_map>
 
 /* Cookie for gdbarch data.  */
 
@@ -2579,6 +2581,197 @@ sect_variable_value (sect_offset sect_off,
 				     type, true);
 }
 
+/* An entry of the stack of the fast expression evaluator.  Unlike a
+   dwarf_entry, it is a plain tagged value that does not need to be
+   allocated, and it can only describe the few kinds of entries that
+   the common location expressions produce.  */
+
+struct fast_eval_entry
+{
+  enum kind_t
+  {
+    /* A generic value of the address type.  */
+    VALUE,
+
+    /* A memory location description.  */
+    MEMORY,
+
+    /* A register location description.  */
+    REGISTER,
+
+    /* An implicit location description holding a value of the address
+       type, as created by DW_OP_stack_value.  */
+    IMPLICIT
+  };
+
+  kind_t kind;
+
+  /* For VALUE and IMPLICIT, the value truncated to the address size.
+     For MEMORY, the offset of the location.  For REGISTER, the DWARF
+     register number.  */
+  ULONGEST value;
+
+  /* For MEMORY, whether the location is on the program's stack.  */
+  bool on_stack;
+};
+
+/* The fixed-size stack of the fast expression evaluator.  */
+
+struct fast_eval_stack
+{
+  /* The maximum depth of the stack.  Expressions that need a deeper
+     stack are left to the general evaluator.  */
+  static constexpr int max_size = 16;
+
+  fast_eval_entry entries[max_size];
+
+  /* The number of entries on the stack.  */
+  int size = 0;
+};
+
+/* An operation of a DWARF expression compiled for the fast expression
+   evaluator.  */
+
+struct fast_expr_op
+{
+  enum opcode_t
+  {
+    /* Push the value OPERAND.  */
+    PUSH_VALUE,
+
+    /* Push the memory location at OPERAND, relocated by the text
+       section offset of the objfile.  */
+    PUSH_ADDR,
+
+    /* Push the location of the DWARF register OPERAND.  */
+    PUSH_REG,
+
+    /* Push the memory location at the contents of the DWARF register
+       OPERAND plus OFFSET.  */
+    PUSH_BREG,
+
+    /* Push the memory location at the frame base plus OFFSET.  */
+    PUSH_FBREG,
+
+    /* Push the memory location of the canonical frame address.  */
+    PUSH_CFA,
+
+    /* Replace the top entry with its value plus OPERAND.  */
+    PLUS_UCONST,
+
+    /* The stack operations of the same names.  */
+    DUP,
+    DROP,
+    SWAP,
+    OVER,
+
+    /* Replace the top entry with an implicit location holding its
+       value.  */
+    STACK_VALUE
+  };
+
+  opcode_t opcode;
+
+  /* The DWARF operation this operation was compiled from, for error
+     messages.  */
+  dwarf_location_atom atom;
+
+  ULONGEST operand;
+  LONGEST offset;
+};
+
+/* A DWARF expression compiled for the fast expression evaluator.  The
+   kinds of the stack entries only depend on the operations, so the
+   compilation checks the stack depth and the kinds of the operands of
+   each operation once and for all.  Runs of constants and
+   DW_OP_plus_uconst operations are folded, and DW_OP_nop is
+   dropped.  */
+
+struct fast_expr_program
+{
+  /* Whether the fast evaluator supports the expression.  If not, the
+     general evaluator must evaluate it, and OPS is empty.  */
+  bool supported = false;
+
+  /* Whether the expression uses DW_OP_fbreg.  Such an expression can
+     not describe a frame base.  */
+  bool uses_frame_base = false;
+
+  std::vector<fast_expr_op> ops;
+};
+
+/* The key of a compiled expression in a fast_expr_cache.  */
+
+struct fast_expr_cache_key
+{
+  dwarf2_per_cu_data *per_cu;
+  const gdb_byte *addr;
+  size_t len;
+  int addr_size;
+
+  bool operator== (const fast_expr_cache_key &other) const
+  {
+    return (per_cu == other.per_cu && addr == other.addr
+	    && len == other.len && addr_size == other.addr_size);
+  }
+};
+
+/* Hash a fast_expr_cache_key.  */
+
+struct fast_expr_cache_key_hash
+{
+  size_t operator() (const fast_expr_cache_key &key) const noexcept
+  {
+    size_t hash = std::hash<const void *> () (key.addr);
+
+    hash = hash * 31 + std::hash<const void *> () (key.per_cu);
+    return hash * 31 + key.len;
+  }
+};
+
+/* A compiled expression in a fast_expr_cache, with a copy of the
+   bytes it was compiled from.  The copy makes sure that an expression
+   later found at the same address, for instance in a buffer that was
+   freed and reused, is not mistaken for the cached one.  */
+
+struct fast_expr_cache_entry
+{
+  gdb::byte_vector bytes;
+  fast_expr_program program;
+};
+
+/* The compiled expressions of an objfile, so that the expressions of
+   the variables read at every stop are only decoded once.  */
+
+struct fast_expr_cache
+{
+  std::unordered_map<fast_expr_cache_key, fast_expr_cache_entry,
+		     fast_expr_cache_key_hash> entries;
+};
+
+static const objfile_key<fast_expr_cache> fast_expr_cache_objfile_key;
+
+/* Whether compiled expressions are cached.  */
+
+static bool dwarf_expr_cache_enabled = true;
+
+/* The number of lookups of compiled expressions that hit and missed
+   the cache.  */
+
+static unsigned int dwarf_expr_cache_hits;
+static unsigned int dwarf_expr_cache_misses;
+
+/* Whether the fast expression evaluator is used.  */
+
+static bool dwarf_fast_expr_eval = true;
+
+/* The number of expressions evaluated by the fast expression evaluator
+   and by the general evaluator, for "maint print
+   dwarf-expression-statistics".  */
+
+static unsigned int dwarf_fast_expr_eval_hits;
+static unsigned int dwarf_fast_expr_eval_misses;
+
 /* The expression evaluator works with a dwarf_expr_context, describing
    its current state and its callbacks.  */
 struct dwarf_expr_context
@@ -2705,6 +2898,35 @@ struct dwarf_expr_context
      object, evaluate the expression between OP_PTR and OP_END.  */
   void execute_stack_op (const gdb_byte *op_ptr, const gdb_byte *op_end);
 
+  /* Try to evaluate the expression at ADDR (LEN bytes long) on a
+     fast_eval_stack, without allocating an entry for each operation.
+     If the expression only uses operations the fast evaluator
+     supports, push its result on the stack and return true.
+     Otherwise, leave the stack untouched and return false.  */
+  bool fast_eval (const gdb_byte *addr, size_t len);
+
+  /* Return the compiled form of the expression at ADDR (LEN bytes
+     long), from the cache of the objfile if possible.  SCRATCH is used
+     to hold the program when the cache is disabled.  */
+  const fast_expr_program *fast_get_program (const gdb_byte *addr,
+					     size_t len,
+					     fast_expr_program *scratch);
+
+  /* The engine of the fast evaluator.  Execute PROGRAM, a supported
+     program, on STACK.  Return false if the contents of a register or
+     of the frame base can not be handled by the fast evaluator.  */
+  bool fast_execute (const fast_expr_program &program,
+		     fast_eval_stack &stack);
+
+  /* Read the register REGNUM of the current frame as a value of the
+     address type, into VALUE.  Return false if the register is larger
+     than an address or if its contents are not available.  */
+  bool fast_read_register (int regnum, ULONGEST *value);
+
+  /* Convert VALUE, a value of the address type, to the offset of a
+     memory location, like dwarf_value::to_location.  */
+  CORE_ADDR fast_value_to_address (ULONGEST value);
+
   /* Pop the top item off of the stack.  */
   void pop ();
 
@@ -2917,6 +3139,603 @@ dwarf_expr_context::fetch_result (struct type *type, struct type *subobj_type,
   return entry->to_gdb_value (this->m_frame, type, subobj_type, subobj_offset);
 }
 
+bool
+dwarf_expr_context::fast_read_register (int regnum, ULONGEST *value)
+{
+  gdbarch *arch = this->m_per_objfile->objfile->arch ();
+  int regsize = register_size (arch, regnum);
+  gdb_byte buf[sizeof (ULONGEST)];
+
+  if (regsize == 0 || regsize > this->m_addr_size)
+    return false;
+
+  int optimized, unavailable, realnum;
+  lval_type lval;
+  CORE_ADDR address;
+
+  frame_register (this->m_frame, regnum, &optimized, &unavailable,
+		  &lval, &address, &realnum, buf);
+  if (optimized || unavailable)
+    return false;
+
+  *value = extract_unsigned_integer (buf, regsize,
+				     type_byte_order (address_type ()));
+  return true;
+}
+
+CORE_ADDR
+dwarf_expr_context::fast_value_to_address (ULONGEST value)
+{
+  gdbarch *arch = this->m_per_objfile->objfile->arch ();
+
+  if (!gdbarch_integer_to_address_p (arch))
+    return value;
+
+  type *address_type = this->address_type ();
+  gdb_byte buf[sizeof (ULONGEST)];
+
+  store_unsigned_integer (buf, this->m_addr_size,
+			  type_byte_order (address_type), value);
+  return gdbarch_integer_to_address (arch, address_type, buf,
+				     ARCH_ADDR_SPACE_ID_DEFAULT);
+}
+
+/* Helper for compile_fast_expr.  Append the operations of the
+   expression between OP_PTR and OP_END to PROGRAM, and return false
+   as soon as an operation the fast evaluator does not support is
+   found.  */
+
+static bool
+compile_fast_expr_1 (const gdb_byte *op_ptr, const gdb_byte *op_end,
+		     int addr_size, bfd_endian byte_order,
+		     fast_expr_program *program)
+{
+  std::vector<fast_expr_op> &ops = program->ops;
+  ULONGEST mask = ~(ULONGEST) 0;
+
+  if (addr_size < sizeof (ULONGEST))
+    mask = ((ULONGEST) 1 << (addr_size * HOST_CHAR_BIT)) - 1;
+
+  /* The kinds of the entries on the stack, after each operation.  */
+  fast_eval_entry::kind_t kinds[fast_eval_stack::max_size];
+  int depth = 0;
+
+  while (op_ptr < op_end)
+    {
+      dwarf_location_atom atom = (dwarf_location_atom) *op_ptr++;
+      fast_expr_op op = { fast_expr_op::PUSH_VALUE, atom, 0, 0 };
+      fast_eval_entry::kind_t kind = fast_eval_entry::VALUE;
+      uint64_t uoffset, reg;
+      int64_t offset;
+      int size;
+
+      switch (atom)
+	{
+	case DW_OP_lit0:
+	case DW_OP_lit1:
+	case DW_OP_lit2:
+	case DW_OP_lit3:
+	case DW_OP_lit4:
+	case DW_OP_lit5:
+	case DW_OP_lit6:
+	case DW_OP_lit7:
+	case DW_OP_lit8:
+	case DW_OP_lit9:
+	case DW_OP_lit10:
+	case DW_OP_lit11:
+	case DW_OP_lit12:
+	case DW_OP_lit13:
+	case DW_OP_lit14:
+	case DW_OP_lit15:
+	case DW_OP_lit16:
+	case DW_OP_lit17:
+	case DW_OP_lit18:
+	case DW_OP_lit19:
+	case DW_OP_lit20:
+	case DW_OP_lit21:
+	case DW_OP_lit22:
+	case DW_OP_lit23:
+	case DW_OP_lit24:
+	case DW_OP_lit25:
+	case DW_OP_lit26:
+	case DW_OP_lit27:
+	case DW_OP_lit28:
+	case DW_OP_lit29:
+	case DW_OP_lit30:
+	case DW_OP_lit31:
+	  op.operand = atom - DW_OP_lit0;
+	  break;
+
+	case DW_OP_addr:
+	  if (op_ptr + addr_size > op_end)
+	    return false;
+	  op.operand = extract_unsigned_integer (op_ptr, addr_size,
+						 byte_order);
+	  op_ptr += addr_size;
+	  /* The TLS form of DW_OP_addr is left to the general
+	     evaluator.  */
+	  if (op_ptr < op_end && *op_ptr == DW_OP_GNU_push_tls_address)
+	    return false;
+	  op.opcode = fast_expr_op::PUSH_ADDR;
+	  kind = fast_eval_entry::MEMORY;
+	  break;
+
+	case DW_OP_const1u:
+	case DW_OP_const1s:
+	case DW_OP_const2u:
+	case DW_OP_const2s:
+	case DW_OP_const4u:
+	case DW_OP_const4s:
+	case DW_OP_const8u:
+	case DW_OP_const8s:
+	  size = (atom == DW_OP_const1u || atom == DW_OP_const1s ? 1
+		  : atom == DW_OP_const2u || atom == DW_OP_const2s ? 2
+		  : atom == DW_OP_const4u || atom == DW_OP_const4s ? 4 : 8);
+	  if (op_ptr + size > op_end)
+	    return false;
+	  if (atom == DW_OP_const1s || atom == DW_OP_const2s
+	      || atom == DW_OP_const4s || atom == DW_OP_const8s)
+	    op.operand = extract_signed_integer (op_ptr, size, byte_order);
+	  else
+	    op.operand = extract_unsigned_integer (op_ptr, size, byte_order);
+	  op_ptr += size;
+	  break;
+	case DW_OP_constu:
+	  op_ptr = gdb_read_uleb128 (op_ptr, op_end, &uoffset);
+	  if (op_ptr == nullptr)
+	    return false;
+	  op.operand = uoffset;
+	  break;
+	case DW_OP_consts:
+	  op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+	  if (op_ptr == nullptr)
+	    return false;
+	  op.operand = offset;
+	  break;
+
+	case DW_OP_reg0:
+	case DW_OP_reg1:
+	case DW_OP_reg2:
+	case DW_OP_reg3:
+	case DW_OP_reg4:
+	case DW_OP_reg5:
+	case DW_OP_reg6:
+	case DW_OP_reg7:
+	case DW_OP_reg8:
+	case DW_OP_reg9:
+	case DW_OP_reg10:
+	case DW_OP_reg11:
+	case DW_OP_reg12:
+	case DW_OP_reg13:
+	case DW_OP_reg14:
+	case DW_OP_reg15:
+	case DW_OP_reg16:
+	case DW_OP_reg17:
+	case DW_OP_reg18:
+	case DW_OP_reg19:
+	case DW_OP_reg20:
+	case DW_OP_reg21:
+	case DW_OP_reg22:
+	case DW_OP_reg23:
+	case DW_OP_reg24:
+	case DW_OP_reg25:
+	case DW_OP_reg26:
+	case DW_OP_reg27:
+	case DW_OP_reg28:
+	case DW_OP_reg29:
+	case DW_OP_reg30:
+	case DW_OP_reg31:
+	  op.opcode = fast_expr_op::PUSH_REG;
+	  op.operand = atom - DW_OP_reg0;
+	  kind = fast_eval_entry::REGISTER;
+	  break;
+
+	case DW_OP_regx:
+	  op_ptr = gdb_read_uleb128 (op_ptr, op_end, &reg);
+	  if (op_ptr == nullptr)
+	    return false;
+	  op.opcode = fast_expr_op::PUSH_REG;
+	  op.operand = reg;
+	  kind = fast_eval_entry::REGISTER;
+	  break;
+
+	case DW_OP_stack_value:
+	  /* DW_OP_stack_value followed by pieces is left to the general
+	     evaluator.  */
+	  if (op_ptr != op_end || depth == 0
+	      || kinds[depth - 1] == fast_eval_entry::REGISTER)
+	    return false;
+	  op.opcode = fast_expr_op::STACK_VALUE;
+	  kinds[depth - 1] = fast_eval_entry::IMPLICIT;
+	  ops.push_back (op);
+	  continue;
+
+	case DW_OP_breg0:
+	case DW_OP_breg1:
+	case DW_OP_breg2:
+	case DW_OP_breg3:
+	case DW_OP_breg4:
+	case DW_OP_breg5:
+	case DW_OP_breg6:
+	case DW_OP_breg7:
+	case DW_OP_breg8:
+	case DW_OP_breg9:
+	case DW_OP_breg10:
+	case DW_OP_breg11:
+	case DW_OP_breg12:
+	case DW_OP_breg13:
+	case DW_OP_breg14:
+	case DW_OP_breg15:
+	case DW_OP_breg16:
+	case DW_OP_breg17:
+	case DW_OP_breg18:
+	case DW_OP_breg19:
+	case DW_OP_breg20:
+	case DW_OP_breg21:
+	case DW_OP_breg22:
+	case DW_OP_breg23:
+	case DW_OP_breg24:
+	case DW_OP_breg25:
+	case DW_OP_breg26:
+	case DW_OP_breg27:
+	case DW_OP_breg28:
+	case DW_OP_breg29:
+	case DW_OP_breg30:
+	case DW_OP_breg31:
+	case DW_OP_bregx:
+	  if (atom == DW_OP_bregx)
+	    {
+	      op_ptr = gdb_read_uleb128 (op_ptr, op_end, &reg);
+	      if (op_ptr == nullptr)
+		return false;
+	    }
+	  else
+	    reg = atom - DW_OP_breg0;
+	  op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+	  if (op_ptr == nullptr)
+	    return false;
+	  op.opcode = fast_expr_op::PUSH_BREG;
+	  op.operand = reg;
+	  op.offset = offset;
+	  kind = fast_eval_entry::MEMORY;
+	  break;
+
+	case DW_OP_fbreg:
+	  op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+	  if (op_ptr == nullptr)
+	    return false;
+	  op.opcode = fast_expr_op::PUSH_FBREG;
+	  op.offset = offset;
+	  kind = fast_eval_entry::MEMORY;
+	  program->uses_frame_base = true;
+	  break;
+
+	case DW_OP_dup:
+	  if (depth < 1)
+	    return false;
+	  op.opcode = fast_expr_op::DUP;
+	  kind = kinds[depth - 1];
+	  break;
+
+	case DW_OP_drop:
+	  if (depth < 1)
+	    return false;
+	  op.opcode = fast_expr_op::DROP;
+	  depth--;
+	  ops.push_back (op);
+	  continue;
+
+	case DW_OP_swap:
+	  if (depth < 2)
+	    return false;
+	  op.opcode = fast_expr_op::SWAP;
+	  std::swap (kinds[depth - 1], kinds[depth - 2]);
+	  ops.push_back (op);
+	  continue;
+
+	case DW_OP_over:
+	  if (depth < 2)
+	    return false;
+	  op.opcode = fast_expr_op::OVER;
+	  kind = kinds[depth - 2];
+	  break;
+
+	case DW_OP_plus_uconst:
+	  op_ptr = gdb_read_uleb128 (op_ptr, op_end, &uoffset);
+	  if (op_ptr == nullptr || depth < 1
+	      || (kinds[depth - 1] != fast_eval_entry::VALUE
+		  && kinds[depth - 1] != fast_eval_entry::MEMORY))
+	    return false;
+	  kinds[depth - 1] = fast_eval_entry::VALUE;
+
+	  /* Fold the addition into the operation that computed the
+	     operand, if it is a constant or another addition.  */
+	  if (!ops.empty ()
+	      && (ops.back ().opcode == fast_expr_op::PUSH_VALUE
+		  || ops.back ().opcode == fast_expr_op::PLUS_UCONST))
+	    {
+	      ops.back ().operand = (ops.back ().operand + uoffset) & mask;
+	      continue;
+	    }
+
+	  op.opcode = fast_expr_op::PLUS_UCONST;
+	  op.operand = uoffset & mask;
+	  ops.push_back (op);
+	  continue;
+
+	case DW_OP_call_frame_cfa:
+	  op.opcode = fast_expr_op::PUSH_CFA;
+	  kind = fast_eval_entry::MEMORY;
+	  break;
+
+	case DW_OP_nop:
+	  continue;
+
+	default:
+	  return false;
+	}
+
+      /* The operation pushes an entry of kind KIND.  */
+      if (depth == fast_eval_stack::max_size)
+	return false;
+      kinds[depth++] = kind;
+
+      /* Values are truncated to the address type, like the contents
+	 of a dwarf_value.  */
+      if (op.opcode == fast_expr_op::PUSH_VALUE)
+	op.operand &= mask;
+      ops.push_back (op);
+    }
+
+  return depth > 0;
+}
+
+/* Compile the DWARF expression between OP_PTR and OP_END for the fast
+   evaluator, into PROGRAM.  ADDR_SIZE is the size of an address, and
+   BYTE_ORDER the byte order of the target.  */
+
+static void
+compile_fast_expr (const gdb_byte *op_ptr, const gdb_byte *op_end,
+		   int addr_size, bfd_endian byte_order,
+		   fast_expr_program *program)
+{
+  program->uses_frame_base = false;
+  program->ops.clear ();
+  program->supported = compile_fast_expr_1 (op_ptr, op_end, addr_size,
+					    byte_order, program);
+  if (!program->supported)
+    program->ops.clear ();
+}
+
+const fast_expr_program *
+dwarf_expr_context::fast_get_program (const gdb_byte *addr, size_t len,
+				      fast_expr_program *scratch)
+{
+  objfile *objfile = this->m_per_objfile->objfile;
+  bfd_endian byte_order = gdbarch_byte_order (objfile->arch ());
+
+  if (!dwarf_expr_cache_enabled)
+    {
+      compile_fast_expr (addr, addr + len, this->m_addr_size, byte_order,
+			 scratch);
+      return scratch;
+    }
+
+  fast_expr_cache *cache = fast_expr_cache_objfile_key.get (objfile);
+  if (cache == nullptr)
+    cache = fast_expr_cache_objfile_key.emplace (objfile);
+
+  fast_expr_cache_key key = { this->m_per_cu, addr, len, this->m_addr_size };
+  fast_expr_cache_entry &entry = cache->entries[key];
+
+  if (entry.bytes.size () == len
+      && (len == 0 || memcmp (entry.bytes.data (), addr, len) == 0))
+    {
+      dwarf_expr_cache_hits++;
+      return &entry.program;
+    }
+
+  dwarf_expr_cache_misses++;
+  entry.bytes.assign (addr, addr + len);
+  compile_fast_expr (addr, addr + len, this->m_addr_size, byte_order,
+		     &entry.program);
+  return &entry.program;
+}
+
+bool
+dwarf_expr_context::fast_execute (const fast_expr_program &program,
+				  fast_eval_stack &stack)
+{
+  gdbarch *arch = this->m_per_objfile->objfile->arch ();
+  ULONGEST mask = ~(ULONGEST) 0;
+
+  if (this->m_addr_size < sizeof (ULONGEST))
+    mask = ((ULONGEST) 1 << (this->m_addr_size * HOST_CHAR_BIT)) - 1;
+
+  /* The program was checked when it was compiled, so the stack depth
+     and the kinds of the entries are known to be right.  */
+  for (const fast_expr_op &op : program.ops)
+    {
+      fast_eval_entry result = { fast_eval_entry::VALUE, 0, false };
+
+      switch (op.opcode)
+	{
+	case fast_expr_op::PUSH_VALUE:
+	  result.value = op.operand;
+	  break;
+
+	case fast_expr_op::PUSH_ADDR:
+	  result.kind = fast_eval_entry::MEMORY;
+	  result.value = (op.operand
+			  + this->m_per_objfile->objfile->text_section_offset ());
+	  break;
+
+	case fast_expr_op::PUSH_REG:
+	  ensure_have_frame (this->m_frame,
+			     op.atom == DW_OP_regx ? "DW_OP_regx" : "DW_OP_reg");
+
+	  result.kind = fast_eval_entry::REGISTER;
+	  result.value = op.operand;
+	  break;
+
+	case fast_expr_op::PUSH_BREG:
+	  {
+	    ensure_have_frame (this->m_frame,
+			       op.atom == DW_OP_bregx
+			       ? "DW_OP_bregx" : "DW_OP_breg");
+
+	    int regnum = dwarf_reg_to_regnum_or_error (arch, op.operand);
+	    ULONGEST regval;
+
+	    if (!fast_read_register (regnum, &regval))
+	      return false;
+
+	    result.kind = fast_eval_entry::MEMORY;
+	    result.value = fast_value_to_address (regval) + op.offset;
+	  }
+	  break;
+
+	case fast_expr_op::PUSH_FBREG:
+	  {
+	    const gdb_byte *datastart;
+	    size_t datalen;
+	    fast_expr_program scratch;
+	    fast_eval_stack base_stack;
+
+	    this->get_frame_base (&datastart, &datalen);
+	    const fast_expr_program *base_program
+	      = fast_get_program (datastart, datalen, &scratch);
+	    if (!base_program->supported || base_program->uses_frame_base
+		|| !fast_execute (*base_program, base_stack))
+	      return false;
+
+	    fast_eval_entry base = base_stack.entries[base_stack.size - 1];
+	    CORE_ADDR base_addr;
+
+	    switch (base.kind)
+	      {
+	      case fast_eval_entry::MEMORY:
+		base_addr = base.value;
+		break;
+
+	      case fast_eval_entry::VALUE:
+		base_addr = fast_value_to_address (base.value);
+		break;
+
+	      case fast_eval_entry::REGISTER:
+		{
+		  /* The whole register must be read as an address.  */
+		  int regnum = dwarf_reg_to_regnum_or_error (arch, base.value);
+		  ULONGEST regval;
+
+		  if (register_size (arch, regnum) != this->m_addr_size
+		      || !fast_read_register (regnum, &regval))
+		    return false;
+		  base_addr = fast_value_to_address (regval);
+		}
+		break;
+
+	      default:
+		return false;
+	      }
+
+	    result.kind = fast_eval_entry::MEMORY;
+	    result.value = base_addr + op.offset;
+	    result.on_stack = true;
+	  }
+	  break;
+
+	case fast_expr_op::PUSH_CFA:
+	  ensure_have_frame (this->m_frame, "DW_OP_call_frame_cfa");
+
+	  result.kind = fast_eval_entry::MEMORY;
+	  result.value = dwarf2_frame_cfa (this->m_frame);
+	  result.on_stack = true;
+	  break;
+
+	case fast_expr_op::PLUS_UCONST:
+	  result = stack.entries[--stack.size];
+	  result.kind = fast_eval_entry::VALUE;
+	  result.value = (result.value + op.operand) & mask;
+	  result.on_stack = false;
+	  break;
+
+	case fast_expr_op::DUP:
+	  result = stack.entries[stack.size - 1];
+	  break;
+
+	case fast_expr_op::DROP:
+	  stack.size--;
+	  continue;
+
+	case fast_expr_op::SWAP:
+	  std::swap (stack.entries[stack.size - 1],
+		     stack.entries[stack.size - 2]);
+	  continue;
+
+	case fast_expr_op::OVER:
+	  result = stack.entries[stack.size - 2];
+	  break;
+
+	case fast_expr_op::STACK_VALUE:
+	  result = stack.entries[--stack.size];
+	  result.kind = fast_eval_entry::IMPLICIT;
+	  result.value &= mask;
+	  result.on_stack = false;
+	  break;
+	}
+
+      stack.entries[stack.size++] = result;
+    }
+
+  return true;
+}
+
+bool
+dwarf_expr_context::fast_eval (const gdb_byte *addr, size_t len)
+{
+  fast_expr_program scratch;
+  fast_eval_stack stack;
+
+  const fast_expr_program *program = fast_get_program (addr, len, &scratch);
+  if (!program->supported || !fast_execute (*program, stack))
+    return false;
+
+  gdbarch *arch = this->m_per_objfile->objfile->arch ();
+  type *address_type = this->address_type ();
+  const fast_eval_entry &top = stack.entries[stack.size - 1];
+
+  switch (top.kind)
+    {
+    case fast_eval_entry::VALUE:
+      push (std::make_shared<dwarf_value> (top.value, address_type));
+      break;
+
+    case fast_eval_entry::MEMORY:
+      push (std::make_shared<dwarf_memory> (arch, (LONGEST) top.value, 0,
+					    top.on_stack));
+      break;
+
+    case fast_eval_entry::REGISTER:
+      push (std::make_shared<dwarf_register> (arch, top.value));
+      break;
+
+    case fast_eval_entry::IMPLICIT:
+      {
+	gdb_byte buf[sizeof (ULONGEST)];
+	bfd_endian byte_order = type_byte_order (address_type);
+
+	store_unsigned_integer (buf, this->m_addr_size, byte_order,
+				top.value);
+	push (std::make_shared<dwarf_implicit> (arch, buf, this->m_addr_size,
+						byte_order));
+      }
+      break;
+    }
+
+  return true;
+}
+
 value *
 dwarf_expr_context::evaluate (const gdb_byte *addr, size_t len, bool as_lval,
 			      dwarf2_per_cu_data *per_cu, frame_info *frame,
@@ -2934,7 +3753,17 @@ dwarf_expr_context::evaluate (const gdb_byte *addr, size_t len, bool as_lval,
     for (unsigned int i = 0; i < init_values->size (); i++)
       push (gdb_value_to_dwarf_entry (arch, (*init_values)[i]));
 
-  eval (addr, len);
+  /* The fast evaluator does not handle expressions that start with a
+     non-empty stack.  */
+  if (dwarf_fast_expr_eval
+      && (init_values == nullptr || init_values->empty ())
+      && fast_eval (addr, len))
+    dwarf_fast_expr_eval_hits++;
+  else
+    {
+      dwarf_fast_expr_eval_misses++;
+      eval (addr, len);
+    }
   return fetch_result (type, subobj_type, subobj_offset, as_lval);
 }
 
@@ -4476,10 +5305,83 @@ dwarf2_evaluate (const gdb_byte *addr, size_t len, bool as_lval,
 		       type, subobj_type, subobj_offset);
 }
 
+/* Implement "maint show dwarf fast-expression-evaluation".  */
+
+static void
+show_dwarf_fast_expr_eval (struct ui_file *file, int from_tty,
+			   struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether to use the fast DWARF expression "
+		      "evaluator is %s.\n"),
+		    value);
+}
+
+/* Implement "maint print dwarf-expression-statistics".  */
+
+static void
+maintenance_print_dwarf_expr_statistics (const char *args, int from_tty)
+{
+  printf_filtered (_("DWARF expression statistics:\n"));
+  printf_filtered (_("  fast evaluations: %u\n"),
+		   dwarf_fast_expr_eval_hits);
+  printf_filtered (_("  general evaluations: %u\n"),
+		   dwarf_fast_expr_eval_misses);
+  printf_filtered (_("  compiled expression cache hits: %u\n"),
+		   dwarf_expr_cache_hits);
+  printf_filtered (_("  compiled expression cache misses: %u\n"),
+		   dwarf_expr_cache_misses);
+}
+
+/* Implement "maint show dwarf expression-cache".  */
+
+static void
+show_dwarf_expr_cache_enabled (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether to cache compiled DWARF expressions is %s.\n"),
+		    value);
+}
+
 void _initialize_dwarf2expr ();
 void
 _initialize_dwarf2expr ()
 {
   dwarf_arch_cookie
     = gdbarch_data_register_post_init (dwarf_gdbarch_types_init);
+
+  add_setshow_boolean_cmd ("fast-expression-evaluation", class_maintenance,
+			   &dwarf_fast_expr_eval, _("\
+Set whether to use the fast DWARF expression evaluator."), _("\
+Show whether to use the fast DWARF expression evaluator."), _("\
+When enabled, the common DWARF location expressions are evaluated on a\n\
+fixed-size stack of plain entries, without allocating an entry for each\n\
+operation.  Expressions using other operations are always evaluated by\n\
+the general evaluator."),
+			   NULL,
+			   show_dwarf_fast_expr_eval,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_setshow_boolean_cmd ("expression-cache", class_maintenance,
+			   &dwarf_expr_cache_enabled, _("\
+Set whether to cache compiled DWARF expressions."), _("\
+Show whether to cache compiled DWARF expressions."), _("\
+When enabled, the fast DWARF expression evaluator decodes each location\n\
+expression once, into a compiled form that is kept with the objfile and\n\
+reused at every later evaluation.  When disabled, the expression is\n\
+decoded at each evaluation."),
+			   NULL,
+			   show_dwarf_expr_cache_enabled,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_cmd ("dwarf-expression-statistics", class_maintenance,
+	   maintenance_print_dwarf_expr_statistics, _("\
+Print statistics about the DWARF expression evaluators.\n\
+Print how many DWARF expressions were evaluated by the fast evaluator,\n\
+how many were evaluated by the general evaluator, and how many lookups\n\
+of compiled expressions hit and missed the cache."),
+	   &maintenanceprintlist);
 }
@@ -43,6 +43,9 @@
 #include "dwarf2/loc.h"
 #include "dwarf2/frame-tailcall.h"
 #include "gdbsupport/gdb_binary_search.h"
+#include "gdbcmd.h"
+#include "observable.h"
+#include "progspace.h"
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #include "selftest-arch.h"
@@ -133,6 +136,73 @@ struct dwarf2_fde
 
 typedef std::vector<dwarf2_fde *> dwarf2_fde_table;
 
+/* The register rules set up by the initial instructions of a CIE,
+   saved so that they are not computed again for each frame.  The
+   rules also depend on the architecture and on the producer quirks
+   that affect the instructions, which are recorded with them.  */
+
+struct dwarf2_cie_rules
+{
+  struct gdbarch *gdbarch;
+  bool armcc_cfa_offsets_sf;
+  dwarf2_frame_state_reg_info regs;
+};
+
+/* The key of a dwarf2_frame_row: the FDE, the PC the row was computed
+   for, and what else the computation depended on.  */
+
+struct dwarf2_frame_row_key
+{
+  const dwarf2_fde *fde;
+  struct gdbarch *gdbarch;
+  CORE_ADDR text_offset;
+  CORE_ADDR pc;
+
+  /* Whether the entry PC of the function of the frame was available
+     and covered by the FDE, and if so, the entry PC.  */
+  bool entry_pc_p;
+  CORE_ADDR entry_pc;
+
+  bool operator== (const dwarf2_frame_row_key &other) const
+  {
+    return (fde == other.fde && gdbarch == other.gdbarch
+	    && text_offset == other.text_offset && pc == other.pc
+	    && entry_pc_p == other.entry_pc_p && entry_pc == other.entry_pc);
+  }
+};
+
+/* Hash a dwarf2_frame_row_key.  */
+
+struct dwarf2_frame_row_key_hash
+{
+  size_t operator() (const dwarf2_frame_row_key &key) const noexcept
+  {
+    size_t hash = std::hash<const void *> () (key.fde);
+
+    hash = hash * 31 + std::hash<CORE_ADDR> () (key.pc);
+    return hash * 31 + std::hash<CORE_ADDR> () (key.text_offset);
+  }
+};
+
+/* The row of the CFI table of an FDE at a given PC, as computed by
+   dwarf2_frame_cache, with the parts of the frame state that the rest
+   of dwarf2_frame_cache needs.  */
+
+struct dwarf2_frame_row
+{
+  dwarf2_frame_state_reg_info regs;
+
+  /* The location of the row, FS->PC.  */
+  CORE_ADDR pc;
+
+  bool armcc_cfa_offsets_reversed;
+
+  /* The CFA offset from the stack pointer at the entry PC, if
+     ENTRY_CFA_SP_OFFSET_P.  */
+  bool entry_cfa_sp_offset_p;
+  LONGEST entry_cfa_sp_offset;
+};
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the call frame information.  */
 
@@ -164,6 +234,19 @@ struct comp_unit
   /* The FDE table.  */
   dwarf2_fde_table fde_table;
 
+  /* The value of dwarf2_frame_cfi_cache_generation when CIE_RULES and
+     ROWS were last emptied.  */
+  unsigned int cfi_cache_generation = 0;
+
+  /* The register rules set up by the initial instructions of the CIEs
+     of this unit.  */
+  std::unordered_map<const dwarf2_cie *, dwarf2_cie_rules> cie_rules;
+
+  /* The rows of the CFI tables of the FDEs of this unit, at the PCs
+     of the frames unwound so far.  */
+  std::unordered_map<dwarf2_frame_row_key, dwarf2_frame_row,
+		     dwarf2_frame_row_key_hash> rows;
+
   /* Hold data used by this module.  */
   auto_obstack obstack;
 };
@@ -183,6 +266,47 @@ static CORE_ADDR read_encoded_value (struct comp_unit *unit, gdb_byte encoding,
 /* See dwarf2-frame.h.  */
 bool dwarf2_frame_unwinders_enabled_p = true;
 
+/* Whether the FDE lookups, the register rules of the CIEs and the rows
+   of the CFI tables are cached.  */
+static bool dwarf2_frame_cfi_cache_enabled = true;
+
+/* Incremented when the cached CFI data may have become stale, that
+   is when an objfile is added or removed, or when the caches are
+   flushed.  Each cache is emptied when it finds that this changed.  */
+static unsigned int dwarf2_frame_cfi_cache_generation;
+
+/* The maximum number of entries of the FDE lookup cache of a program
+   space, and of the row cache of a comp_unit.  A full cache is
+   emptied.  */
+static const size_t dwarf2_frame_cfi_cache_max_size = 1 << 16;
+
+/* Statistics of the CFI caches, for "maint print
+   dwarf-cfi-cache-statistics".  */
+
+static unsigned int fde_lookup_hits, fde_lookup_misses;
+static unsigned int cie_rules_hits, cie_rules_misses;
+static unsigned int row_hits, row_misses;
+
+/* A cached FDE lookup: the FDE found for a PC, the objfile it was
+   found in, and the text offset of the objfile at that time.  */
+
+struct fde_lookup_entry
+{
+  dwarf2_fde *fde;
+  struct objfile *objfile;
+  CORE_ADDR text_offset;
+};
+
+/* The FDE lookups of a program space, keyed by the PC looked up.  */
+
+struct fde_lookup_cache
+{
+  unsigned int generation = 0;
+  std::unordered_map<CORE_ADDR, fde_lookup_entry> entries;
+};
+
+static const program_space_key<fde_lookup_cache> fde_lookup_cache_key;
+
 /* Store the length the expression for the CFA in the `cfa_reg' field,
    which is unused in that case.  */
 #define cfa_exp_len cfa_reg
@@ -911,6 +1035,61 @@ struct dwarf2_frame_cache
   void *tailcall_cache;
 };
 
+/* Empty the CFI caches of UNIT if they are stale.  */
+
+static void
+check_cfi_cache_generation (comp_unit *unit)
+{
+  if (unit->cfi_cache_generation != dwarf2_frame_cfi_cache_generation)
+    {
+      unit->cie_rules.clear ();
+      unit->rows.clear ();
+      unit->cfi_cache_generation = dwarf2_frame_cfi_cache_generation;
+    }
+}
+
+/* Execute the initial instructions of the CIE of FDE on FS, for the
+   frame at PC, or reuse the register rules they set up for an earlier
+   frame.  GDBARCH and TEXT_OFFSET are as for execute_cfa_program.  */
+
+static void
+execute_cie_program (struct dwarf2_fde *fde, struct gdbarch *gdbarch,
+		     CORE_ADDR pc, struct dwarf2_frame_state *fs,
+		     CORE_ADDR text_offset)
+{
+  struct dwarf2_cie *cie = fde->cie;
+
+  if (!dwarf2_frame_cfi_cache_enabled)
+    {
+      execute_cfa_program (fde, cie->initial_instructions, cie->end,
+			   gdbarch, pc, fs, text_offset);
+      return;
+    }
+
+  comp_unit *unit = cie->unit;
+  check_cfi_cache_generation (unit);
+
+  auto it = unit->cie_rules.find (cie);
+  if (it != unit->cie_rules.end ()
+      && it->second.gdbarch == gdbarch
+      && it->second.armcc_cfa_offsets_sf == fs->armcc_cfa_offsets_sf)
+    {
+      cie_rules_hits++;
+      fs->regs = it->second.regs;
+      return;
+    }
+
+  cie_rules_misses++;
+  CORE_ADDR start_pc = fs->pc;
+  execute_cfa_program (fde, cie->initial_instructions, cie->end,
+		       gdbarch, pc, fs, text_offset);
+
+  /* The rules only depend on the CIE if its instructions did not
+     advance the location, and left no remembered state behind.  */
+  if (fs->pc == start_pc && fs->regs.prev == nullptr)
+    unit->cie_rules[cie] = { gdbarch, fs->armcc_cfa_offsets_sf, fs->regs };
+}
+
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 {
@@ -956,48 +1135,95 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
+  CORE_ADDR text_offset = cache->per_objfile->objfile->text_section_offset ();
 
   /* Fetching the entry pc for THIS_FRAME won't necessarily result
      in an address that's within the range of FDE locations.  This
      is due to the possibility of the function occupying non-contiguous
      ranges.  */
-  LONGEST entry_cfa_sp_offset;
+  bool entry_pc_p = (get_frame_func_if_available (this_frame, &entry_pc)
+		     && fde->initial_location <= entry_pc
+		     && entry_pc < (fde->initial_location
+				    + fde->address_range));
+  LONGEST entry_cfa_sp_offset = 0;
   int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= entry_pc
-      && entry_pc < fde->initial_location + fde->address_range)
+
+  /* Look for the row of the CFI table at PC computed for an earlier
+     frame.  */
+  dwarf2_frame_row_key row_key
+    = { fde, gdbarch, text_offset, pc,
+	entry_pc_p, entry_pc_p ? entry_pc : 0 };
+  comp_unit *unit = fde->cie->unit;
+  const dwarf2_frame_row *row = nullptr;
+
+  if (dwarf2_frame_cfi_cache_enabled)
     {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program
-	(fde, fde->instructions, fde->end, gdbarch, entry_pc, &fs,
-	 cache->per_objfile->objfile->text_section_offset ());
-
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  entry_cfa_sp_offset_p = 1;
-	}
+      check_cfi_cache_generation (unit);
+      auto it = unit->rows.find (row_key);
+      if (it != unit->rows.end ())
+	row = &it->second;
+    }
+
+  if (row != nullptr)
+    {
+      row_hits++;
+      fs.regs = row->regs;
+      fs.pc = row->pc;
+      fs.armcc_cfa_offsets_reversed = row->armcc_cfa_offsets_reversed;
+      entry_cfa_sp_offset_p = row->entry_cfa_sp_offset_p;
+      entry_cfa_sp_offset = row->entry_cfa_sp_offset;
     }
   else
-    instr = fde->instructions;
+    {
+      if (dwarf2_frame_cfi_cache_enabled)
+	row_misses++;
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
+      /* Check for "quirks" - known bugs in producers.  */
+      dwarf2_frame_find_quirks (&fs, fde);
+
+      /* First decode all the insns in the CIE.  */
+      execute_cie_program (fde, gdbarch, pc, &fs, text_offset);
+
+      /* Save the initialized register set.  */
+      fs.initial = fs.regs;
+
+      if (entry_pc_p)
+	{
+	  /* Decode the insns in the FDE up to the entry PC.  */
+	  instr = execute_cfa_program
+	    (fde, fde->instructions, fde->end, gdbarch, entry_pc, &fs,
+	     text_offset);
+
+	  if (fs.regs.cfa_how == CFA_REG_OFFSET
+	      && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+		  == gdbarch_sp_regnum (gdbarch)))
+	    {
+	      entry_cfa_sp_offset = fs.regs.cfa_offset;
+	      entry_cfa_sp_offset_p = 1;
+	    }
+	}
+      else
+	instr = fde->instructions;
+
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs,
+			   text_offset);
+
+      /* Remembered states are owned by the frame state, so rows that
+	 still have some are not cached.  */
+      if (dwarf2_frame_cfi_cache_enabled
+	  && fs.regs.prev == nullptr && fs.initial.prev == nullptr)
+	{
+	  if (unit->rows.size () >= dwarf2_frame_cfi_cache_max_size)
+	    unit->rows.clear ();
+	  unit->rows.emplace (row_key,
+			      dwarf2_frame_row { fs.regs, fs.pc,
+						 fs.armcc_cfa_offsets_reversed,
+						 entry_cfa_sp_offset_p != 0,
+						 entry_cfa_sp_offset });
+	}
+    }
 
   try
     {
@@ -1339,6 +1565,35 @@ dwarf2_frame_sniffer (const struct frame_unwind *self,
   return 1;
 }
 
+/* Implementation of frame_unwind::can_persist.  */
+
+static bool
+dwarf2_frame_can_persist (struct frame_info *this_frame, void *this_cache)
+{
+  struct dwarf2_frame_cache *cache = (struct dwarf2_frame_cache *) this_cache;
+
+  /* A tail call cache refers to the frames around THIS_FRAME.  */
+  return (cache != NULL
+	  && cache->tailcall_cache == NULL
+	  && !cache->unavailable_retaddr);
+}
+
+/* Implementation of frame_unwind::copy_cache.  */
+
+static void *
+dwarf2_frame_copy_cache (struct gdbarch *gdbarch, void *this_cache,
+			 struct obstack *obstack)
+{
+  struct dwarf2_frame_cache *cache = (struct dwarf2_frame_cache *) this_cache;
+  const int num_regs = gdbarch_num_cooked_regs (gdbarch);
+  struct dwarf2_frame_cache *copy = XOBNEW (obstack, struct dwarf2_frame_cache);
+
+  *copy = *cache;
+  copy->reg = XOBNEWVEC (obstack, struct dwarf2_frame_state_reg, num_regs);
+  std::copy (cache->reg, cache->reg + num_regs, copy->reg);
+  return copy;
+}
+
 static const struct frame_unwind dwarf2_frame_unwind =
 {
   "dwarf2",
@@ -1348,7 +1603,10 @@ static const struct frame_unwind dwarf2_frame_unwind =
   dwarf2_frame_prev_register,
   NULL,
   dwarf2_frame_sniffer,
-  dwarf2_frame_dealloc_cache
+  dwarf2_frame_dealloc_cache,
+  NULL,
+  dwarf2_frame_can_persist,
+  dwarf2_frame_copy_cache
 };
 
 static const struct frame_unwind dwarf2_signal_frame_unwind =
@@ -1628,6 +1886,37 @@ set_comp_unit (struct objfile *objfile, struct comp_unit *unit)
 static struct dwarf2_fde *
 dwarf2_frame_find_fde (CORE_ADDR *pc, dwarf2_per_objfile **out_per_objfile)
 {
+  fde_lookup_cache *cache = nullptr;
+  CORE_ADDR lookup_pc = *pc;
+
+  if (dwarf2_frame_cfi_cache_enabled)
+    {
+      cache = fde_lookup_cache_key.get (current_program_space);
+      if (cache == nullptr)
+	cache = fde_lookup_cache_key.emplace (current_program_space);
+      if (cache->generation != dwarf2_frame_cfi_cache_generation)
+	{
+	  cache->entries.clear ();
+	  cache->generation = dwarf2_frame_cfi_cache_generation;
+	}
+
+      /* A hit is only valid if the objfile was not relocated since.  */
+      auto it = cache->entries.find (lookup_pc);
+      if (it != cache->entries.end ()
+	  && (it->second.objfile->text_section_offset ()
+	      == it->second.text_offset))
+	{
+	  const fde_lookup_entry &entry = it->second;
+
+	  fde_lookup_hits++;
+	  *pc = entry.fde->initial_location + entry.text_offset;
+	  if (out_per_objfile != nullptr)
+	    *out_per_objfile = get_dwarf2_per_objfile (entry.objfile);
+	  return entry.fde;
+	}
+      fde_lookup_misses++;
+    }
+
   for (objfile *objfile : current_program_space->objfiles ())
     {
       CORE_ADDR offset;
@@ -1657,6 +1946,13 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, dwarf2_per_objfile **out_per_objfile)
 				    seek_pc, bsearch_fde_cmp);
       if (it != fde_table->end ())
 	{
+	  if (cache != nullptr)
+	    {
+	      if (cache->entries.size () >= dwarf2_frame_cfi_cache_max_size)
+		cache->entries.clear ();
+	      cache->entries[lookup_pc] = { *it, objfile, offset };
+	    }
+
 	  *pc = (*it)->initial_location + offset;
 	  if (out_per_objfile != nullptr)
 	    *out_per_objfile = get_dwarf2_per_objfile (objfile);
@@ -2265,6 +2561,69 @@ show_dwarf_unwinders_enabled_p (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* Mark the cached CFI data as stale.  */
+
+static void
+invalidate_cfi_caches ()
+{
+  dwarf2_frame_cfi_cache_generation++;
+}
+
+/* The new_objfile observer.  */
+
+static void
+dwarf2_frame_new_objfile (struct objfile *objfile)
+{
+  invalidate_cfi_caches ();
+}
+
+/* The free_objfile observer.  */
+
+static void
+dwarf2_frame_free_objfile (struct objfile *objfile)
+{
+  invalidate_cfi_caches ();
+}
+
+/* Handle 'maintenance show dwarf cfi-cache'.  */
+
+static void
+show_dwarf2_frame_cfi_cache_enabled (struct ui_file *file, int from_tty,
+				     struct cmd_list_element *c,
+				     const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether to cache DWARF call frame information "
+		      "is %s.\n"),
+		    value);
+}
+
+/* Implement "maint print dwarf-cfi-cache-statistics".  */
+
+static void
+maintenance_print_dwarf_cfi_cache_statistics (const char *args, int from_tty)
+{
+  printf_filtered (_("DWARF CFI cache statistics:\n"));
+  printf_filtered (_("  FDE lookup hits: %u\n"), fde_lookup_hits);
+  printf_filtered (_("  FDE lookup misses: %u\n"), fde_lookup_misses);
+  printf_filtered (_("  CIE rule hits: %u\n"), cie_rules_hits);
+  printf_filtered (_("  CIE rule misses: %u\n"), cie_rules_misses);
+  printf_filtered (_("  row hits: %u\n"), row_hits);
+  printf_filtered (_("  row misses: %u\n"), row_misses);
+}
+
+/* Implement "maint flush dwarf-cfi-cache".  */
+
+static void
+maintenance_flush_dwarf_cfi_cache (const char *args, int from_tty)
+{
+  invalidate_cfi_caches ();
+  fde_lookup_hits = fde_lookup_misses = 0;
+  cie_rules_hits = cie_rules_misses = 0;
+  row_hits = row_misses = 0;
+  printf_filtered (_("DWARF CFI cache flushed.\n"));
+}
+
 void _initialize_dwarf2_frame ();
 void
 _initialize_dwarf2_frame ()
@@ -2283,6 +2642,36 @@ architecture that doesn't support them will have no effect."),
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("cfi-cache", class_maintenance,
+			   &dwarf2_frame_cfi_cache_enabled, _("\
+Set whether to cache DWARF call frame information."), _("\
+Show whether to cache DWARF call frame information."), _("\
+When enabled, the FDE found for each PC, the register rules set up by\n\
+each CIE, and the rows of the CFI tables computed while unwinding are\n\
+kept and reused for later frames.  The caches are emptied when an\n\
+objfile is loaded or unloaded."),
+			   NULL,
+			   show_dwarf2_frame_cfi_cache_enabled,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_cmd ("dwarf-cfi-cache-statistics", class_maintenance,
+	   maintenance_print_dwarf_cfi_cache_statistics, _("\
+Print statistics about the DWARF CFI cache.\n\
+Print how many FDE lookups, CIE rule computations and CFI table rows\n\
+were found in the cache, and how many were computed."),
+	   &maintenanceprintlist);
+
+  add_cmd ("dwarf-cfi-cache", class_maintenance,
+	   maintenance_flush_dwarf_cfi_cache,
+	   _("Flush the DWARF CFI cache and reset its statistics."),
+	   &maintenanceflushlist);
+
+  gdb::observers::new_objfile.attach (dwarf2_frame_new_objfile,
+				      "dwarf2-frame");
+  gdb::observers::free_objfile.attach (dwarf2_frame_free_objfile,
+				       "dwarf2-frame");
+
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
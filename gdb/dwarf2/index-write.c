@@ -26,6 +26,7 @@
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/parallel-for.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
 #include "complaints.h"
@@ -45,6 +46,9 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 /* Ensure only legit values are used.  */
 #define DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE(cu_index, value) \
@@ -171,6 +175,8 @@ struct symtab_index_entry
 {
   /* The name of the symbol.  */
   const char *name;
+  /* mapped_index_string_hash of NAME.  */
+  offset_type hash;
   /* The offset of the name in the constant pool.  */
   offset_type index_offset;
   /* A sorted vector of the indices of all the CUs that hold an object
@@ -188,21 +194,18 @@ struct mapped_symtab
 
   offset_type n_elements = 0;
   std::vector<symtab_index_entry> data;
-
-  /* Temporary storage for Ada names.  */
-  auto_obstack m_string_obstack;
 };
 
-/* Find a slot in SYMTAB for the symbol NAME.  Returns a reference to
-   the slot.
+/* Find a slot in SYMTAB for the symbol NAME, whose
+   mapped_index_string_hash is HASH.  Returns a reference to the slot.
 
    Function is used only during write_hash_table so no index format backward
    compatibility is needed.  */
 
 static symtab_index_entry &
-find_slot (struct mapped_symtab *symtab, const char *name)
+find_slot (struct mapped_symtab *symtab, const char *name, offset_type hash)
 {
-  offset_type index, step, hash = mapped_index_string_hash (INT_MAX, name);
+  offset_type index, step;
 
   index = hash & (symtab->data.size () - 1);
   step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
@@ -229,65 +232,11 @@ hash_expand (struct mapped_symtab *symtab)
   for (auto &it : old_entries)
     if (it.name != NULL)
       {
-	auto &ref = find_slot (symtab, it.name);
+	auto &ref = find_slot (symtab, it.name, it.hash);
 	ref = std::move (it);
       }
 }
 
-/* Add an entry to SYMTAB.  NAME is the name of the symbol.
-   CU_INDEX is the index of the CU in which the symbol appears.
-   IS_STATIC is one if the symbol is static, otherwise zero (global).  */
-
-static void
-add_index_entry (struct mapped_symtab *symtab, const char *name,
-		 int is_static, gdb_index_symbol_kind kind,
-		 offset_type cu_index)
-{
-  offset_type cu_index_and_attrs;
-
-  ++symtab->n_elements;
-  if (4 * symtab->n_elements / 3 >= symtab->data.size ())
-    hash_expand (symtab);
-
-  symtab_index_entry &slot = find_slot (symtab, name);
-  if (slot.name == NULL)
-    {
-      slot.name = name;
-      /* index_offset is set later.  */
-    }
-
-  cu_index_and_attrs = 0;
-  DW2_GDB_INDEX_CU_SET_VALUE (cu_index_and_attrs, cu_index);
-  DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE (cu_index_and_attrs, is_static);
-  DW2_GDB_INDEX_SYMBOL_KIND_SET_VALUE (cu_index_and_attrs, kind);
-
-  /* We don't want to record an index value twice as we want to avoid the
-     duplication.
-     We process all global symbols and then all static symbols
-     (which would allow us to avoid the duplication by only having to check
-     the last entry pushed), but a symbol could have multiple kinds in one CU.
-     To keep things simple we don't worry about the duplication here and
-     sort and uniquify the list after we've processed all symbols.  */
-  slot.cu_indices.push_back (cu_index_and_attrs);
-}
-
-/* Sort and remove duplicates of all symbols' cu_indices lists.  */
-
-static void
-uniquify_cu_indices (struct mapped_symtab *symtab)
-{
-  for (auto &entry : symtab->data)
-    {
-      if (entry.name != NULL && !entry.cu_indices.empty ())
-	{
-	  auto &cu_indices = entry.cu_indices;
-	  std::sort (cu_indices.begin (), cu_indices.end ());
-	  auto from = std::unique (cu_indices.begin (), cu_indices.end ());
-	  cu_indices.erase (from, cu_indices.end ());
-	}
-    }
-}
-
 /* A form of 'const char *' suitable for container keys.  Only the
    pointer is stored.  The strings themselves are compared, not the
    pointers.  */
@@ -530,14 +479,286 @@ symbol_kind (struct partial_symbol *psym)
     }
 }
 
-/* Add a list of partial symbols to SYMTAB.  */
+/* Recurse into all "included" dependencies and count their symbols as
+   if they appeared in this psymtab.  */
 
 static void
-write_psymbols (struct mapped_symtab *symtab,
-		std::unordered_set<partial_symbol *> &psyms_seen,
-		const std::vector<partial_symbol *> &symbols,
-		offset_type cu_index,
-		int is_static)
+recursively_count_psymbols (partial_symtab *psymtab,
+			    size_t &psyms_seen)
+{
+  for (int i = 0; i < psymtab->number_of_dependencies; ++i)
+    if (psymtab->dependencies[i]->user != NULL)
+      recursively_count_psymbols (psymtab->dependencies[i],
+				  psyms_seen);
+
+  psyms_seen += psymtab->global_psymbols.size ();
+  psyms_seen += psymtab->static_psymbols.size ();
+}
+
+/* An entry of a partial symbol in an index.  */
+
+struct index_symbol
+{
+  index_symbol (const char *name_, partial_symbol *psym_,
+		offset_type cu_index_, bool is_static_, bool ada_main_,
+		bool once_)
+    : name (name_), psym (psym_),
+      hash (mapped_index_string_hash (INT_MAX, name_)),
+      cu_index (cu_index_), is_static (is_static_), ada_main (ada_main_),
+      once (once_)
+  {}
+
+  /* The name under which the symbol is entered.  */
+  const char *name;
+
+  /* The partial symbol.  */
+  partial_symbol *psym;
+
+  /* mapped_index_string_hash of NAME.  */
+  offset_type hash;
+
+  /* The index of the CU in the index being written.  */
+  offset_type cu_index;
+
+  /* True if the symbol is static, false if it is global.  */
+  bool is_static;
+
+  /* True if this is the extra entry of the Ada main function under
+     its verbatim name.  */
+  bool ada_main;
+
+  /* True if this entry is only to be entered if it comes from the
+     first visit of PSYM; a psymtab can be included by several
+     CUs.  */
+  bool once;
+
+  /* Set by index_symbols::group: true if the entry was entered.  */
+  bool entered = false;
+
+  /* Set by index_symbols::group: if this entry is the first one that
+     was entered under NAME, the index of the name in its shard,
+     otherwise -1.  */
+  int name_index = -1;
+};
+
+/* A name in an index, along with the values entered under it.  */
+
+template<typename Values>
+struct index_name
+{
+  index_name (const char *name_, offset_type hash_)
+    : name (name_), hash (hash_)
+  {}
+
+  const char *name;
+  offset_type hash;
+  Values values;
+};
+
+/* The entries of the partial symbols of an objfile in an index.
+
+   Visiting all the partial symbols of a big program and grouping them
+   by name takes most of the time of writing an index, so it is done
+   in three steps, so that the bulk of the work can be done in
+   parallel while the result only depends on the order of the CUs:
+
+   - The entries of each CU are collected, CUs in parallel.
+
+   - The entries are grouped by name in shards, according to the hash
+     of the name, the shards in parallel.  All the entries of a name,
+     and so all the entries of a partial symbol, land in the same
+     shard.  Each shard scans its entries in the order of the CUs, so
+     it knows which visit of a partial symbol comes first, and which
+     entry first entered a name, exactly as a serial scan would.
+
+   - The writer walks the entries in the order of the CUs and picks
+     each name up where it was first entered, see
+     add_index_symbols and debug_names::insert.  */
+
+class index_symbols
+{
+public:
+  /* Collect the entries of all the psymtabs of PER_OBJFILE.
+     CU_INDICES gives the index in the index being written of each unit
+     of all_comp_units.  If ADA_MAIN_ONCE, the extra entry of the Ada
+     main function is only entered for the first visit of its partial
+     symbol, like the other entries.  */
+  index_symbols (dwarf2_per_objfile *per_objfile,
+		 const std::vector<offset_type> &cu_indices,
+		 bool ada_main_once);
+
+  DISABLE_COPY_AND_ASSIGN (index_symbols);
+
+  /* The number of shards.  */
+  static const unsigned n_shards = 64;
+
+  /* Group the entries by name into SHARDS, which is resized to
+     n_shards.  ENTER is called for each entry that is to be entered,
+     with the values of the entry's name; it returns false if the
+     entry is to be ignored after all.  */
+  template<typename Values>
+  void group (std::vector<std::vector<index_name<Values>>> &shards,
+	      gdb::function_view<bool (Values &, const index_symbol &)> enter);
+
+  /* Call CALLBACK for each entry, in the order of the CUs.  */
+  template<typename Callback>
+  void iterate (Callback callback) const
+  {
+    for (const cu_symbols &cu : m_cus)
+      for (const index_symbol &sym : cu.symbols)
+	callback (sym);
+  }
+
+private:
+  /* The entries of one CU.  */
+  struct cu_symbols
+  {
+    /* The entries, in the order a serial scan would visit them.  */
+    std::vector<index_symbol> symbols;
+
+    /* The indices of SYMBOLS, stably ordered by shard.  The entries of
+       shard I are at SHARD_START[I] up to SHARD_START[I + 1].  */
+    std::vector<unsigned> by_shard;
+    unsigned shard_start[n_shards + 1];
+  };
+
+  /* A name in a shard being grouped.  */
+  struct name_key
+  {
+    const char *name;
+    offset_type hash;
+
+    bool operator== (const name_key &other) const
+    {
+      return hash == other.hash && strcmp (name, other.name) == 0;
+    }
+  };
+
+  struct name_key_hasher
+  {
+    size_t operator() (const name_key &key) const
+    {
+      return key.hash;
+    }
+  };
+
+  void collect_psymtab (std::vector<index_symbol> &result,
+			partial_symtab *psymtab, offset_type cu_index,
+			bool ada_main_once);
+  void collect_psymbols (std::vector<index_symbol> &result,
+			 const std::vector<partial_symbol *> &symbols,
+			 offset_type cu_index, bool is_static,
+			 bool ada_main_once);
+  const char *ada_index_name (const char *name);
+
+  /* The entries of each unit, in the order of all_comp_units.  */
+  std::vector<cu_symbols> m_cus;
+
+  /* The name of the main function.  It is looked up beforehand, as
+     main_name must not be called from worker threads.  */
+  const char *m_main_name;
+
+  /* Storage for Ada names.  The Ada name functions use static
+     buffers, so they are called under M_ADA_MUTEX, which also protects
+     the obstack.  */
+  auto_obstack m_string_obstack;
+#if CXX_STD_THREAD
+  std::mutex m_ada_mutex;
+#endif
+};
+
+index_symbols::index_symbols (dwarf2_per_objfile *per_objfile,
+			      const std::vector<offset_type> &cu_indices,
+			      bool ada_main_once)
+  : m_main_name (main_name ())
+{
+  const auto &all_comp_units = per_objfile->per_bfd->all_comp_units;
+  gdb_assert (cu_indices.size () == all_comp_units.size ());
+
+  m_cus.resize (all_comp_units.size ());
+
+  /* The psymtab of each unit whose entries are collected.  */
+  std::vector<partial_symtab *> psymtabs (all_comp_units.size ());
+  for (size_t i = 0; i < all_comp_units.size (); ++i)
+    {
+      partial_symtab *psymtab = all_comp_units[i]->v.psymtab;
+      if (psymtab != nullptr && psymtab->user == nullptr)
+	psymtabs[i] = psymtab;
+    }
+
+  gdb::parallel_for_each
+    (m_cus.begin (), m_cus.end (),
+     [&] (std::vector<cu_symbols>::iterator first,
+	  std::vector<cu_symbols>::iterator last)
+     {
+       for (auto iter = first; iter != last; ++iter)
+	 {
+	   size_t i = iter - m_cus.begin ();
+	   cu_symbols &cu = *iter;
+
+	   if (psymtabs[i] != nullptr)
+	     collect_psymtab (cu.symbols, psymtabs[i], cu_indices[i],
+			      ada_main_once);
+
+	   /* Sort the entries by shard.  */
+	   unsigned counts[n_shards] = {};
+	   for (const index_symbol &sym : cu.symbols)
+	     ++counts[sym.hash % n_shards];
+	   cu.shard_start[0] = 0;
+	   for (unsigned shard = 0; shard < n_shards; ++shard)
+	     cu.shard_start[shard + 1] = cu.shard_start[shard] + counts[shard];
+	   cu.by_shard.resize (cu.symbols.size ());
+	   unsigned next[n_shards];
+	   std::copy (cu.shard_start, cu.shard_start + n_shards, next);
+	   for (unsigned j = 0; j < cu.symbols.size (); ++j)
+	     cu.by_shard[next[cu.symbols[j].hash % n_shards]++] = j;
+	 }
+     },
+     [&] (std::vector<cu_symbols>::iterator iter)
+     {
+       size_t count = 0;
+       partial_symtab *psymtab = psymtabs[iter - m_cus.begin ()];
+       if (psymtab != nullptr)
+	 recursively_count_psymbols (psymtab, count);
+       return count + 1;
+     });
+}
+
+/* Return the name under which the Ada symbol NAME is entered in the
+   index.  */
+
+const char *
+index_symbols::ada_index_name (const char *name)
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_ada_mutex);
+#endif
+
+  /* In order for the index to work when read back into gdb, it has to
+     supply a funny form of the name: it should be the encoded name,
+     with any suffixes stripped.  Using the ordinary encoded name will
+     not work properly with the searching logic in
+     find_name_components_bounds; nor will using the decoded name.
+     Furthermore, an Ada "verbatim" name (of the form "<MumBle>") must
+     be entered without the angle brackets.  Note that the current
+     index is unusual, see PR symtab/24820 for details.  */
+  std::string decoded = ada_decode (name);
+  if (decoded[0] == '<')
+    return (char *) obstack_copy0 (&m_string_obstack,
+				   decoded.c_str () + 1,
+				   decoded.length () - 2);
+  else
+    return obstack_strdup (&m_string_obstack,
+			   ada_encode (decoded.c_str ()));
+}
+
+/* Append the entries of SYMBOLS to RESULT.  */
+
+void
+index_symbols::collect_psymbols (std::vector<index_symbol> &result,
+				 const std::vector<partial_symbol *> &symbols,
+				 offset_type cu_index, bool is_static,
+				 bool ada_main_once)
 {
   for (partial_symbol *psym : symbols)
     {
@@ -550,82 +771,166 @@ write_psymbols (struct mapped_symtab *symtab,
 	     form "_ada_mumble", and will be rewritten by ada_decode.
 	     So, recognize it specially here and add it to the index by
 	     hand.  */
-	  if (strcmp (main_name (), name) == 0)
-	    {
-	      gdb_index_symbol_kind kind = symbol_kind (psym);
+	  if (strcmp (m_main_name, name) == 0)
+	    result.emplace_back (name, psym, cu_index, is_static, true,
+				 ada_main_once);
 
-	      add_index_entry (symtab, name, is_static, kind, cu_index);
-	    }
-
-	  /* In order for the index to work when read back into gdb, it
-	     has to supply a funny form of the name: it should be the
-	     encoded name, with any suffixes stripped.  Using the
-	     ordinary encoded name will not work properly with the
-	     searching logic in find_name_components_bounds; nor will
-	     using the decoded name.  Furthermore, an Ada "verbatim"
-	     name (of the form "<MumBle>") must be entered without the
-	     angle brackets.  Note that the current index is unusual,
-	     see PR symtab/24820 for details.  */
-	  std::string decoded = ada_decode (name);
-	  if (decoded[0] == '<')
-	    name = (char *) obstack_copy0 (&symtab->m_string_obstack,
-					   decoded.c_str () + 1,
-					   decoded.length () - 2);
-	  else
-	    name = obstack_strdup (&symtab->m_string_obstack,
-				   ada_encode (decoded.c_str ()));
+	  name = ada_index_name (name);
 	}
 
-      /* Only add a given psymbol once.  */
-      if (psyms_seen.insert (psym).second)
-	{
-	  gdb_index_symbol_kind kind = symbol_kind (psym);
-
-	  add_index_entry (symtab, name, is_static, kind, cu_index);
-	}
+      result.emplace_back (name, psym, cu_index, is_static, false, true);
     }
 }
 
-/* Recurse into all "included" dependencies and count their symbols as
-   if they appeared in this psymtab.  */
+/* Recurse into all "included" dependencies and collect their symbols
+   as if they appeared in this psymtab.  */
 
-static void
-recursively_count_psymbols (partial_symtab *psymtab,
-			    size_t &psyms_seen)
+void
+index_symbols::collect_psymtab (std::vector<index_symbol> &result,
+				partial_symtab *psymtab, offset_type cu_index,
+				bool ada_main_once)
 {
   for (int i = 0; i < psymtab->number_of_dependencies; ++i)
     if (psymtab->dependencies[i]->user != NULL)
-      recursively_count_psymbols (psymtab->dependencies[i],
-				  psyms_seen);
+      collect_psymtab (result, psymtab->dependencies[i], cu_index,
+		       ada_main_once);
 
-  psyms_seen += psymtab->global_psymbols.size ();
-  psyms_seen += psymtab->static_psymbols.size ();
+  collect_psymbols (result, psymtab->global_psymbols, cu_index, false,
+		    ada_main_once);
+  collect_psymbols (result, psymtab->static_psymbols, cu_index, true,
+		    ada_main_once);
 }
 
-/* Recurse into all "included" dependencies and write their symbols as
-   if they appeared in this psymtab.  */
+template<typename Values>
+void
+index_symbols::group
+  (std::vector<std::vector<index_name<Values>>> &shards,
+   gdb::function_view<bool (Values &, const index_symbol &)> enter)
+{
+  shards.clear ();
+  shards.resize (n_shards);
+
+  gdb::parallel_for_each
+    (shards.begin (), shards.end (),
+     [&] (typename std::vector<std::vector<index_name<Values>>>::iterator first,
+	  typename std::vector<std::vector<index_name<Values>>>::iterator last)
+     {
+       for (auto iter = first; iter != last; ++iter)
+	 {
+	   unsigned shard = iter - shards.begin ();
+	   std::vector<index_name<Values>> &names = *iter;
+
+	   std::unordered_map<name_key, int, name_key_hasher> name_indices;
+	   std::unordered_set<partial_symbol *> psyms_seen;
+	   std::unordered_set<partial_symbol *> ada_mains_seen;
+
+	   for (cu_symbols &cu : m_cus)
+	     for (unsigned j = cu.shard_start[shard];
+		  j < cu.shard_start[shard + 1];
+		  ++j)
+	       {
+		 index_symbol &sym = cu.symbols[cu.by_shard[j]];
+
+		 /* Only add a given psymbol once.  */
+		 if (sym.once
+		     && !(sym.ada_main ? ada_mains_seen : psyms_seen)
+			   .insert (sym.psym).second)
+		   continue;
+
+		 const auto insertpair
+		   = name_indices.emplace (name_key { sym.name, sym.hash },
+					   names.size ());
+		 if (insertpair.second)
+		   names.emplace_back (sym.name, sym.hash);
+
+		 if (!enter (names[insertpair.first->second].values, sym))
+		   {
+		     if (insertpair.second)
+		       {
+			 names.pop_back ();
+			 name_indices.erase (insertpair.first);
+		       }
+		     continue;
+		   }
+
+		 sym.entered = true;
+		 if (insertpair.second)
+		   sym.name_index = insertpair.first->second;
+	       }
+	 }
+     });
+}
+
+/* Add the entries of SYMBOLS to SYMTAB.  */
 
 static void
-recursively_write_psymbols (struct objfile *objfile,
-			    partial_symtab *psymtab,
-			    struct mapped_symtab *symtab,
-			    std::unordered_set<partial_symbol *> &psyms_seen,
-			    offset_type cu_index)
+add_index_symbols (struct mapped_symtab *symtab, index_symbols &symbols)
 {
-  int i;
+  std::vector<std::vector<index_name<std::vector<offset_type>>>> shards;
+  symbols.group<std::vector<offset_type>>
+    (shards, [] (std::vector<offset_type> &cu_indices,
+		 const index_symbol &sym)
+     {
+       offset_type cu_index_and_attrs = 0;
+       DW2_GDB_INDEX_CU_SET_VALUE (cu_index_and_attrs, sym.cu_index);
+       DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE (cu_index_and_attrs,
+					      sym.is_static);
+       DW2_GDB_INDEX_SYMBOL_KIND_SET_VALUE (cu_index_and_attrs,
+					    symbol_kind (sym.psym));
+
+       /* We don't want to record an index value twice as we want to
+	  avoid the duplication.  A symbol could have multiple kinds in
+	  one CU, so to keep things simple we don't worry about the
+	  duplication here and sort and uniquify the list once all the
+	  symbols are grouped.  */
+       cu_indices.push_back (cu_index_and_attrs);
+       return true;
+     });
+
+  /* Now that we've processed all symbols we can shrink their
+     cu_indices lists.  */
+  gdb::parallel_for_each
+    (shards.begin (), shards.end (),
+     [] (std::vector<std::vector<index_name<std::vector<offset_type>>>>
+	   ::iterator first,
+	 std::vector<std::vector<index_name<std::vector<offset_type>>>>
+	   ::iterator last)
+     {
+       for (auto iter = first; iter != last; ++iter)
+	 for (index_name<std::vector<offset_type>> &name : *iter)
+	   {
+	     auto &cu_indices = name.values;
+	     std::sort (cu_indices.begin (), cu_indices.end ());
+	     auto from = std::unique (cu_indices.begin (), cu_indices.end ());
+	     cu_indices.erase (from, cu_indices.end ());
+	   }
+     });
+
+  /* The layout of the hash table depends on the order in which the
+     names are inserted, and on when it is expanded, which depends on
+     the number of entries seen so far.  Replay both in the order of
+     the CUs, so that the table does not depend on the grouping.  */
+  symbols.iterate ([&] (const index_symbol &sym)
+    {
+      if (!sym.entered)
+	return;
 
-  for (i = 0; i < psymtab->number_of_dependencies; ++i)
-    if (psymtab->dependencies[i]->user != NULL)
-      recursively_write_psymbols (objfile,
-				  psymtab->dependencies[i],
-				  symtab, psyms_seen, cu_index);
-
-  write_psymbols (symtab, psyms_seen,
-		  psymtab->global_psymbols, cu_index,
-		  0);
-  write_psymbols (symtab, psyms_seen,
-		  psymtab->static_psymbols, cu_index,
-		  1);
+      ++symtab->n_elements;
+      if (4 * symtab->n_elements / 3 >= symtab->data.size ())
+	hash_expand (symtab);
+
+      if (sym.name_index < 0)
+	return;
+
+      index_name<std::vector<offset_type>> &name
+	= shards[sym.hash % index_symbols::n_shards][sym.name_index];
+      symtab_index_entry &slot = find_slot (symtab, name.name, name.hash);
+      gdb_assert (slot.name == NULL);
+      slot.name = name.name;
+      slot.hash = name.hash;
+      /* index_offset is set later.  */
+      slot.cu_indices = std::move (name.values);
+    });
 }
 
 /* DWARF-5 .debug_names builder.  */
@@ -654,56 +959,34 @@ class debug_names
   /* Is this symbol from DW_TAG_compile_unit or DW_TAG_type_unit?  */
   enum class unit_kind { cu, tu };
 
-  /* Insert one symbol.  */
-  void insert (const partial_symbol *psym, int cu_index, bool is_static,
-	       unit_kind kind)
+  /* Insert the entries of SYMBOLS.  */
+  void insert (index_symbols &symbols)
   {
-    const int dwarf_tag = psymbol_tag (psym);
-    if (dwarf_tag == 0)
-      return;
-    const char *name = psym->ginfo.search_name ();
-
-    if (psym->ginfo.language () == language_ada)
+    std::vector<std::vector<index_name<std::set<symbol_value>>>> shards;
+    symbols.group<std::set<symbol_value>>
+      (shards, [] (std::set<symbol_value> &value_set,
+		   const index_symbol &sym)
+       {
+	 const int dwarf_tag = psymbol_tag (sym.psym);
+	 if (dwarf_tag == 0)
+	   return false;
+	 value_set.emplace (symbol_value (dwarf_tag, sym.cu_index,
+					  sym.is_static, unit_kind::cu));
+	 return true;
+       });
+
+    /* Insert the names in the order they were first entered, so that
+       the table does not depend on the grouping.  */
+    symbols.iterate ([&] (const index_symbol &sym)
       {
-	/* We want to ensure that the Ada main function's name appears
-	   verbatim in the index.  However, this name will be of the
-	   form "_ada_mumble", and will be rewritten by ada_decode.
-	   So, recognize it specially here and add it to the index by
-	   hand.  */
-	if (strcmp (main_name (), name) == 0)
-	  {
-	    const auto insertpair
-	      = m_name_to_value_set.emplace (c_str_view (name),
-					     std::set<symbol_value> ());
-	    std::set<symbol_value> &value_set = insertpair.first->second;
-	    value_set.emplace (symbol_value (dwarf_tag, cu_index, is_static,
-					     kind));
-	  }
-
-	/* In order for the index to work when read back into gdb, it
-	   has to supply a funny form of the name: it should be the
-	   encoded name, with any suffixes stripped.  Using the
-	   ordinary encoded name will not work properly with the
-	   searching logic in find_name_components_bounds; nor will
-	   using the decoded name.  Furthermore, an Ada "verbatim"
-	   name (of the form "<MumBle>") must be entered without the
-	   angle brackets.  Note that the current index is unusual,
-	   see PR symtab/24820 for details.  */
-	std::string decoded = ada_decode (name);
-	if (decoded[0] == '<')
-	  name = (char *) obstack_copy0 (&m_string_obstack,
-					 decoded.c_str () + 1,
-					 decoded.length () - 2);
-	else
-	  name = obstack_strdup (&m_string_obstack,
-				 ada_encode (decoded.c_str ()));
-      }
-
-    const auto insertpair
-      = m_name_to_value_set.emplace (c_str_view (name),
-				     std::set<symbol_value> ());
-    std::set<symbol_value> &value_set = insertpair.first->second;
-    value_set.emplace (symbol_value (dwarf_tag, cu_index, is_static, kind));
+	if (sym.name_index < 0)
+	  return;
+
+	index_name<std::set<symbol_value>> &name
+	  = shards[sym.hash % index_symbols::n_shards][sym.name_index];
+	m_name_to_value_set.emplace (c_str_view (name.name),
+				     std::move (name.values));
+      });
   }
 
   /* Build all the tables.  All symbols must be already inserted.
@@ -837,25 +1120,6 @@ class debug_names
     return m_abbrev_table.size ();
   }
 
-  /* Recurse into all "included" dependencies and store their symbols
-     as if they appeared in this psymtab.  */
-  void recursively_write_psymbols
-    (struct objfile *objfile,
-     partial_symtab *psymtab,
-     std::unordered_set<partial_symbol *> &psyms_seen,
-     int cu_index)
-  {
-    for (int i = 0; i < psymtab->number_of_dependencies; ++i)
-      if (psymtab->dependencies[i]->user != NULL)
-	recursively_write_psymbols
-	  (objfile, psymtab->dependencies[i], psyms_seen, cu_index);
-
-    write_psymbols (psyms_seen, psymtab->global_psymbols,
-		    cu_index, false, unit_kind::cu);
-    write_psymbols (psyms_seen, psymtab->static_psymbols,
-		    cu_index, true, unit_kind::cu);
-  }
-
   /* Return number of bytes the .debug_names section will have.  This
      must be called only after calling the build method.  */
   size_t bytes () const
@@ -1157,19 +1421,6 @@ class debug_names
       }
   }
 
-  /* Call insert for all partial symbols and mark them in PSYMS_SEEN.  */
-  void write_psymbols (std::unordered_set<partial_symbol *> &psyms_seen,
-		       const std::vector<partial_symbol *> &symbols,
-		       int cu_index, bool is_static, unit_kind kind)
-  {
-    for (partial_symbol *psym : symbols)
-      {
-	/* Only add a given psymbol once.  */
-	if (psyms_seen.insert (psym).second)
-	  insert (psym, cu_index, is_static, kind);
-      }
-  }
-
   /* Store value of each symbol.  */
   std::unordered_map<c_str_view, std::set<symbol_value>, c_str_view_hasher>
     m_name_to_value_set;
@@ -1199,9 +1450,6 @@ class debug_names
 
   /* .debug_names entry pool.  */
   data_buf m_entry_pool;
-
-  /* Temporary storage for Ada names.  */
-  auto_obstack m_string_obstack;
 };
 
 /* Return iff any of the needed offsets does not fit into 32-bit
@@ -1219,28 +1467,6 @@ check_dwarf64_offsets (dwarf2_per_objfile *per_objfile)
   return false;
 }
 
-/* The psyms_seen set is potentially going to be largish (~40k
-   elements when indexing a -g3 build of GDB itself).  Estimate the
-   number of elements in order to avoid too many rehashes, which
-   require rebuilding buckets and thus many trips to
-   malloc/free.  */
-
-static size_t
-psyms_seen_size (dwarf2_per_objfile *per_objfile)
-{
-  size_t psyms_count = 0;
-  for (const auto &per_cu : per_objfile->per_bfd->all_comp_units)
-    {
-      partial_symtab *psymtab = per_cu->v.psymtab;
-
-      if (psymtab != NULL && psymtab->user == NULL)
-	recursively_count_psymbols (psymtab, psyms_count);
-    }
-  /* Generating an index for gdb itself shows a ratio of
-     TOTAL_SEEN_SYMS/UNIQUE_SYMS or ~5.  4 seems like a good bet.  */
-  return psyms_count / 4;
-}
-
 /* Assert that FILE's size is EXPECTED_SIZE.  Assumes file's seek
    position is at the end of the file.  */
 
@@ -1312,7 +1538,6 @@ static void
 write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
 		FILE *dwz_out_file)
 {
-  struct objfile *objfile = per_objfile->objfile;
   mapped_symtab symtab;
   data_buf objfile_cu_list;
   data_buf dwz_cu_list;
@@ -1331,8 +1556,8 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
      work here.  Also, the debug_types entries do not appear in
      all_comp_units, but only in their own hash table.  */
 
-  std::unordered_set<partial_symbol *> psyms_seen
-    (psyms_seen_size (per_objfile));
+  std::vector<offset_type> cu_indices
+    (per_objfile->per_bfd->all_comp_units.size ());
   int counter = 0;
   int types_counter = 0;
   for (int i = 0; i < per_objfile->per_bfd->all_comp_units.size (); ++i)
@@ -1342,13 +1567,10 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
       partial_symtab *psymtab = per_cu->v.psymtab;
 
       int &this_counter = per_cu->is_debug_types ? types_counter : counter;
+      cu_indices[i] = this_counter;
 
       if (psymtab != NULL)
 	{
-	  if (psymtab->user == NULL)
-	    recursively_write_psymbols (objfile, psymtab, &symtab,
-					psyms_seen, this_counter);
-
 	  const auto insertpair = cu_index_htab.emplace (psymtab,
 							 this_counter);
 	  gdb_assert (insertpair.second);
@@ -1376,14 +1598,14 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
       ++this_counter;
     }
 
+  /* Enter the symbols.  */
+  index_symbols symbols (per_objfile, cu_indices, false);
+  add_index_symbols (&symtab, symbols);
+
   /* Dump the address map.  */
   data_buf addr_vec;
   write_address_map (per_objfile->per_bfd, addr_vec, cu_index_htab);
 
-  /* Now that we've processed all symbols we can shrink their cu_indices
-     lists.  */
-  uniquify_cu_indices (&symtab);
-
   data_buf symtab_vec, constant_pool;
   if (symtab.n_elements == 0)
     symtab.data.resize (0);
@@ -1421,22 +1643,19 @@ write_debug_names (dwarf2_per_objfile *per_objfile,
   data_buf cu_list;
   data_buf types_cu_list;
   debug_names nametable (per_objfile, dwarf5_is_dwarf64, dwarf5_byte_order);
-  std::unordered_set<partial_symbol *>
-    psyms_seen (psyms_seen_size (per_objfile));
+  std::vector<offset_type> cu_indices
+    (per_objfile->per_bfd->all_comp_units.size ());
   int counter = 0;
   int types_counter = 0;
   for (int i = 0; i < per_objfile->per_bfd->all_comp_units.size (); ++i)
     {
       const dwarf2_per_cu_data *per_cu
 	= per_objfile->per_bfd->all_comp_units[i].get ();
-      partial_symtab *psymtab = per_cu->v.psymtab;
 
       int &this_counter = per_cu->is_debug_types ? types_counter : counter;
       data_buf &this_list = per_cu->is_debug_types ? types_cu_list : cu_list;
 
-      if (psymtab != nullptr && psymtab->user == nullptr)
-	nametable.recursively_write_psymbols (objfile, psymtab, psyms_seen,
-					      this_counter);
+      cu_indices[i] = this_counter;
 
       this_list.append_uint (nametable.dwarf5_offset_size (),
 			     dwarf5_byte_order,
@@ -1449,6 +1668,9 @@ write_debug_names (dwarf2_per_objfile *per_objfile,
 			  - per_objfile->per_bfd->tu_stats.nr_tus));
   gdb_assert (types_counter == per_objfile->per_bfd->tu_stats.nr_tus);
 
+  /* NAMETABLE refers to the names of SYMBOLS until it is written.  */
+  index_symbols symbols (per_objfile, cu_indices, true);
+  nametable.insert (symbols);
   nametable.build ();
 
   /* No addr_vec - DWARF-5 uses .debug_aranges generated by GCC.  */
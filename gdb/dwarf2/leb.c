@@ -27,15 +27,30 @@
 #include "defs.h"
 #include "dwarf2/leb.h"
 
+/* See leb.h.  */
+
 ULONGEST
-read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
-			  unsigned int *bytes_read_ptr)
+read_unsigned_leb128_slow (bfd *abfd, const gdb_byte *buf,
+			   unsigned int *bytes_read_ptr)
 {
   ULONGEST result;
   unsigned int num_read;
   int shift;
   unsigned char byte;
 
+  /* After one-byte numbers, which read_unsigned_leb128 handles
+     inline, two-byte numbers are the most common, e.g. abbrev numbers
+     and attribute values between 128 and 16383.  */
+  if ((bfd_get_8 (abfd, buf) & 128) != 0)
+    {
+      byte = bfd_get_8 (abfd, buf + 1);
+      if ((byte & 128) == 0)
+	{
+	  *bytes_read_ptr = 2;
+	  return ((ULONGEST) byte << 7) | (bfd_get_8 (abfd, buf) & 127);
+	}
+    }
+
   result = 0;
   shift = 0;
   num_read = 0;
@@ -44,7 +59,8 @@ read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
       byte = bfd_get_8 (abfd, buf);
       buf++;
       num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
+      if (shift < 8 * sizeof (result))
+	result |= ((ULONGEST) (byte & 127) << shift);
       if ((byte & 128) == 0)
 	{
 	  break;
@@ -55,9 +71,11 @@ read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
   return result;
 }
 
+/* See leb.h.  */
+
 LONGEST
-read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
-		    unsigned int *bytes_read_ptr)
+read_signed_leb128_slow (bfd *abfd, const gdb_byte *buf,
+			 unsigned int *bytes_read_ptr)
 {
   ULONGEST result;
   int shift, num_read;
@@ -71,7 +89,8 @@ read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
       byte = bfd_get_8 (abfd, buf);
       buf++;
       num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
+      if (shift < 8 * sizeof (result))
+	result |= ((ULONGEST) (byte & 127) << shift);
       shift += 7;
       if ((byte & 128) == 0)
 	{
@@ -78,9 +78,49 @@ read_8_bytes (bfd *abfd, const gdb_byte *buf)
   return bfd_get_64 (abfd, buf);
 }
 
-extern LONGEST read_signed_leb128 (bfd *, const gdb_byte *, unsigned int *);
+/* Out-of-line parts of read_signed_leb128 and read_unsigned_leb128,
+   handling values of any length.  */
 
-extern ULONGEST read_unsigned_leb128 (bfd *, const gdb_byte *, unsigned int *);
+extern LONGEST read_signed_leb128_slow (bfd *, const gdb_byte *,
+					unsigned int *);
+
+extern ULONGEST read_unsigned_leb128_slow (bfd *, const gdb_byte *,
+					   unsigned int *);
+
+/* Read a signed LEB128 number from BUF, and store the number of bytes
+   it occupies in *BYTES_READ_PTR.  Most of the LEB128 numbers in DWARF
+   fit in a single byte, so that case is handled inline.  */
+
+static inline LONGEST
+read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
+		    unsigned int *bytes_read_ptr)
+{
+  unsigned int byte = bfd_get_8 (abfd, buf);
+
+  if ((byte & 0x80) == 0)
+    {
+      *bytes_read_ptr = 1;
+      /* Sign-extend from bit 6.  */
+      return (LONGEST) (byte ^ 0x40) - 0x40;
+    }
+  return read_signed_leb128_slow (abfd, buf, bytes_read_ptr);
+}
+
+/* Likewise, for an unsigned LEB128 number.  */
+
+static inline ULONGEST
+read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
+		      unsigned int *bytes_read_ptr)
+{
+  unsigned int byte = bfd_get_8 (abfd, buf);
+
+  if ((byte & 0x80) == 0)
+    {
+      *bytes_read_ptr = 1;
+      return byte;
+    }
+  return read_unsigned_leb128_slow (abfd, buf, bytes_read_ptr);
+}
 
 /* Read the initial length from a section.  The (draft) DWARF 3
    specification allows the initial length to take up either 4 bytes
@@ -90,7 +90,13 @@
 #include "rust-lang.h"
 #include "gdbsupport/pathstuff.h"
 #include "count-one-bits.h"
+#include "demangle-cache.h"
 #include <unordered_set>
+#include "gdbsupport/parallel-for.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#include "gdbsupport/thread-pool.h"
+#endif
 
 /* When == 1, print basic high level tracing messages.
    When > 1, be more verbose.
@@ -276,6 +282,16 @@ struct mapped_index final : public mapped_index_base
   /* The address table data.  */
   gdb::array_view<const gdb_byte> address_table;
 
+  /* True if ADDRESS_TABLE is sorted by address, has no overlapping
+     ranges and needs no adjustment by the gdbarch.  In that case it is
+     searched in place and no addrmap is built from it.  This is only
+     known once ADDRESS_TABLE_CHECKED is true.  */
+  bool address_table_in_place = false;
+
+  /* True once find_cu_in_address_table has checked whether ADDRESS_TABLE
+     can be searched in place.  */
+  bool address_table_checked = false;
+
   /* The symbol table, implemented as a hash table.  */
   offset_view symbol_table;
 
@@ -810,6 +826,10 @@ class cutu_reader : public die_reader_specs
      for dummy CUs.  */
   void keep ();
 
+  /* Release the new CU, putting it on the list of CUs read ahead of
+     time.  This cannot be done for dummy CUs.  */
+  void keep_preloaded ();
+
 private:
   void init_tu_and_read_dwo_dies (dwarf2_per_cu_data *this_cu,
 				  dwarf2_per_objfile *per_objfile,
@@ -818,7 +838,8 @@ class cutu_reader : public die_reader_specs
   struct dwarf2_per_cu_data *m_this_cu;
   std::unique_ptr<dwarf2_cu> m_new_cu;
 
-  /* The ordinary abbreviation table.  */
+  /* The abbreviation table of a DWO unit read without a skeleton.
+     Other abbreviation tables are owned by the per-BFD cache.  */
   abbrev_table_up m_abbrev_table_holder;
 
   /* The DWO abbreviation table.  */
@@ -1097,6 +1118,19 @@ show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* When true, the line number program of a CU is only decoded when one
+   of the line tables of its symtabs is first needed, instead of when
+   the CU is expanded.  */
+static bool dwarf_lazy_line_tables = true;
+
+static void
+show_dwarf_lazy_line_tables (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Lazy decoding of DWARF line tables is %s.\n"),
+		    value);
+}
+
 /* local function prototypes */
 
 static void dwarf2_find_base_address (struct die_info *die,
@@ -1298,8 +1332,7 @@ enum pc_bounds_kind
 
 static enum pc_bounds_kind dwarf2_get_pc_bounds (struct die_info *,
 						 CORE_ADDR *, CORE_ADDR *,
-						 struct dwarf2_cu *,
-						 dwarf2_psymtab *);
+						 struct dwarf2_cu *, bool);
 
 static void get_scope_pc_bounds (struct die_info *,
 				 CORE_ADDR *, CORE_ADDR *,
@@ -1468,6 +1501,12 @@ static void load_full_comp_unit (dwarf2_per_cu_data *per_cu,
 				 bool skip_partial,
 				 enum language pretend_language);
 
+static void read_comp_unit_dies (cutu_reader *reader);
+
+static void precanonicalize_die_names (dwarf2_cu *cu);
+
+static enum language dwarf_lang_to_enum_language (unsigned int lang);
+
 static void process_full_comp_unit (dwarf2_cu *cu,
 				    enum language pretend_language);
 
@@ -2090,6 +2129,15 @@ struct lazy_dwarf_reader : public psymbol_functions
     if (dwarf2_has_info (objfile, nullptr))
       dwarf2_build_psymtabs (objfile, this);
   }
+
+  void print_stats (struct objfile *objfile, bool print_bcache) override
+  {
+    psymbol_functions::print_stats (objfile, print_bcache);
+
+    dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+    if (!print_bcache && per_objfile != nullptr)
+      per_objfile->per_bfd->abbrev_tables.print_statistics ();
+  }
 };
 
 static quick_symbol_functions_up
@@ -2275,6 +2323,11 @@ load_cu (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
   return cu;
 }
 
+/* The number of abbrev section bytes whose tables the per-BFD abbrev
+   cache may hold once a symtab has been expanded.  */
+
+static const size_t abbrev_cache_max_size = 1024 * 1024;
+
 /* Read in the symbols for PER_CU in the context of PER_OBJFILE.  */
 
 static void
@@ -2316,6 +2369,14 @@ dw2_do_instantiate_symtab (dwarf2_per_cu_data *per_cu,
   /* Age the cache, releasing compilation units that have not
      been used recently.  */
   per_objfile->age_comp_units ();
+
+  /* Likewise, don't let the abbrev tables of all the units expanded
+     so far pile up.  The psymtab reader may still be using them, so
+     leave them alone while it runs.  */
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  if (!per_bfd->reading_partial_symbols
+      && per_bfd->abbrev_tables.size () > abbrev_cache_max_size)
+    per_bfd->abbrev_tables.clear ();
 }
 
 /* Ensure that the symbols for PER_CU have been read in.  DWARF2_PER_OBJFILE is
@@ -2524,6 +2585,57 @@ create_signatured_type_table_from_debug_names
   per_objfile->per_bfd->signatured_types = std::move (sig_types_hash);
 }
 
+/* Size of an entry of the .gdb_index address table.  */
+#define INDEX_ADDRESS_ENTRY_SIZE (8 + 8 + 4)
+
+/* Return true if the address table of INDEX can be searched in place,
+   without first building an addrmap from it.  This is the case for the
+   tables GDB writes itself (e.g. in the index cache), which are emitted
+   by walking an addrmap in address order.  */
+
+static bool
+address_table_usable_in_place (dwarf2_per_objfile *per_objfile,
+			       const struct mapped_index *index)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct gdbarch *gdbarch = objfile->arch ();
+  const gdb_byte *begin = index->address_table.data ();
+  const gdb_byte *end = begin + index->address_table.size ();
+  CORE_ADDR baseaddr = objfile->text_section_offset ();
+  ULONGEST prev_hi = 0;
+
+  if (index->address_table.size () % INDEX_ADDRESS_ENTRY_SIZE != 0)
+    return false;
+
+  for (const gdb_byte *iter = begin; iter < end;
+       iter += INDEX_ADDRESS_ENTRY_SIZE)
+    {
+      ULONGEST lo = extract_unsigned_integer (iter, 8, BFD_ENDIAN_LITTLE);
+      ULONGEST hi = extract_unsigned_integer (iter + 8, 8,
+					      BFD_ENDIAN_LITTLE);
+      ULONGEST cu_index = extract_unsigned_integer (iter + 16, 4,
+						    BFD_ENDIAN_LITTLE);
+
+      if (lo > hi || lo < prev_hi
+	  || cu_index >= per_bfd->all_comp_units.size ())
+	return false;
+
+      /* The ranges are typically contiguous, in which case LO was
+	 already checked as the end of the previous range.  */
+      if ((iter == begin || lo != prev_hi)
+	  && (gdbarch_adjust_dwarf2_addr (gdbarch, lo + baseaddr) - baseaddr
+	      != lo))
+	return false;
+      if (gdbarch_adjust_dwarf2_addr (gdbarch, hi + baseaddr) - baseaddr != hi)
+	return false;
+
+      prev_hi = hi;
+    }
+
+  return true;
+}
+
 /* Read the address map data from the mapped index, and use it to
    populate the psymtabs_addrmap.  */
 
@@ -2581,6 +2693,72 @@ create_addrmap_from_index (dwarf2_per_objfile *per_objfile,
 						 &per_bfd->obstack);
 }
 
+/* Find the CU covering the unrelocated address PC in the address table
+   of the .gdb_index of PER_OBJFILE.  Return NULL if there is none.
+
+   Whether the table can be searched in place is only checked here, on
+   the first lookup, rather than when the index is read: this takes a
+   pass over the whole table, which sessions that never look up an
+   address don't need.  If it can't, an addrmap is built from it, and
+   used from then on.  */
+
+static dwarf2_per_cu_data *
+find_cu_in_address_table (dwarf2_per_objfile *per_objfile, CORE_ADDR pc)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct mapped_index *index = per_bfd->index_table.get ();
+
+  if (!index->address_table_checked)
+    {
+      index->address_table_in_place
+	= address_table_usable_in_place (per_objfile, index);
+      index->address_table_checked = true;
+
+      dwarf_read_debug_printf ("%s the .gdb_index address table of %s",
+			       (index->address_table_in_place
+				? "Searching in place"
+				: "Building an addrmap from"),
+			       objfile_name (per_objfile->objfile));
+
+      if (!index->address_table_in_place)
+	create_addrmap_from_index (per_objfile, index);
+    }
+
+  if (!index->address_table_in_place)
+    return ((struct dwarf2_per_cu_data *)
+	    addrmap_find (per_bfd->index_addrmap, pc));
+
+  const gdb_byte *table = index->address_table.data ();
+  size_t lo_idx = 0;
+  size_t hi_idx = index->address_table.size () / INDEX_ADDRESS_ENTRY_SIZE;
+
+  /* Find the first entry whose start is greater than PC; the candidate
+     is the one just before it.  */
+  while (lo_idx < hi_idx)
+    {
+      size_t mid = lo_idx + (hi_idx - lo_idx) / 2;
+      ULONGEST start
+	= extract_unsigned_integer (table + mid * INDEX_ADDRESS_ENTRY_SIZE,
+				    8, BFD_ENDIAN_LITTLE);
+      if (start <= pc)
+	lo_idx = mid + 1;
+      else
+	hi_idx = mid;
+    }
+
+  if (lo_idx == 0)
+    return NULL;
+
+  const gdb_byte *entry = table + (lo_idx - 1) * INDEX_ADDRESS_ENTRY_SIZE;
+  ULONGEST end = extract_unsigned_integer (entry + 8, 8, BFD_ENDIAN_LITTLE);
+  if (pc >= end)
+    return NULL;
+
+  ULONGEST cu_index = extract_unsigned_integer (entry + 16, 4,
+						BFD_ENDIAN_LITTLE);
+  return per_bfd->get_cu (cu_index);
+}
+
 /* Read the address map data from DWARF-5 .debug_aranges, and use it to
    populate the psymtabs_addrmap.  */
 
@@ -2947,7 +3125,9 @@ dwarf2_read_gdb_index
 					       types_list_elements);
     }
 
-  create_addrmap_from_index (per_objfile, map.get ());
+  /* The index is typically mapped straight from a file (the index cache
+     or the objfile itself), so the address table is queried as is when
+     possible, see find_cu_in_address_table.  */
 
   per_bfd->index_table = std::move (map);
   per_bfd->using_index = 1;
@@ -3315,6 +3495,7 @@ dwarf2_base_index_functions::print_stats (struct objfile *objfile,
     }
   printf_filtered (_("  Number of read CUs: %d\n"), total - count);
   printf_filtered (_("  Number of unread CUs: %d\n"), count);
+  per_objfile->per_bfd->abbrev_tables.print_statistics ();
 }
 
 /* This dumps minimal information about the index.
@@ -3331,8 +3512,13 @@ dwarf2_gdb_index::dump (struct objfile *objfile)
   printf_filtered (".gdb_index:");
   if (per_objfile->per_bfd->index_table != NULL)
     {
-      printf_filtered (" version %d\n",
-		       per_objfile->per_bfd->index_table->version);
+      const mapped_index &index = *per_objfile->per_bfd->index_table;
+
+      printf_filtered (" version %d\n", index.version);
+      printf_filtered ("  address table: %s\n",
+		       (!index.address_table_checked ? "not used yet"
+			: index.address_table_in_place ? "searched in place"
+			: "copied to an addrmap"));
     }
   else
     printf_filtered (" faked for \"readnow\"\n");
@@ -4213,17 +4399,224 @@ dw2_expand_symtabs_matching_one
   return true;
 }
 
-/* Helper for dw2_expand_matching symtabs.  Called on each symbol
-   matched, to expand corresponding CUs that were marked.  IDX is the
-   index of the symbol name that matched.  */
+/* Read the sections of PER_OBJFILE that the attributes of the DIEs of
+   its units can refer to, so that the DIEs can be read on the worker
+   threads: reading a section is not thread-safe.  Return false if this
+   failed, leaving it to the normal reading of the DIEs to report the
+   problem.  */
 
 static bool
-dw2_expand_marked_cus
-  (dwarf2_per_objfile *per_objfile, offset_type idx,
+dw2_read_die_sections (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct objfile *objfile = per_objfile->objfile;
+
+  try
+    {
+      for (dwarf2_section_info *section : { &per_bfd->str,
+					    &per_bfd->line_str,
+					    &per_bfd->str_offsets,
+					    &per_bfd->addr,
+					    &per_bfd->loc,
+					    &per_bfd->loclists,
+					    &per_bfd->ranges,
+					    &per_bfd->rnglists })
+	section->read (objfile);
+
+      dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+      if (dwz != nullptr)
+	dwz->str.read (objfile);
+    }
+  catch (const gdb_exception_error &)
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/* Read the DIEs of the CUs of PER_CUS that are neither expanded nor
+   loaded yet, using the worker threads, and keep them around for
+   load_full_comp_unit to use.
+
+   Only the reading of the DIEs is done in parallel.  The unit headers
+   and top-level DIEs are read on the main thread, as this may involve
+   opening DWO files, and units whose DIEs are in a DWO file are left
+   to be read normally.  Building symbols and types out of the DIEs
+   is not thread-safe, and is still done on the main thread when the
+   CUs are expanded.  */
+
+static void
+dw2_preload_full_comp_units (dwarf2_per_objfile *per_objfile,
+			     const std::vector<dwarf2_per_cu_data *> &per_cus)
+{
+  /* Dumping the DIEs is not thread-safe.  */
+  if (dwarf_die_debug)
+    return;
+
+  if (!dw2_read_die_sections (per_objfile))
+    return;
+
+  std::vector<std::unique_ptr<cutu_reader>> readers;
+  for (dwarf2_per_cu_data *per_cu : per_cus)
+    {
+      if (per_cu->is_debug_types
+	  || per_objfile->symtab_set_p (per_cu)
+	  || per_objfile->get_cu (per_cu) != nullptr
+	  || per_objfile->preloaded_cu_p (per_cu))
+	continue;
+
+      try
+	{
+	  std::unique_ptr<cutu_reader> reader
+	    (new cutu_reader (per_cu, per_objfile, nullptr, nullptr, false));
+	  if (!reader->dummy_p && reader->cu->dwo_unit == nullptr)
+	    readers.push_back (std::move (reader));
+	}
+      catch (const gdb_exception_error &)
+	{
+	  /* Leave it to the normal reading to report the problem.  */
+	}
+    }
+
+  if (readers.size () < 2)
+    return;
+
+  /* Whether the DIEs of each unit were read successfully.  */
+  std::vector<char> read_ok (readers.size ());
+
+  complaint_interceptor complaints;
+#if CXX_STD_THREAD
+  std::mutex complaints_mutex;
+#endif
+
+  gdb::parallel_for_each
+    ((size_t) 0, readers.size (),
+     [&] (size_t start, size_t end)
+     {
+       complaint_interceptor local_complaints;
+
+       for (size_t i = start; i < end; ++i)
+	 {
+	   try
+	     {
+	       read_comp_unit_dies (readers[i].get ());
+	       precanonicalize_die_names (readers[i]->cu);
+	       read_ok[i] = 1;
+	     }
+	   catch (const gdb_exception &)
+	     {
+	       /* load_full_comp_unit will read this unit again and
+		  report the error.  */
+	     }
+	 }
+
+#if CXX_STD_THREAD
+       std::lock_guard<std::mutex> guard (complaints_mutex);
+#endif
+       complaints.take (local_complaints);
+     },
+     [&] (size_t i)
+     {
+       return (size_t) readers[i]->cu->header.get_length ();
+     });
+
+  complaints.reissue ();
+
+  size_t n_preloaded = 0;
+  for (size_t i = 0; i < readers.size (); ++i)
+    if (read_ok[i])
+      {
+	readers[i]->keep_preloaded ();
+	++n_preloaded;
+      }
+
+  dwarf_read_debug_printf ("Read the DIEs of %zu units ahead of expansion",
+			   n_preloaded);
+}
+
+/* A helper class that frees the compilation units read ahead of time
+   that were not used, on destruction.  */
+
+class free_preloaded_comp_units
+{
+public:
+
+  explicit free_preloaded_comp_units (dwarf2_per_objfile *per_objfile)
+    : m_per_objfile (per_objfile)
+  {
+  }
+
+  ~free_preloaded_comp_units ()
+  {
+    m_per_objfile->remove_all_preloaded_cus ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (free_preloaded_comp_units);
+
+private:
+
+  dwarf2_per_objfile *m_per_objfile;
+};
+
+/* Call dw2_expand_symtabs_matching_one on each CU of PER_CUS, in
+   order.  Return false if EXPANSION_NOTIFY asked to stop, true
+   otherwise.
+
+   When there are worker threads, the DIEs of the CUs about to be
+   expanded are read in parallel, a batch at a time, see
+   dw2_preload_full_comp_units.  */
+
+static bool
+dw2_expand_cus
+  (dwarf2_per_objfile *per_objfile,
+   const std::vector<dwarf2_per_cu_data *> &per_cus,
    gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
-   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  free_preloaded_comp_units freer (per_objfile);
+
+  /* How many CUs to read ahead of time.  This bounds the memory used
+     by DIEs that are not yet turned into symbols.  */
+  size_t batch_size = 0;
+#if CXX_STD_THREAD
+  batch_size = 16 * gdb::thread_pool::g_thread_pool->thread_count ();
+#endif
+
+  for (size_t i = 0; i < per_cus.size (); ++i)
+    {
+      QUIT;
+
+      if (batch_size > 0 && i % batch_size == 0)
+	{
+	  std::vector<dwarf2_per_cu_data *> batch;
+	  for (size_t j = i; j < per_cus.size () && j < i + batch_size; ++j)
+	    if (file_matcher == NULL || per_cus[j]->v.quick->mark)
+	      batch.push_back (per_cus[j]);
+	  dw2_preload_full_comp_units (per_objfile, batch);
+	}
+
+      if (!dw2_expand_symtabs_matching_one (per_cus[i], per_objfile,
+					    file_matcher, expansion_notify))
+	return false;
+    }
+
+  return true;
+}
+
+/* Helper for dw2_expand_matching symtabs.  Called on each symbol
+   matched, to collect the corresponding CUs in PER_CUS, so that they
+   can be expanded by dw2_expand_cus.  IDX is the index of the symbol
+   name that matched.  SEEN records the CUs already in PER_CUS, and is
+   indexed by dwarf2_per_cu_data::index.  */
+
+static void
+dw2_collect_marked_cus
+  (dwarf2_per_objfile *per_objfile, offset_type idx,
    block_search_flags search_flags,
-   search_domain kind)
+   search_domain kind,
+   std::vector<dwarf2_per_cu_data *> &per_cus,
+   std::vector<bool> &seen)
 {
   offset_type vec_len, vec_idx;
   bool global_seen = false;
@@ -4304,12 +4697,12 @@ dw2_expand_marked_cus
 	}
 
       dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cu (cu_index);
-      if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile, file_matcher,
-					    expansion_notify))
-	return false;
+      if (!seen[per_cu->index])
+	{
+	  seen[per_cu->index] = true;
+	  per_cus.push_back (per_cu);
+	}
     }
-
-  return true;
 }
 
 /* If FILE_MATCHER is non-NULL, set all the
@@ -4415,33 +4808,30 @@ dwarf2_gdb_index::expand_symtabs_matching
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
   if (lookup_name == nullptr)
     {
+      std::vector<dwarf2_per_cu_data *> per_cus;
       for (dwarf2_per_cu_data *per_cu
 	     : all_comp_units_range (per_objfile->per_bfd))
-	{
-	  QUIT;
+	per_cus.push_back (per_cu);
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
-	}
-      return true;
+      return dw2_expand_cus (per_objfile, per_cus, file_matcher,
+			     expansion_notify);
     }
 
   mapped_index &index = *per_objfile->per_bfd->index_table;
 
-  bool result
-    = dw2_expand_symtabs_matching_symbol (index, *lookup_name,
-					  symbol_matcher,
-					  [&] (offset_type idx)
+  std::vector<dwarf2_per_cu_data *> per_cus;
+  std::vector<bool> seen (per_objfile->per_bfd->all_comp_units.size ());
+  dw2_expand_symtabs_matching_symbol (index, *lookup_name,
+				      symbol_matcher,
+				      [&] (offset_type idx)
     {
-      if (!dw2_expand_marked_cus (per_objfile, idx, file_matcher,
-				  expansion_notify, search_flags, kind))
-	return false;
+      dw2_collect_marked_cus (per_objfile, idx, search_flags, kind,
+			      per_cus, seen);
       return true;
     }, per_objfile);
 
-  return result;
+  return dw2_expand_cus (per_objfile, per_cus, file_matcher,
+			 expansion_notify);
 }
 
 /* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
@@ -4484,13 +4874,16 @@ dwarf2_base_index_functions::find_pc_sect_compunit_symtab
   struct compunit_symtab *result;
 
   dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
-  if (per_objfile->per_bfd->index_addrmap == nullptr)
-    return NULL;
-
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
   CORE_ADDR baseaddr = objfile->text_section_offset ();
-  data = ((struct dwarf2_per_cu_data *)
-	  addrmap_find (per_objfile->per_bfd->index_addrmap,
-			pc - baseaddr));
+
+  if (per_bfd->index_addrmap != nullptr)
+    data = ((struct dwarf2_per_cu_data *)
+	    addrmap_find (per_bfd->index_addrmap, pc - baseaddr));
+  else if (per_bfd->index_table != nullptr)
+    data = find_cu_in_address_table (per_objfile, pc - baseaddr);
+  else
+    return NULL;
   if (!data)
     return NULL;
 
@@ -5408,40 +5801,39 @@ dwarf2_debug_names_index::expand_symtabs_matching
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
   if (lookup_name == nullptr)
     {
+      std::vector<dwarf2_per_cu_data *> per_cus;
       for (dwarf2_per_cu_data *per_cu
 	     : all_comp_units_range (per_objfile->per_bfd))
-	{
-	  QUIT;
+	per_cus.push_back (per_cu);
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
-	}
-      return true;
+      return dw2_expand_cus (per_objfile, per_cus, file_matcher,
+			     expansion_notify);
     }
 
   mapped_debug_names &map = *per_objfile->per_bfd->debug_names_table;
 
-  bool result
-    = dw2_expand_symtabs_matching_symbol (map, *lookup_name,
-					  symbol_matcher,
-					  [&] (offset_type namei)
+  std::vector<dwarf2_per_cu_data *> per_cus;
+  std::vector<bool> seen (per_objfile->per_bfd->all_comp_units.size ());
+  dw2_expand_symtabs_matching_symbol (map, *lookup_name,
+				      symbol_matcher,
+				      [&] (offset_type namei)
     {
-      /* The name was matched, now expand corresponding CUs that were
-	 marked.  */
+      /* The name was matched, now collect the corresponding CUs, they
+	 are expanded below.  */
       dw2_debug_names_iterator iter (map, kind, namei, per_objfile, domain);
 
       struct dwarf2_per_cu_data *per_cu;
       while ((per_cu = iter.next ()) != NULL)
-	if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-					      file_matcher,
-					      expansion_notify))
-	  return false;
+	if (!seen[per_cu->index])
+	  {
+	    seen[per_cu->index] = true;
+	    per_cus.push_back (per_cu);
+	  }
       return true;
     }, per_objfile);
 
-  return result;
+  return dw2_expand_cus (per_objfile, per_cus, file_matcher,
+			 expansion_notify);
 }
 
 /* Get the content of the .gdb_index section of OBJ.  SECTION_OWNER should point
@@ -6648,9 +7040,9 @@ cutu_reader::cutu_reader (dwarf2_per_cu_data *this_cu,
   else
     {
       abbrev_section->read (objfile);
-      m_abbrev_table_holder
-	= abbrev_table::read (abbrev_section, cu->header.abbrev_sect_off);
-      abbrev_table = m_abbrev_table_holder.get ();
+      abbrev_table
+	= per_objfile->per_bfd->abbrev_tables.find_or_read
+	    (abbrev_section, cu->header.abbrev_sect_off);
     }
 
   /* Read the top level CU/TU die.  */
@@ -6724,6 +7116,16 @@ cutu_reader::keep ()
     }
 }
 
+void
+cutu_reader::keep_preloaded ()
+{
+  gdb_assert (!dummy_p);
+  gdb_assert (m_new_cu != nullptr);
+
+  dwarf2_per_objfile *per_objfile = m_new_cu->per_objfile;
+  per_objfile->set_preloaded_cu (m_this_cu, m_new_cu.release ());
+}
+
 /* Read CU/TU THIS_CU but do not follow DW_AT_GNU_dwo_name (DW_AT_dwo_name)
    if present. DWO_FILE, if non-NULL, is the DWO file to read (the caller is
    assumed to have already done the lookup to find the DWO file).
@@ -6792,11 +7194,21 @@ cutu_reader::cutu_reader (dwarf2_per_cu_data *this_cu,
     }
 
   abbrev_section->read (objfile);
-  m_abbrev_table_holder
-    = abbrev_table::read (abbrev_section, m_new_cu->header.abbrev_sect_off);
+  struct abbrev_table *abbrev_table;
+  if (dwo_file == nullptr)
+    abbrev_table
+      = per_objfile->per_bfd->abbrev_tables.find_or_read
+	  (abbrev_section, m_new_cu->header.abbrev_sect_off);
+  else
+    {
+      m_abbrev_table_holder
+	= abbrev_table::read (abbrev_section,
+			      m_new_cu->header.abbrev_sect_off);
+      abbrev_table = m_abbrev_table_holder.get ();
+    }
 
   init_cu_die_reader (this, m_new_cu.get (), section, dwo_file,
-		      m_abbrev_table_holder.get ());
+		      abbrev_table);
   info_ptr = read_full_die (this, &comp_unit_die, info_ptr);
 }
 
@@ -6964,28 +7376,138 @@ create_partial_symtab (dwarf2_per_cu_data *per_cu,
   return pst;
 }
 
-/* DIE reader function for process_psymtab_comp_unit.  */
+/* What the scan of the partial DIEs of a compilation unit found, when
+   the scan runs on a worker thread, see build_comp_unit_psymtabs.
+
+   The psymtab storage and the bcache of the objfile can only be
+   updated on the main thread, so the scan records its findings here
+   instead, and merge_psymtab_comp_unit enters them in the objfile
+   once the scan is done, in the same order as a scan on the main
+   thread would have.  */
+
+struct psymtab_cu_scan
+{
+  /* Stand-in for objfile::intern while scanning: return a copy of NAME
+     that lives as long as this object.  */
+  const char *intern (const char *name)
+  {
+    const char *result
+      = (const char *) m_names.insert (name, strlen (name) + 1);
+    m_interned.insert (result);
+    return result;
+  }
+
+  /* Return the name to use in OBJFILE for NAME, a name found by the
+     scan: if NAME was returned by intern, its copy in the bcache of
+     OBJFILE, otherwise NAME itself.  */
+  const char *merged_name (struct objfile *objfile, const char *name) const
+  {
+    if (name != nullptr && m_interned.count (name) != 0)
+      return objfile->intern (name);
+    return name;
+  }
+
+  /* A partial symbol found by the scan, with where it goes.  */
+  struct psymbol
+  {
+    partial_symbol psym;
+    psymbol_placement where;
+
+    /* The demangled name given to PSYM, if any.  */
+    const char *demangled_name;
+  };
+
+  /* The partial symbols found, in order.  */
+  std::vector<psymbol> psymbols;
+
+  /* The address ranges of the unit, in order.  Each is an inclusive
+     range of addresses relative to the text section, as passed to
+     addrmap_set_empty.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+
+  /* The name of the main subprogram, if one was found, and its
+     language.  */
+  const char *main_name = nullptr;
+  enum language main_lang = language_unknown;
+
+  /* The lowest and highest PC of the unit.  */
+  CORE_ADDR lowpc = 0;
+  CORE_ADDR highpc = 0;
+
+  /* The complaints issued during the scan.  */
+  complaint_list complaints;
+
+private:
+
+  /* The copies of the names returned by intern.  */
+  gdb::bcache m_names;
+
+  /* The result of each call to intern.  */
+  std::unordered_set<const char *> m_interned;
+};
+
+/* Thrown when the scan of the partial DIEs of a unit done on a worker
+   thread needs something that can only be done on the main thread.
+   The unit is then scanned again on the main thread.  */
+
+struct psymtab_scan_aborted
+{
+};
+
+/* Called before doing, on behalf of the scan of the partial DIEs of CU,
+   something that can only be done on the main thread.  Give up if that
+   scan runs on a worker thread.  */
 
 static void
-process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
-				  const gdb_byte *info_ptr,
-				  struct die_info *comp_unit_die,
-				  enum language pretend_language)
+psymtab_scan_require_main_thread (struct dwarf2_cu *cu)
 {
-  struct dwarf2_cu *cu = reader->cu;
-  dwarf2_per_objfile *per_objfile = cu->per_objfile;
-  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
-  struct objfile *objfile = per_objfile->objfile;
+  if (cu->psymtab_scan != nullptr)
+    throw psymtab_scan_aborted ();
+}
+
+/* Return a copy of NAME that lives as long as the psymtabs of the
+   objfile of CU, see objfile::intern.  */
+
+static const char *
+dwarf2_intern_name (struct dwarf2_cu *cu, const char *name)
+{
+  if (cu->psymtab_scan != nullptr)
+    return cu->psymtab_scan->intern (name);
+  return cu->per_objfile->objfile->intern (name);
+}
+
+/* Record in the psymtab address map that the addresses from LOW to
+   HIGH (exclusive), as found in the DWARF of CU, belong to the psymtab
+   of CU.  */
+
+static void
+dwarf2_psymtab_record_range (struct dwarf2_cu *cu, CORE_ADDR low,
+			     CORE_ADDR high)
+{
+  struct objfile *objfile = cu->per_objfile->objfile;
   struct gdbarch *gdbarch = objfile->arch ();
-  struct dwarf2_per_cu_data *per_cu = cu->per_cu;
-  CORE_ADDR baseaddr;
-  CORE_ADDR best_lowpc = 0, best_highpc = 0;
-  dwarf2_psymtab *pst;
-  enum pc_bounds_kind cu_bounds_kind;
+  const CORE_ADDR baseaddr = objfile->text_section_offset ();
 
-  gdb_assert (! per_cu->is_debug_types);
+  low = gdbarch_adjust_dwarf2_addr (gdbarch, low + baseaddr) - baseaddr;
+  high = gdbarch_adjust_dwarf2_addr (gdbarch, high + baseaddr) - baseaddr;
 
-  prepare_one_comp_unit (cu, comp_unit_die, pretend_language);
+  if (cu->psymtab_scan != nullptr)
+    cu->psymtab_scan->ranges.emplace_back (low, high - 1);
+  else
+    addrmap_set_empty (cu->per_objfile->per_bfd->partial_symtabs
+		       ->psymtabs_addrmap,
+		       low, high - 1, cu->per_cu->v.psymtab);
+}
+
+/* Subroutine of process_psymtab_comp_unit_reader.  Create the psymtab
+   of CU, whose top-level DIE is COMP_UNIT_DIE.  */
+
+static dwarf2_psymtab *
+start_psymtab_comp_unit (struct dwarf2_cu *cu, struct die_info *comp_unit_die)
+{
+  dwarf2_per_objfile *per_objfile = cu->per_objfile;
+  struct dwarf2_per_cu_data *per_cu = cu->per_cu;
+  dwarf2_psymtab *pst;
 
   /* Allocate a new partial symbol table structure.  */
   static const char artificial[] = "<artificial>";
@@ -7004,26 +7526,39 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
   /* This must be done before calling dwarf2_build_include_psymtabs.  */
   pst->dirname = dwarf2_string_attr (comp_unit_die, DW_AT_comp_dir, cu);
 
-  baseaddr = objfile->text_section_offset ();
+  return pst;
+}
+
+/* Subroutine of process_psymtab_comp_unit_reader.  Scan the partial
+   DIEs of the unit read by READER for partial symbols, and return the
+   bounds of its code in *BEST_LOWPC and *BEST_HIGHPC.
+
+   This can run on a worker thread for a unit being scanned on behalf
+   of a psymtab_cu_scan, see build_comp_unit_psymtabs.  */
+
+static void
+read_psymtab_comp_unit_dies (const struct die_reader_specs *reader,
+			     const gdb_byte *info_ptr,
+			     struct die_info *comp_unit_die,
+			     CORE_ADDR *best_lowpc, CORE_ADDR *best_highpc)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  enum pc_bounds_kind cu_bounds_kind;
+
+  *best_lowpc = 0;
+  *best_highpc = 0;
 
   dwarf2_find_base_address (comp_unit_die, cu);
 
   /* Possibly set the default values of LOWPC and HIGHPC from
      `DW_AT_ranges'.  */
-  cu_bounds_kind = dwarf2_get_pc_bounds (comp_unit_die, &best_lowpc,
-					 &best_highpc, cu, pst);
-  if (cu_bounds_kind == PC_BOUNDS_HIGH_LOW && best_lowpc < best_highpc)
-    {
-      CORE_ADDR low
-	= (gdbarch_adjust_dwarf2_addr (gdbarch, best_lowpc + baseaddr)
-	   - baseaddr);
-      CORE_ADDR high
-	= (gdbarch_adjust_dwarf2_addr (gdbarch, best_highpc + baseaddr)
-	   - baseaddr - 1);
+  cu_bounds_kind = dwarf2_get_pc_bounds (comp_unit_die, best_lowpc,
+					 best_highpc, cu, true);
+  if (cu_bounds_kind == PC_BOUNDS_HIGH_LOW && *best_lowpc < *best_highpc)
+    {
       /* Store the contiguous range if it is not empty; it can be
 	 empty for CUs with no code.  */
-      addrmap_set_empty (per_bfd->partial_symtabs->psymtabs_addrmap,
-			 low, high, pst);
+      dwarf2_psymtab_record_range (cu, *best_lowpc, *best_highpc);
     }
 
   /* Check if comp unit has_children.
@@ -7051,10 +7586,27 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 	 then use the information extracted from its child dies.  */
       if (cu_bounds_kind <= PC_BOUNDS_INVALID)
 	{
-	  best_lowpc = lowpc;
-	  best_highpc = highpc;
+	  *best_lowpc = lowpc;
+	  *best_highpc = highpc;
 	}
     }
+}
+
+/* Subroutine of process_psymtab_comp_unit_reader.  Finish PST, the
+   psymtab of CU, whose code is from BEST_LOWPC to BEST_HIGHPC.  */
+
+static void
+end_psymtab_comp_unit (struct dwarf2_cu *cu, struct die_info *comp_unit_die,
+		       dwarf2_psymtab *pst,
+		       CORE_ADDR best_lowpc, CORE_ADDR best_highpc)
+{
+  dwarf2_per_objfile *per_objfile = cu->per_objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct objfile *objfile = per_objfile->objfile;
+  struct gdbarch *gdbarch = objfile->arch ();
+  struct dwarf2_per_cu_data *per_cu = cu->per_cu;
+  CORE_ADDR baseaddr = objfile->text_section_offset ();
+
   pst->set_text_low (gdbarch_adjust_dwarf2_addr (gdbarch,
 						 best_lowpc + baseaddr)
 		     - baseaddr);
@@ -7085,7 +7637,9 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 
   /* Get the list of files included in the current compilation unit,
      and build a psymtab for each of them.  */
-  dwarf2_build_include_psymtabs (cu, comp_unit_die, fnd, pst);
+  dwarf2_build_include_psymtabs (cu, comp_unit_die,
+				 find_file_and_directory (comp_unit_die, cu),
+				 pst);
 
   dwarf_read_debug_printf ("Psymtab for %s unit @%s: %s - %s"
 			   ", %d global, %d static syms",
@@ -7097,6 +7651,28 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 			   (int) pst->static_psymbols.size ());
 }
 
+/* DIE reader function for process_psymtab_comp_unit.  */
+
+static void
+process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
+				  const gdb_byte *info_ptr,
+				  struct die_info *comp_unit_die,
+				  enum language pretend_language)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  CORE_ADDR best_lowpc, best_highpc;
+  dwarf2_psymtab *pst;
+
+  gdb_assert (! cu->per_cu->is_debug_types);
+
+  prepare_one_comp_unit (cu, comp_unit_die, pretend_language);
+
+  pst = start_psymtab_comp_unit (cu, comp_unit_die);
+  read_psymtab_comp_unit_dies (reader, info_ptr, comp_unit_die,
+			       &best_lowpc, &best_highpc);
+  end_psymtab_comp_unit (cu, comp_unit_die, pst, best_lowpc, best_highpc);
+}
+
 /* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
    Process compilation unit THIS_CU for a psymtab.  */
 
@@ -7235,7 +7811,7 @@ static void
 build_type_psymtabs (dwarf2_per_objfile *per_objfile)
 {
   struct tu_stats *tu_stats = &per_objfile->per_bfd->tu_stats;
-  abbrev_table_up abbrev_table;
+  struct abbrev_table *abbrev_table = nullptr;
   sect_offset abbrev_offset;
 
   /* It's up to the caller to not call us multiple times.  */
@@ -7245,10 +7821,9 @@ build_type_psymtabs (dwarf2_per_objfile *per_objfile)
     return;
 
   /* TUs typically share abbrev tables, and there can be way more TUs than
-     abbrev tables.  Sort by abbrev table to reduce the number of times we
-     read each abbrev table in.
-     Alternatives are to punt or to maintain a cache of abbrev tables.
-     This is simpler and efficient enough for now.
+     abbrev tables.  The tables themselves come from the per-BFD abbrev
+     cache, but sort by abbrev table anyway so that we only look each one
+     up once.
 
      Later we group TUs by their DW_AT_stmt_list value (as this defines the
      symtab to use).  Typically TUs with the same abbrev offset have the same
@@ -7293,13 +7868,13 @@ build_type_psymtabs (dwarf2_per_objfile *per_objfile)
 	{
 	  abbrev_offset = tu.abbrev_offset;
 	  per_objfile->per_bfd->abbrev.read (per_objfile->objfile);
-	  abbrev_table =
-	    abbrev_table::read (&per_objfile->per_bfd->abbrev, abbrev_offset);
+	  abbrev_table = per_objfile->per_bfd->abbrev_tables.find_or_read
+	    (&per_objfile->per_bfd->abbrev, abbrev_offset);
 	  ++tu_stats->nr_uniq_abbrev_tables;
 	}
 
       cutu_reader reader (tu.sig_type, per_objfile,
-			  abbrev_table.get (), nullptr, false);
+			  abbrev_table, nullptr, false);
       if (!reader.dummy_p)
 	build_type_psymtabs_reader (&reader, reader.info_ptr,
 				    reader.comp_unit_die);
@@ -7448,6 +8023,274 @@ set_partial_user (dwarf2_per_objfile *per_objfile)
     }
 }
 
+/* Subroutine of dwarf2_build_psymtabs_hard.  Read the abbrev tables
+   used by the compilation units of PER_OBJFILE into the per-BFD abbrev
+   cache, ahead of the psymtab scan.
+
+   Parsing an abbrev table only depends on the contents of the
+   (already read in) abbrev section, so the tables are read in
+   parallel by the worker threads.  Type units are not handled here,
+   see build_type_psymtabs.  */
+
+static void
+read_cu_abbrev_tables (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  typedef std::pair<dwarf2_section_info *, sect_offset> abbrev_key;
+  std::vector<abbrev_key> keys;
+
+  /* Collect the distinct tables.  This reads the sections, which is
+     not thread-safe, so it is done on the main thread.  */
+  for (const auto &per_cu : per_bfd->all_comp_units)
+    {
+      if (per_cu->is_debug_types)
+	continue;
+
+      dwarf2_section_info *abbrev_section
+	= get_abbrev_section_for_cu (per_cu.get ());
+      abbrev_section->read (per_objfile->objfile);
+      sect_offset abbrev_offset
+	= read_abbrev_offset (per_objfile, per_cu->section, per_cu->sect_off);
+
+      /* Leave bogus offsets to the reader, which will complain.  */
+      if (to_underlying (abbrev_offset) >= abbrev_section->size)
+	continue;
+
+      keys.emplace_back (abbrev_section, abbrev_offset);
+    }
+
+  std::sort (keys.begin (), keys.end ());
+  keys.erase (std::unique (keys.begin (), keys.end ()), keys.end ());
+
+  gdb::parallel_for_each
+    (keys.begin (), keys.end (),
+     [&] (std::vector<abbrev_key>::iterator first,
+	  std::vector<abbrev_key>::iterator last)
+     {
+       for (auto iter = first; iter != last; ++iter)
+	 {
+	   try
+	     {
+	       per_bfd->abbrev_tables.find_or_read (iter->first, iter->second);
+	     }
+	   catch (const gdb_exception &)
+	     {
+	       /* The reader will try again and report the error from the
+		  main thread.  */
+	     }
+	 }
+     });
+
+  dwarf_read_debug_printf ("Read %zu abbrev tables for %zu units",
+			   keys.size (), per_bfd->all_comp_units.size ());
+}
+
+/* Subroutine of build_comp_unit_psymtabs.  Scan the partial DIEs of
+   the compilation unit read by READER into SCAN.  This runs on a worker
+   thread.  */
+
+static void
+scan_psymtab_comp_unit (cutu_reader *reader, psymtab_cu_scan *scan)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  complaint_interceptor complaints;
+
+  scoped_restore restore_scan
+    = make_scoped_restore (&cu->psymtab_scan, scan);
+
+  prepare_one_comp_unit (cu, reader->comp_unit_die, language_minimal);
+  read_psymtab_comp_unit_dies (reader, reader->info_ptr,
+			       reader->comp_unit_die,
+			       &scan->lowpc, &scan->highpc);
+
+  scan->complaints = complaints.release ();
+}
+
+/* Subroutine of build_comp_unit_psymtabs.  Create the psymtab of the
+   compilation unit read by READER out of SCAN, what
+   scan_psymtab_comp_unit found, like process_psymtab_comp_unit would
+   have.  */
+
+static void
+merge_psymtab_comp_unit (cutu_reader *reader, const psymtab_cu_scan &scan)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  dwarf2_per_objfile *per_objfile = cu->per_objfile;
+  psymtab_storage *partial_symtabs
+    = per_objfile->per_bfd->partial_symtabs.get ();
+  struct objfile *objfile = per_objfile->objfile;
+
+  cu->per_cu->unit_type = DW_UT_compile;
+
+  dwarf2_psymtab *pst = start_psymtab_comp_unit (cu, reader->comp_unit_die);
+
+  reissue_complaints (scan.complaints);
+
+  for (const auto &range : scan.ranges)
+    addrmap_set_empty (partial_symtabs->psymtabs_addrmap,
+		       range.first, range.second, pst);
+
+  for (const auto &item : scan.psymbols)
+    {
+      partial_symbol psymbol = item.psym;
+
+      psymbol.ginfo.set_linkage_name
+	(scan.merged_name (objfile, psymbol.ginfo.linkage_name ()));
+      if (item.demangled_name != nullptr)
+	psymbol.ginfo.set_demangled_name
+	  (scan.merged_name (objfile, item.demangled_name),
+	   &objfile->objfile_obstack);
+      pst->add_psymbol (psymbol, item.where, partial_symtabs, objfile);
+    }
+
+  if (scan.main_name != nullptr)
+    set_objfile_main_name (objfile, scan.main_name, scan.main_lang);
+
+  end_psymtab_comp_unit (cu, reader->comp_unit_die, pst,
+			 scan.lowpc, scan.highpc);
+}
+
+/* Subroutine of dwarf2_build_psymtabs_hard.  Create the psymtabs of the
+   units of PER_OBJFILE that don't have one yet.
+
+   The partial DIEs of the compilation units are scanned in parallel by
+   the worker threads, a batch of units at a time, see psymtab_cu_scan.
+   The psymtabs are then created on the main thread, in the order of the
+   units, so the result is the same as when process_psymtab_comp_unit
+   processes each unit in turn.  That is still how the units that can't
+   be scanned on a worker thread are processed: type units, partial
+   units, units whose DIEs are in a DWO file, and the units whose scan
+   needs to read other units, see psymtab_scan_require_main_thread.  */
+
+static void
+build_comp_unit_psymtabs (dwarf2_per_objfile *per_objfile)
+{
+  const auto &all_comp_units = per_objfile->per_bfd->all_comp_units;
+  size_t n_threads = 0;
+
+#if CXX_STD_THREAD
+  n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+#endif
+
+  /* Recording what the scan finds and merging it back makes reading
+     the symbols about 20% slower on a single CPU, which one worker
+     thread (the default on a single-CPU host) does not make up for.  */
+  if (n_threads < 2 || !dw2_read_die_sections (per_objfile))
+    {
+      for (const auto &per_cu : all_comp_units)
+	{
+	  if (per_cu->v.psymtab != NULL)
+	    /* In case a forward DW_TAG_imported_unit has read the CU
+	       already.  */
+	    continue;
+	  process_psymtab_comp_unit (per_cu.get (), per_objfile, false,
+				     language_minimal);
+	}
+      return;
+    }
+
+  size_t batch_size = 16 * n_threads;
+  size_t n_scanned = 0;
+  for (size_t first = 0; first < all_comp_units.size (); first += batch_size)
+    {
+      size_t count = std::min (batch_size, all_comp_units.size () - first);
+      std::vector<std::unique_ptr<cutu_reader>> readers (count);
+      std::vector<std::unique_ptr<psymtab_cu_scan>> scans (count);
+
+      /* Read the unit headers and top-level DIEs on the main thread, as
+	 this may involve opening DWO files.  */
+      for (size_t i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = all_comp_units[first + i].get ();
+
+	  if (per_cu->is_debug_types || per_cu->v.psymtab != nullptr)
+	    continue;
+
+	  /* See process_psymtab_comp_unit.  */
+	  per_objfile->remove_cu (per_cu);
+
+	  try
+	    {
+	      std::unique_ptr<cutu_reader> reader
+		(new cutu_reader (per_cu, per_objfile, nullptr, nullptr,
+				  false));
+	      if (!reader->dummy_p
+		  && reader->comp_unit_die->tag == DW_TAG_compile_unit
+		  && reader->cu->dwo_unit == nullptr)
+		{
+		  readers[i] = std::move (reader);
+		  scans[i].reset (new psymtab_cu_scan);
+		}
+	    }
+	  catch (const gdb_exception_error &)
+	    {
+	      /* Leave it to process_psymtab_comp_unit to report the
+		 problem.  */
+	    }
+	}
+
+      gdb::parallel_for_each
+	((size_t) 0, count,
+	 [&] (size_t start, size_t end)
+	 {
+	   for (size_t i = start; i < end; ++i)
+	     {
+	       if (scans[i] == nullptr)
+		 continue;
+
+	       try
+		 {
+		   scan_psymtab_comp_unit (readers[i].get (), scans[i].get ());
+		 }
+	       catch (const psymtab_scan_aborted &)
+		 {
+		   scans[i].reset ();
+		 }
+	       catch (const gdb_exception &)
+		 {
+		   /* process_psymtab_comp_unit will scan this unit again
+		      and report the error.  */
+		   scans[i].reset ();
+		 }
+	     }
+	 },
+	 [&] (size_t i)
+	 {
+	   if (scans[i] == nullptr)
+	     return (size_t) 0;
+	   return (size_t) readers[i]->cu->header.get_length ();
+	 });
+
+      for (size_t i = 0; i < count; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = all_comp_units[first + i].get ();
+	  std::unique_ptr<cutu_reader> reader = std::move (readers[i]);
+	  std::unique_ptr<psymtab_cu_scan> scan = std::move (scans[i]);
+
+	  if (per_cu->v.psymtab != NULL)
+	    /* In case a forward DW_TAG_imported_unit has read the CU
+	       already.  */
+	    continue;
+
+	  if (scan != nullptr)
+	    {
+	      merge_psymtab_comp_unit (reader.get (), *scan);
+	      per_objfile->age_comp_units ();
+	      ++n_scanned;
+	    }
+	  else
+	    {
+	      reader.reset ();
+	      process_psymtab_comp_unit (per_cu, per_objfile, false,
+					 language_minimal);
+	    }
+	}
+    }
+
+  dwarf_read_debug_printf ("Scanned %zu of %zu units on the worker threads",
+			   n_scanned, all_comp_units.size ());
+}
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -7480,14 +8323,8 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
     = make_scoped_restore (&per_bfd->partial_symtabs->psymtabs_addrmap,
 			   addrmap_create_mutable (&temp_obstack));
 
-  for (const auto &per_cu : per_bfd->all_comp_units)
-    {
-      if (per_cu->v.psymtab != NULL)
-	/* In case a forward DW_TAG_imported_unit has read the CU already.  */
-	continue;
-      process_psymtab_comp_unit (per_cu.get (), per_objfile, false,
-				 language_minimal);
-    }
+  read_cu_abbrev_tables (per_objfile);
+  build_comp_unit_psymtabs (per_objfile);
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (per_objfile);
@@ -7510,6 +8347,10 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
   /* At this point we want to keep the address map.  */
   save_psymtabs_addrmap.release ();
 
+  /* Most of the abbrev tables are not needed again until units are
+     expanded, so don't keep them around for the life of the BFD.  */
+  per_bfd->abbrev_tables.clear ();
+
   dwarf_read_debug_printf ("Done building psymtabs of %s",
 			   objfile_name (objfile));
 }
@@ -7720,6 +8561,8 @@ scan_partial_symbols (struct partial_die_info *first_die, CORE_ADDR *lowpc,
 			   objfile_name (cu->per_objfile->objfile));
 		  }
 
+		psymtab_scan_require_main_thread (cu);
+
 		per_cu = dwarf2_find_containing_comp_unit
 			   (pdi->d.sect_off, pdi->is_dwz,
 			    cu->per_objfile->per_bfd);
@@ -7879,6 +8722,8 @@ partial_die_full_name (struct partial_die_info *pdi,
 	  struct attribute attr;
 	  struct dwarf2_cu *ref_cu = cu;
 
+	  psymtab_scan_require_main_thread (cu);
+
 	  /* DW_FORM_ref_addr is using section offset.  */
 	  attr.name = (enum dwarf_attribute) 0;
 	  attr.form = DW_FORM_ref_addr;
@@ -7955,7 +8800,16 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
       psymbol.ginfo.value.address = addr;
 
       if (pdi->main_subprogram && actual_name != NULL)
-	set_objfile_main_name (objfile, actual_name, cu->per_cu->lang);
+	{
+	  if (cu->psymtab_scan != nullptr)
+	    {
+	      cu->psymtab_scan->main_name
+		= cu->psymtab_scan->intern (actual_name);
+	      cu->psymtab_scan->main_lang = cu->per_cu->lang;
+	    }
+	  else
+	    set_objfile_main_name (objfile, actual_name, cu->per_cu->lang);
+	}
       break;
     case DW_TAG_constant:
       psymbol.domain = VAR_DOMAIN;
@@ -8077,20 +8931,28 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 
   if (where.has_value ())
     {
+      const char *demangled_name = nullptr;
+
       if (built_actual_name != nullptr)
-	actual_name = objfile->intern (actual_name);
+	actual_name = dwarf2_intern_name (cu, actual_name);
       if (pdi->linkage_name == nullptr
 	  || cu->per_cu->lang == language_ada)
 	psymbol.ginfo.set_linkage_name (actual_name);
       else
 	{
-	  psymbol.ginfo.set_demangled_name (actual_name,
+	  demangled_name = actual_name;
+	  psymbol.ginfo.set_demangled_name (demangled_name,
 					    &objfile->objfile_obstack);
 	  psymbol.ginfo.set_linkage_name (pdi->linkage_name);
 	}
-      cu->per_cu->v.psymtab->add_psymbol
-	(psymbol, *where, per_objfile->per_bfd->partial_symtabs.get (),
-	 objfile);
+
+      if (cu->psymtab_scan != nullptr)
+	cu->psymtab_scan->psymbols.push_back ({ psymbol, *where,
+						demangled_name });
+      else
+	cu->per_cu->v.psymtab->add_psymbol
+	  (psymbol, *where, per_objfile->per_bfd->partial_symtabs.get (),
+	   objfile);
     }
 }
 
@@ -8131,7 +8993,7 @@ add_partial_module (struct partial_die_info *pdi, CORE_ADDR *lowpc,
 
 static int
 dwarf2_ranges_read (unsigned, CORE_ADDR *, CORE_ADDR *, struct dwarf2_cu *,
-		    dwarf2_psymtab *, dwarf_tag);
+		    bool, dwarf_tag);
 
 /* Read a partial die corresponding to a subprogram or an inlined
    subprogram and create a partial symbol for that subprogram.
@@ -8159,34 +9021,12 @@ add_partial_subprogram (struct partial_die_info *pdi,
 	  if (pdi->highpc > *highpc)
 	    *highpc = pdi->highpc;
 	  if (set_addrmap)
-	    {
-	      struct objfile *objfile = cu->per_objfile->objfile;
-	      dwarf2_per_bfd *per_bfd = cu->per_objfile->per_bfd;
-	      struct gdbarch *gdbarch = objfile->arch ();
-	      CORE_ADDR baseaddr;
-	      CORE_ADDR this_highpc;
-	      CORE_ADDR this_lowpc;
-
-	      baseaddr = objfile->text_section_offset ();
-	      this_lowpc
-		= (gdbarch_adjust_dwarf2_addr (gdbarch,
-					       pdi->lowpc + baseaddr)
-		   - baseaddr);
-	      this_highpc
-		= (gdbarch_adjust_dwarf2_addr (gdbarch,
-					       pdi->highpc + baseaddr)
-		   - baseaddr);
-	      addrmap_set_empty (per_bfd->partial_symtabs->psymtabs_addrmap,
-				 this_lowpc, this_highpc - 1,
-				 cu->per_cu->v.psymtab);
-	    }
+	    dwarf2_psymtab_record_range (cu, pdi->lowpc, pdi->highpc);
 	}
 
       if (pdi->has_range_info
 	  && dwarf2_ranges_read (pdi->ranges_offset, &pdi->lowpc, &pdi->highpc,
-				 cu,
-				 set_addrmap ? cu->per_cu->v.psymtab : nullptr,
-				 pdi->tag))
+				 cu, set_addrmap, pdi->tag))
 	{
 	  if (pdi->lowpc < *lowpc)
 	    *lowpc = pdi->lowpc;
@@ -8327,6 +9167,28 @@ skip_one_die (const struct die_reader_specs *reader, const gdb_byte *info_ptr,
   const gdb_byte *buffer_end = reader->buffer_end;
   unsigned int form, i;
 
+  /* Fast paths using what was precomputed for the abbrev: jump
+     straight to the sibling if it is at a known place, or skip all the
+     attributes at once if their size is known.  */
+  if (abbrev->sibling_offset != (unsigned short) -1)
+    {
+      const gdb_byte *sibling_data = info_ptr + abbrev->sibling_offset;
+      const gdb_byte *sibling_ptr
+	= (buffer + to_underlying (cu->header.sect_off)
+	   + read_4_bytes (abfd, sibling_data));
+
+      if (sibling_ptr >= sibling_data && sibling_ptr <= buffer_end)
+	return sibling_ptr;
+      /* Otherwise, take the slow path, which issues the complaint.  */
+    }
+  else if (abbrev->size_if_constant != 0)
+    {
+      info_ptr += abbrev->size_if_constant;
+      if (abbrev->has_children)
+	return skip_children (reader, info_ptr);
+      return info_ptr;
+    }
+
   for (i = 0; i < abbrev->num_attrs; i++)
     {
       /* The only abbrev we care about is DW_AT_sibling.  */
@@ -8699,27 +9561,77 @@ dwarf2_psymtab::get_compunit_symtab (struct objfile *objfile) const
   return per_objfile->get_symtab (per_cu_data);
 }
 
-/* Trivial hash function for die_info: the hash value of a DIE
-   is its offset in .debug_info for this objfile.  */
+/* Read all the DIEs of the unit being read by READER into its
+   dwarf2_cu.  This only modifies the dwarf2_cu, and only reads
+   sections that are already read in, so it can be called from a
+   worker thread, see dw2_preload_full_comp_units.  */
 
-static hashval_t
-die_hash (const void *item)
+static void
+read_comp_unit_dies (cutu_reader *reader)
 {
-  const struct die_info *die = (const struct die_info *) item;
+  struct dwarf2_cu *cu = reader->cu;
+  const gdb_byte *info_ptr = reader->info_ptr;
 
-  return to_underlying (die->sect_off);
+  gdb_assert (cu->die_index.empty ());
+
+  if (reader->comp_unit_die->has_children)
+    reader->comp_unit_die->child
+      = read_die_and_siblings (reader, reader->info_ptr,
+			       &info_ptr, reader->comp_unit_die);
+  cu->dies = reader->comp_unit_die;
+  /* comp_unit_die is not stored in die_index, no need.  */
+  cu->die_index.shrink_to_fit ();
 }
 
-/* Trivial comparison function for die_info structures: two DIEs
-   are equal if they have the same offset.  */
+/* If CU is a C++ unit, compute the canonical forms of the names of its
+   DIEs, so that dwarf2_name finds them in the cache of
+   cp_canonicalize_string when CU is expanded.  This only reads the
+   DIEs, so it can be called from a worker thread, see
+   dw2_preload_full_comp_units.  */
 
-static int
-die_eq (const void *item_lhs, const void *item_rhs)
+static void
+precanonicalize_die_names (dwarf2_cu *cu)
 {
-  const struct die_info *die_lhs = (const struct die_info *) item_lhs;
-  const struct die_info *die_rhs = (const struct die_info *) item_rhs;
+  attribute *lang_attr = cu->dies->attr (DW_AT_language);
+  if (lang_attr == nullptr
+      || (dwarf_lang_to_enum_language (lang_attr->constant_value (0))
+	  != language_cplus))
+    return;
+
+  std::vector<die_info *> todo;
+  if (cu->dies->child != nullptr)
+    todo.push_back (cu->dies->child);
+
+  while (!todo.empty ())
+    {
+      die_info *die = todo.back ();
+      todo.pop_back ();
 
-  return die_lhs->sect_off == die_rhs->sect_off;
+      for (; die != nullptr; die = die->sibling)
+	{
+	  if (die->child != nullptr)
+	    todo.push_back (die->child);
+
+	  /* The names dwarf2_name doesn't canonicalize.  */
+	  if (die->tag == DW_TAG_enumeration_type
+	      || die->tag == DW_TAG_enumerator
+	      || die->tag == DW_TAG_namespace)
+	    continue;
+
+	  attribute *attr = die->attr (DW_AT_name);
+	  if (attr == nullptr
+	      || !attr->form_is_string ()
+	      || attr->requires_reprocessing_p ()
+	      || attr->canonical_string_p ())
+	    continue;
+
+	  const char *name = attr->as_string ();
+	  if (name != nullptr
+	      && !startswith (name, "._")
+	      && !startswith (name, "<anonymous"))
+	    cp_canonicalize_string (name);
+	}
+    }
 }
 
 /* Load the DIEs associated with PER_CU into memory.
@@ -8738,29 +9650,29 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 {
   gdb_assert (! this_cu->is_debug_types);
 
+  /* Use the DIEs read ahead of time by dw2_preload_full_comp_units,
+     if any.  */
+  if (existing_cu == nullptr)
+    {
+      dwarf2_cu *cu = per_objfile->take_preloaded_cu (this_cu);
+      if (cu != nullptr)
+	{
+	  if (skip_partial && cu->dies->tag == DW_TAG_partial_unit)
+	    delete cu;
+	  else
+	    {
+	      prepare_one_comp_unit (cu, cu->dies, pretend_language);
+	      per_objfile->set_cu (this_cu, cu);
+	    }
+	  return;
+	}
+    }
+
   cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
   if (reader.dummy_p)
     return;
 
-  struct dwarf2_cu *cu = reader.cu;
-  const gdb_byte *info_ptr = reader.info_ptr;
-
-  gdb_assert (cu->die_hash == NULL);
-  cu->die_hash =
-    htab_create_alloc_ex (cu->header.length / 12,
-			  die_hash,
-			  die_eq,
-			  NULL,
-			  &cu->comp_unit_obstack,
-			  hashtab_obstack_allocate,
-			  dummy_obstack_deallocate);
-
-  if (reader.comp_unit_die->has_children)
-    reader.comp_unit_die->child
-      = read_die_and_siblings (&reader, reader.info_ptr,
-			       &info_ptr, reader.comp_unit_die);
-  cu->dies = reader.comp_unit_die;
-  /* comp_unit_die is not stored in die_hash, no need.  */
+  read_comp_unit_dies (&reader);
 
   /* We try not to read any attributes in this function, because not
      all CUs needed for references have been loaded yet, and symbol
@@ -8768,7 +9680,7 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
      or we won't be able to build types correctly.
      Similarly, if we do not read the producer, we can not apply
      producer-specific interpretation.  */
-  prepare_one_comp_unit (cu, cu->dies, pretend_language);
+  prepare_one_comp_unit (reader.cu, reader.cu->dies, pretend_language);
 
   reader.keep ();
 }
@@ -9501,6 +10413,10 @@ process_full_comp_unit (dwarf2_cu *cu, enum language pretend_language)
 	cust->epilogue_unwind_valid = 1;
 
       cust->set_call_site_htab (cu->call_site_htab);
+
+      /* Arrange for the line tables to be read when first needed.  This
+	 must only be done now that the compunit is complete.  */
+      cust->pending_line_tables = cu->line_table_reader;
     }
 
   per_objfile->set_symtab (cu->per_cu, cust);
@@ -10130,6 +11046,37 @@ dwarf2_full_name (const char *name, struct die_info *die, struct dwarf2_cu *cu)
   return dwarf2_compute_name (name, die, cu, 0);
 }
 
+/* Demangle MANGLED for dwarf2_physname.  Use the demangle cache of
+   PER_BFD if it has one.  */
+
+static gdb::unique_xmalloc_ptr<char>
+dwarf2_physname_demangle (const char *mangled,
+			  objfile_per_bfd_storage *per_bfd)
+{
+  const unsigned int kind = bfd_demangle_cache::physname_kind;
+  bfd_demangle_cache *cache = per_bfd->demangle_cache.get ();
+  gdb::unique_xmalloc_ptr<char> demangled;
+
+  if (cache != nullptr)
+    {
+      enum language language;
+
+      if (cache->lookup (kind, mangled, &language, &demangled))
+	{
+	  global_demangle_cache.hit ();
+	  return demangled;
+	}
+      global_demangle_cache.miss ();
+    }
+
+  demangled = gdb_demangle (mangled, (DMGL_PARAMS | DMGL_ANSI
+				      | DMGL_RET_DROP));
+
+  if (cache != nullptr)
+    cache->record (kind, mangled, language_cplus, demangled.get ());
+  return demangled;
+}
+
 /* Construct a physname for the given DIE in CU.  NAME may either be
    from a previous call to dwarf2_name or NULL.  The result will be
    allocated on the objfile_objstack or NULL if the DIE does not have a
@@ -10171,8 +11118,7 @@ dwarf2_physname (const char *name, struct die_info *die, struct dwarf2_cu *cu)
 	     to look up their definition from their declaration so
 	     the only disadvantage remains the minimal symbol variant
 	     `long name(params)' does not have the proper inferior type.  */
-	  demangled = gdb_demangle (mangled, (DMGL_PARAMS | DMGL_ANSI
-					      | DMGL_RET_DROP));
+	  demangled = dwarf2_physname_demangle (mangled, objfile->per_bfd);
 	}
       if (demangled)
 	canon = demangled.get ();
@@ -10503,6 +11449,51 @@ find_file_and_directory (struct die_info *die, struct dwarf2_cu *cu)
   return *cu->per_cu->fnd;
 }
 
+/* The line_table_reader of a CU whose line number program is decoded
+   lazily.  This holds what is needed to decode the program once the
+   CU itself has been expanded and its dwarf2_cu freed.  */
+
+struct dwarf2_line_table_reader : public line_table_reader
+{
+  dwarf2_line_table_reader (dwarf2_cu *cu, sect_offset line_offset,
+			    const char *name, CORE_ADDR unrelocated_lowpc)
+    : per_cu (cu->per_cu),
+      per_objfile (cu->per_objfile),
+      header (cu->header),
+      producer (cu->producer),
+      str_offsets_base (cu->str_offsets_base),
+      line_offset (line_offset),
+      name (name),
+      unrelocated_lowpc (unrelocated_lowpc)
+  {
+  }
+
+  void read_line_tables (struct compunit_symtab *cust) override;
+
+  dwarf2_per_cu_data *per_cu;
+  dwarf2_per_objfile *per_objfile;
+
+  /* The parts of the CU's dwarf2_cu that decoding the line number
+     program depends on.  */
+  comp_unit_head header;
+  const char *producer;
+  gdb::optional<ULONGEST> str_offsets_base;
+
+  /* Offset of the line number program in the line section.  */
+  sect_offset line_offset;
+
+  /* The name of the CU, as passed to start_symtab.  */
+  std::string name;
+
+  /* The low PC of the CU, as passed to dwarf_decode_lines but without
+     the objfile's text section offset.  */
+  CORE_ADDR unrelocated_lowpc;
+
+  /* The symtab created for each entry of the line header's file name
+     table.  */
+  std::vector<symtab *> file_symtabs;
+};
+
 /* Handle DW_AT_stmt_list for a compilation unit.
    DIE is the DW_TAG_compile_unit die for CU.
    COMP_DIR is the compilation directory.  LOWPC is passed to
@@ -10598,9 +11589,35 @@ handle_DW_AT_stmt_list (struct die_info *die, struct dwarf2_cu *cu,
       gdb_assert (die->tag != DW_TAG_partial_unit);
     }
   decode_mapping = (die->tag != DW_TAG_partial_unit);
+
+  /* Don't decode the line number program now if it can be done when
+     one of the line tables is needed.  DWO units are always decoded
+     right away.  */
+  if (decode_mapping
+      && dwarf_lazy_line_tables
+      && cu->dwo_unit == nullptr
+      && (cu->line_header->statement_program_start
+	  < cu->line_header->statement_program_end))
+    {
+      struct objfile *objfile = per_objfile->objfile;
+      CORE_ADDR baseaddr = objfile->text_section_offset ();
+      std::unique_ptr<dwarf2_line_table_reader> reader
+	(new dwarf2_line_table_reader (cu, line_offset, fnd.get_name (),
+				       lowpc - baseaddr));
+
+      dwarf_decode_lines (cu->line_header, fnd, cu, nullptr, lowpc, 0);
+
+      for (const file_entry &fe : cu->line_header->file_names ())
+	reader->file_symtabs.push_back (fe.symtab);
+      cu->get_builder ()->defer_line_numbers ();
+
+      cu->line_table_reader = reader.get ();
+      per_objfile->line_table_readers.push_back (std::move (reader));
+      return;
+    }
+
   dwarf_decode_lines (cu->line_header, fnd, cu, nullptr, lowpc,
 		      decode_mapping);
-
 }
 
 /* Process DW_TAG_compile_unit or DW_TAG_partial_unit.  */
@@ -13078,7 +14095,7 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
     }
 
   /* Ignore functions with missing or invalid low and high pc attributes.  */
-  if (dwarf2_get_pc_bounds (die, &lowpc, &highpc, cu, NULL)
+  if (dwarf2_get_pc_bounds (die, &lowpc, &highpc, cu, false)
       <= PC_BOUNDS_INVALID)
     {
       attr = dwarf2_attr (die, DW_AT_external, cu);
@@ -13251,7 +14268,7 @@ read_lexical_block_scope (struct die_info *die, struct dwarf2_cu *cu)
      as multiple lexical blocks?  Handling children in a sane way would
      be nasty.  Might be easier to properly extend generic blocks to
      describe ranges.  */
-  switch (dwarf2_get_pc_bounds (die, &lowpc, &highpc, cu, NULL))
+  switch (dwarf2_get_pc_bounds (die, &lowpc, &highpc, cu, false))
     {
     case PC_BOUNDS_NOT_PRESENT:
       /* DW_TAG_lexical_block has no attributes, process its children as if
@@ -13496,7 +14513,7 @@ read_call_site_scope (struct die_info *die, struct dwarf2_cu *cu)
 	  CORE_ADDR lowpc;
 
 	  /* DW_AT_entry_pc should be preferred.  */
-	  if (dwarf2_get_pc_bounds (target_die, &lowpc, NULL, target_cu, NULL)
+	  if (dwarf2_get_pc_bounds (target_die, &lowpc, NULL, target_cu, false)
 	      <= PC_BOUNDS_INVALID)
 	    complaint (_("DW_AT_call_target target DIE has invalid "
 			 "low pc, for referencing DIE %s [in module %s]"),
@@ -13997,17 +15014,14 @@ dwarf2_ranges_process (unsigned offset, struct dwarf2_cu *cu, dwarf_tag tag,
 
 /* Get low and high pc attributes from DW_AT_ranges attribute value OFFSET.
    Return 1 if the attributes are present and valid, otherwise, return 0.
-   If RANGES_PST is not NULL we should set up the `psymtabs_addrmap'.  */
+   If RECORD_RANGES is true, also record the ranges in the psymtab address
+   map, see dwarf2_psymtab_record_range.  */
 
 static int
 dwarf2_ranges_read (unsigned offset, CORE_ADDR *low_return,
 		    CORE_ADDR *high_return, struct dwarf2_cu *cu,
-		    dwarf2_psymtab *ranges_pst, dwarf_tag tag)
+		    bool record_ranges, dwarf_tag tag)
 {
-  struct objfile *objfile = cu->per_objfile->objfile;
-  dwarf2_per_bfd *per_bfd = cu->per_objfile->per_bfd;
-  struct gdbarch *gdbarch = objfile->arch ();
-  const CORE_ADDR baseaddr = objfile->text_section_offset ();
   int low_set = 0;
   CORE_ADDR low = 0;
   CORE_ADDR high = 0;
@@ -14016,20 +15030,8 @@ dwarf2_ranges_read (unsigned offset, CORE_ADDR *low_return,
   retval = dwarf2_ranges_process (offset, cu, tag,
     [&] (CORE_ADDR range_beginning, CORE_ADDR range_end)
     {
-      if (ranges_pst != NULL)
-	{
-	  CORE_ADDR lowpc;
-	  CORE_ADDR highpc;
-
-	  lowpc = (gdbarch_adjust_dwarf2_addr (gdbarch,
-					       range_beginning + baseaddr)
-		   - baseaddr);
-	  highpc = (gdbarch_adjust_dwarf2_addr (gdbarch,
-						range_end + baseaddr)
-		    - baseaddr);
-	  addrmap_set_empty (per_bfd->partial_symtabs->psymtabs_addrmap,
-			     lowpc, highpc - 1, ranges_pst);
-	}
+      if (record_ranges)
+	dwarf2_psymtab_record_range (cu, range_beginning, range_end);
 
       /* FIXME: This is recording everything as a low-high
 	 segment of consecutive addresses.  We should have a
@@ -14066,12 +15068,13 @@ dwarf2_ranges_read (unsigned offset, CORE_ADDR *low_return,
 
 /* Get low and high pc attributes from a die.  See enum pc_bounds_kind
    definition for the return value.  *LOWPC and *HIGHPC are set iff
-   neither PC_BOUNDS_NOT_PRESENT nor PC_BOUNDS_INVALID are returned.  */
+   neither PC_BOUNDS_NOT_PRESENT nor PC_BOUNDS_INVALID are returned.
+   RECORD_RANGES is passed to dwarf2_ranges_read.  */
 
 static enum pc_bounds_kind
 dwarf2_get_pc_bounds (struct die_info *die, CORE_ADDR *lowpc,
 		      CORE_ADDR *highpc, struct dwarf2_cu *cu,
-		      dwarf2_psymtab *pst)
+		      bool record_ranges)
 {
   dwarf2_per_objfile *per_objfile = cu->per_objfile;
   struct attribute *attr;
@@ -14114,8 +15117,8 @@ dwarf2_get_pc_bounds (struct die_info *die, CORE_ADDR *lowpc,
 
 	  /* Value of the DW_AT_ranges attribute is the offset in the
 	     .debug_ranges section.  */
-	  if (!dwarf2_ranges_read (ranges_offset, &low, &high, cu, pst,
-				   die->tag))
+	  if (!dwarf2_ranges_read (ranges_offset, &low, &high, cu,
+				   record_ranges, die->tag))
 	    return PC_BOUNDS_INVALID;
 	  /* Found discontinuous range of addresses.  */
 	  ret = PC_BOUNDS_RANGES;
@@ -14158,7 +15161,7 @@ dwarf2_get_subprogram_pc_bounds (struct die_info *die,
   CORE_ADDR low, high;
   struct die_info *child = die->child;
 
-  if (dwarf2_get_pc_bounds (die, &low, &high, cu, NULL) >= PC_BOUNDS_RANGES)
+  if (dwarf2_get_pc_bounds (die, &low, &high, cu, false) >= PC_BOUNDS_RANGES)
     {
       *lowpc = std::min (*lowpc, low);
       *highpc = std::max (*highpc, high);
@@ -14195,7 +15198,7 @@ get_scope_pc_bounds (struct die_info *die,
   CORE_ADDR best_high = (CORE_ADDR) 0;
   CORE_ADDR current_low, current_high;
 
-  if (dwarf2_get_pc_bounds (die, &current_low, &current_high, cu, NULL)
+  if (dwarf2_get_pc_bounds (die, &current_low, &current_high, cu, false)
       >= PC_BOUNDS_RANGES)
     {
       best_low = current_low;
@@ -18837,7 +19840,7 @@ read_full_die_1 (const struct die_reader_specs *reader,
 	   abbrev_number,
 	   bfd_get_filename (abfd));
 
-  die = dwarf_alloc_die (cu, abbrev->num_attrs + num_extra_attrs);
+  die = dwarf_alloc_die (cu, abbrev->num_die_attrs + num_extra_attrs);
   die->sect_off = sect_off;
   die->tag = abbrev->tag;
   die->abbrev = abbrev_number;
@@ -18846,16 +19849,28 @@ read_full_die_1 (const struct die_reader_specs *reader,
   /* Make the result usable.
      The caller needs to update num_attrs after adding the extra
      attributes.  */
-  die->num_attrs = abbrev->num_attrs;
+  die->num_attrs = abbrev->num_die_attrs;
 
   bool any_need_reprocess = false;
+  unsigned int n = 0;
   for (i = 0; i < abbrev->num_attrs; ++i)
     {
-      info_ptr = read_attribute (reader, &die->attrs[i], &abbrev->attrs[i],
+      if (!abbrev_attr_stored_in_die (abbrev->attrs[i].name))
+	{
+	  struct attribute unused;
+
+	  info_ptr = read_attribute (reader, &unused, &abbrev->attrs[i],
+				     info_ptr);
+	  continue;
+	}
+
+      info_ptr = read_attribute (reader, &die->attrs[n], &abbrev->attrs[i],
 				 info_ptr);
-      if (die->attrs[i].requires_reprocessing_p ())
+      if (die->attrs[n].requires_reprocessing_p ())
 	any_need_reprocess = true;
+      ++n;
     }
+  gdb_assert (n == abbrev->num_die_attrs);
 
   struct attribute *attr = die->attr (DW_AT_str_offsets_base);
   if (attr != nullptr && attr->form_is_unsigned ())
@@ -18875,7 +19890,7 @@ read_full_die_1 (const struct die_reader_specs *reader,
 
   if (any_need_reprocess)
     {
-      for (i = 0; i < abbrev->num_attrs; ++i)
+      for (i = 0; i < die->num_attrs; ++i)
 	{
 	  if (die->attrs[i].requires_reprocessing_p ())
 	    read_attribute_reprocess (reader, &die->attrs[i], die->tag);
@@ -19513,9 +20528,12 @@ find_partial_die (sect_offset sect_off, int offset_in_dwz, struct dwarf2_cu *cu)
 	return { cu, pd };
       /* We missed recording what we needed.
 	 Load all dies and try again.  */
+      psymtab_scan_require_main_thread (cu);
     }
   else
     {
+      psymtab_scan_require_main_thread (cu);
+
       /* TUs don't reference other CUs/TUs (except via type signatures).  */
       if (cu->per_cu->is_debug_types)
 	{
@@ -19607,8 +20625,8 @@ guess_partial_die_structure_name (struct partial_die_info *struct_pdi,
 	     (child_pdi->linkage_name));
 	  if (actual_class_name != NULL)
 	    {
-	      struct objfile *objfile = cu->per_objfile->objfile;
-	      struct_pdi->raw_name = objfile->intern (actual_class_name.get ());
+	      struct_pdi->raw_name
+		= dwarf2_intern_name (cu, actual_class_name.get ());
 	      struct_pdi->canonical_name = 1;
 	    }
 	  break;
@@ -19729,8 +20747,7 @@ partial_die_info::fixup (struct dwarf2_cu *cu)
 	  else
 	    base = demangled.get ();
 
-	  struct objfile *objfile = cu->per_objfile->objfile;
-	  raw_name = objfile->intern (base);
+	  raw_name = dwarf2_intern_name (cu, base);
 	  canonical_name = 1;
 	}
     }
@@ -21532,6 +22549,49 @@ dwarf_decode_lines (struct line_header *lh, const file_and_directory &fnd,
     }
 }
 
+/* See dwarf2_line_table_reader.  */
+
+void
+dwarf2_line_table_reader::read_line_tables (struct compunit_symtab *cust)
+{
+  struct objfile *objfile = per_objfile->objfile;
+
+  /* Decoding the line number program only needs a few bits of the CU,
+     so rather than reading it in again, set up a bare one.  */
+  dwarf2_cu cu (per_cu, per_objfile);
+  cu.header = header;
+  cu.producer = producer;
+  cu.str_offsets_base = str_offsets_base;
+
+  line_header_up lh = dwarf_decode_line_header (line_offset, &cu);
+  if (lh == nullptr)
+    return;
+
+  dwarf_read_debug_printf_v ("Reading line table of %s",
+			     sect_offset_str (per_cu->sect_off));
+
+  cu.reopen_symtab_for_lines (cust, name.c_str ());
+
+  /* Map the files of the line header to the symtabs created when the CU
+     was expanded.  */
+  buildsym_compunit *builder = cu.get_builder ();
+  const std::vector<file_entry> &file_names = lh->file_names ();
+  for (int i = 0; i < file_names.size (); ++i)
+    {
+      const file_entry &fe = file_names[i];
+
+      dwarf2_start_subfile (&cu, fe.name, fe.include_dir (lh.get ()));
+      if (i < file_symtabs.size ()
+	  && builder->get_current_subfile ()->symtab == nullptr)
+	builder->get_current_subfile ()->symtab = file_symtabs[i];
+    }
+
+  CORE_ADDR baseaddr = objfile->text_section_offset ();
+  dwarf_decode_lines_1 (lh.get (), &cu, 0, unrelocated_lowpc + baseaddr);
+
+  builder->install_line_tables ();
+}
+
 /* Start a subfile for DWARF.  FILENAME is the name of the file and
    DIRNAME the name of the source directory which contains FILENAME
    or NULL if not known.
@@ -22877,7 +23937,7 @@ dwarf2_canonicalize_name (const char *name, struct dwarf2_cu *cu,
 	= cp_canonicalize_string (name);
 
       if (canon_name != nullptr)
-	name = objfile->intern (canon_name.get ());
+	name = dwarf2_intern_name (cu, canon_name.get ());
     }
 
   return name;
@@ -23172,13 +24232,7 @@ dump_die (struct die_info *die, int max_level)
 static void
 store_in_ref_table (struct die_info *die, struct dwarf2_cu *cu)
 {
-  void **slot;
-
-  slot = htab_find_slot_with_hash (cu->die_hash, die,
-				   to_underlying (die->sect_off),
-				   INSERT);
-
-  *slot = die;
+  cu->add_die (die);
 }
 
 /* Follow reference or signature attribute ATTR of SRC_DIE.
@@ -23214,7 +24268,6 @@ static struct die_info *
 follow_die_offset (sect_offset sect_off, int offset_in_dwz,
 		   struct dwarf2_cu **ref_cu)
 {
-  struct die_info temp_die;
   struct dwarf2_cu *target_cu, *cu = *ref_cu;
   dwarf2_per_objfile *per_objfile = cu->per_objfile;
 
@@ -23271,11 +24324,8 @@ follow_die_offset (sect_offset sect_off, int offset_in_dwz,
     }
 
   *ref_cu = target_cu;
-  temp_die.sect_off = sect_off;
 
-  return (struct die_info *) htab_find_with_hash (target_cu->die_hash,
-						  &temp_die,
-						  to_underlying (sect_off));
+  return target_cu->find_die (sect_off);
 }
 
 /* Follow reference attribute ATTR of SRC_DIE.
@@ -23624,7 +24674,6 @@ static struct die_info *
 follow_die_sig_1 (struct die_info *src_die, struct signatured_type *sig_type,
 		  struct dwarf2_cu **ref_cu)
 {
-  struct die_info temp_die;
   struct dwarf2_cu *sig_cu;
   struct die_info *die;
   dwarf2_per_objfile *per_objfile = (*ref_cu)->per_objfile;
@@ -23647,9 +24696,7 @@ follow_die_sig_1 (struct die_info *src_die, struct signatured_type *sig_type,
   sig_cu = per_objfile->get_cu (sig_type);
   gdb_assert (sig_cu != NULL);
   gdb_assert (to_underlying (sig_type->type_offset_in_section) != 0);
-  temp_die.sect_off = sig_type->type_offset_in_section;
-  die = (struct die_info *) htab_find_with_hash (sig_cu->die_hash, &temp_die,
-						 to_underlying (temp_die.sect_off));
+  die = sig_cu->find_die (sig_type->type_offset_in_section);
   if (die)
     {
       /* For .gdb_index version 7 keep track of included TUs.
@@ -23840,22 +24887,15 @@ read_signatured_type (signatured_type *sig_type,
       struct dwarf2_cu *cu = reader.cu;
       const gdb_byte *info_ptr = reader.info_ptr;
 
-      gdb_assert (cu->die_hash == NULL);
-      cu->die_hash =
-	htab_create_alloc_ex (cu->header.length / 12,
-			      die_hash,
-			      die_eq,
-			      NULL,
-			      &cu->comp_unit_obstack,
-			      hashtab_obstack_allocate,
-			      dummy_obstack_deallocate);
+      gdb_assert (cu->die_index.empty ());
 
       if (reader.comp_unit_die->has_children)
 	reader.comp_unit_die->child
 	  = read_die_and_siblings (&reader, info_ptr, &info_ptr,
 				   reader.comp_unit_die);
       cu->dies = reader.comp_unit_die;
-      /* comp_unit_die is not stored in die_hash, no need.  */
+      /* comp_unit_die is not stored in die_index, no need.  */
+      cu->die_index.shrink_to_fit ();
 
       /* We try not to read any attributes in this function, because
 	 not all CUs needed for references have been loaded yet, and
@@ -24673,9 +25713,54 @@ dwarf2_per_objfile::remove_cu (dwarf2_per_cu_data *per_cu)
   m_dwarf2_cus.erase (it);
 }
 
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::set_preloaded_cu (dwarf2_per_cu_data *per_cu,
+				      dwarf2_cu *cu)
+{
+  gdb_assert (!this->preloaded_cu_p (per_cu));
+
+  m_preloaded_cus[per_cu] = cu;
+}
+
+/* See read.h.  */
+
+dwarf2_cu *
+dwarf2_per_objfile::take_preloaded_cu (dwarf2_per_cu_data *per_cu)
+{
+  auto it = m_preloaded_cus.find (per_cu);
+  if (it == m_preloaded_cus.end ())
+    return nullptr;
+
+  dwarf2_cu *cu = it->second;
+  m_preloaded_cus.erase (it);
+  return cu;
+}
+
+/* See read.h.  */
+
+bool
+dwarf2_per_objfile::preloaded_cu_p (dwarf2_per_cu_data *per_cu) const
+{
+  return m_preloaded_cus.find (per_cu) != m_preloaded_cus.end ();
+}
+
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::remove_all_preloaded_cus ()
+{
+  for (auto pair : m_preloaded_cus)
+    delete pair.second;
+
+  m_preloaded_cus.clear ();
+}
+
 dwarf2_per_objfile::~dwarf2_per_objfile ()
 {
   remove_all_cus ();
+  remove_all_preloaded_cus ();
 }
 
 /* A set of CU "per_cu" pointer, DIE offset, and GDB type pointer.
@@ -24912,6 +25997,18 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("lazy-line-tables", class_obscure,
+			   &dwarf_lazy_line_tables, _("\
+Set whether DWARF line tables are decoded lazily."), _("\
+Show whether DWARF line tables are decoded lazily."), _("\
+When on, the line number program of a compilation unit is only decoded\n\
+when one of its line tables is first needed, instead of when its symbols\n\
+are read in."),
+			   NULL,
+			   show_dwarf_lazy_line_tables,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
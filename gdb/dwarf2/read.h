@@ -22,6 +22,7 @@
 
 #include <queue>
 #include <unordered_map>
+#include "dwarf2/abbrev.h"
 #include "dwarf2/comp-unit-head.h"
 #include "dwarf2/file-and-dir.h"
 #include "dwarf2/index-cache.h"
@@ -410,6 +411,12 @@ struct dwarf2_per_bfd
      are doing.  */
   struct tu_stats tu_stats {};
 
+  /* The abbrev tables of the units of this BFD (and of its dwz file),
+     shared by all the units that use them.  The cache is emptied once
+     the psymtabs are built, and again after an expansion when it has
+     grown too large.  */
+  abbrev_cache abbrev_tables;
+
   /* A table mapping DW_AT_dwo_name values to struct dwo_file objects.
      This is NULL if the table hasn't been allocated yet.  */
   htab_up dwo_files;
@@ -561,6 +568,23 @@ struct dwarf2_per_objfile
   /* Free all cached compilation units.  */
   void remove_all_cus ();
 
+  /* Record CU as holding the DIEs of PER_CU, read ahead of time.  The
+     per-objfile takes ownership of CU until take_preloaded_cu is
+     called.  */
+  void set_preloaded_cu (dwarf2_per_cu_data *per_cu, dwarf2_cu *cu);
+
+  /* If the DIEs of PER_CU were read ahead of time, return the
+     dwarf2_cu holding them and give its ownership to the caller.
+     Otherwise, return NULL.  */
+  dwarf2_cu *take_preloaded_cu (dwarf2_per_cu_data *per_cu);
+
+  /* Return true if the DIEs of PER_CU were read ahead of time.  */
+  bool preloaded_cu_p (dwarf2_per_cu_data *per_cu) const;
+
+  /* Free all the compilation units read ahead of time that were not
+     used.  */
+  void remove_all_preloaded_cus ();
+
   /* Increase the age counter on each CU compilation unit and free
      any that are too old.  */
   void age_comp_units ();
@@ -583,6 +607,10 @@ struct dwarf2_per_objfile
   /* The CU containing the m_builder in scope.  */
   dwarf2_cu *sym_cu = nullptr;
 
+  /* The objects that decode line number programs lazily for the
+     compunit_symtabs of this objfile.  */
+  std::vector<std::unique_ptr<line_table_reader>> line_table_readers;
+
 private:
   /* Hold the corresponding compunit_symtab for each CU or TU.  This
      is indexed by dwarf2_per_cu_data::index.  A NULL value means
@@ -603,6 +631,11 @@ struct dwarf2_per_objfile
   /* Map from the objfile-independent dwarf2_per_cu_data instances to the
      corresponding objfile-dependent dwarf2_cu instances.  */
   std::unordered_map<dwarf2_per_cu_data *, dwarf2_cu *> m_dwarf2_cus;
+
+  /* Same, but for the compilation units whose DIEs were read ahead of
+     time, in parallel, and that load_full_comp_unit has not used yet.
+     These are not subject to aging.  */
+  std::unordered_map<dwarf2_per_cu_data *, dwarf2_cu *> m_preloaded_cus;
 };
 
 /* Get the dwarf2_per_objfile associated to OBJFILE.  */
@@ -156,6 +156,28 @@ typedef void (frame_dealloc_cache_ftype) (struct frame_info *self,
 typedef struct gdbarch *(frame_prev_arch_ftype) (struct frame_info *this_frame,
 						 void **this_prologue_cache);
 
+/* Return true if THIS_FRAME, with the cache THIS_CACHE, may be kept by
+   the frame cache after the inferior runs, to be reused at a later
+   stop if the registers of THIS_FRAME that the unwinder read and the
+   stack of THIS_FRAME did not change.  The cache must not refer to
+   other frames, and must only depend on the frame's PC, on these
+   registers and stack, and on data that does not change while the
+   inferior runs, such as the debug info.  What is read while the
+   unwinder is sniffed is not recorded, so the choice of the unwinder
+   must only depend on the frame's PC and code.  */
+
+typedef bool (frame_can_persist_ftype) (struct frame_info *this_frame,
+					void *this_cache);
+
+/* Copy THIS_CACHE, the cache of a frame of architecture GDBARCH that
+   is kept across stops, to OBSTACK, and return the copy.  The frame
+   then only uses the copy.  Neither THIS_CACHE nor the copy are passed
+   to dealloc_cache.  Must be implemented if can_persist is.  */
+
+typedef void *(frame_copy_cache_ftype) (struct gdbarch *gdbarch,
+					void *this_cache,
+					struct obstack *obstack);
+
 struct frame_unwind
 {
   const char *name;
@@ -171,6 +193,8 @@ struct frame_unwind
   frame_sniffer_ftype *sniffer;
   frame_dealloc_cache_ftype *dealloc_cache;
   frame_prev_arch_ftype *prev_arch;
+  frame_can_persist_ftype *can_persist;
+  frame_copy_cache_ftype *copy_cache;
 };
 
 /* Register a frame unwinder, _prepending_ it to the front of the
@@ -188,8 +188,146 @@ struct frame_info
   /* A frame specific string describing the STOP_REASON in more detail.
      Only valid when PREV_P is set, but even then may still be NULL.  */
   const char *stop_string;
+
+  /* What was recorded while unwinding this frame, so that it can be
+     kept across stops, or NULL.  */
+  struct frame_persist_info *persist;
 };
 
+/* Whether the frame cache keeps frames across stops.  See "maint set
+   frame-cache persist".  */
+static bool frame_cache_persist = true;
+
+/* What was recorded while unwinding a frame, to tell at a later stop
+   whether the frame is still valid.  A frame is the same as long as its
+   PC, the registers its unwinder read, and its stack are the same.  */
+
+struct frame_persist_info
+{
+  /* The architecture and the PC of the frame.  */
+  struct gdbarch *gdbarch = nullptr;
+  CORE_ADDR pc = 0;
+
+  /* The type of the first non-inline frame inner to the frame, which
+     affects the frame's address in block.  */
+  enum frame_type next_type = NORMAL_FRAME;
+
+  /* The number of inline frames between the frame and that first
+     non-inline frame.  They are found by the inline frame sniffer,
+     which does not run when the frame is reused, so the frame can only
+     be reused above as many inline frames.  */
+  int inline_depth = 0;
+
+  /* The registers of the frame read by its unwinder, with their
+     values.  */
+  std::vector<std::pair<int, value_ref_ptr>> registers;
+
+  /* The contents of the stack of the frame, from its stack pointer to
+     its stack address, and the address they start at.  */
+  CORE_ADDR stack_start = 0;
+  gdb::byte_vector stack;
+
+  /* False if some of the above could not be recorded.  */
+  bool complete = true;
+
+  /* True if the stack was recorded.  */
+  bool stack_p = false;
+
+  /* True if the frame was kept the last time the frame cache was
+     flushed.  */
+  bool kept = false;
+
+  /* True if the frame is in the current frame chain.  */
+  bool linked = false;
+
+  /* True if the frame and its prologue cache were copied to one of the
+     persistent obstacks.  */
+  bool copied = false;
+};
+
+/* The frame whose unwinder is running, whose register reads are
+   recorded, or NULL.  */
+static struct frame_info *frame_persist_recording;
+
+/* The frames kept the last time the frame cache was flushed, and the
+   frames that were given a frame_persist_info since then.  */
+static std::vector<frame_info *> frame_persist_frames;
+
+/* The thread of the current frame chain.  */
+static process_stratum_target *frame_chain_target;
+static ptid_t frame_chain_ptid;
+
+/* The frames kept the last time the frame cache was flushed, from the
+   innermost to the outermost, and the thread they belong to.  */
+static std::vector<frame_info *> frame_persist_kept;
+static process_stratum_target *frame_persist_target;
+static ptid_t frame_persist_ptid;
+
+/* Set when the kept frames must not be reused, for instance because
+   objfiles were loaded or unloaded.  Cleared when the frame cache is
+   flushed.  */
+static bool frame_persist_stale;
+
+/* The index in FRAME_PERSIST_KEPT of the frame most likely to be
+   reused next.  */
+static size_t frame_persist_cursor;
+
+/* The kept frames and their prologue caches are copied to one of
+   these obstacks when the frame cache is flushed, so that the frame
+   cache obstack can be freed.  FRAME_PERSIST_OBSTACK_INDEX is the one
+   holding the frames currently kept.  */
+static struct obstack frame_persist_obstacks[2];
+static int frame_persist_obstack_index;
+
+/* Frames whose stack is larger than this are not kept.  */
+static const size_t frame_persist_max_stack_size = 64 * 1024;
+
+/* Statistics for "maint print frame-cache-statistics".  */
+static unsigned int frame_persist_hits;
+static unsigned int frame_persist_misses;
+static unsigned int frame_persist_kept_count;
+
+/* If the unwinder of FRAME, which was just found, lets frames be kept
+   across stops, start recording what the unwinding of FRAME depends
+   on.  */
+
+static void
+frame_persist_start (frame_info *frame)
+{
+  if (frame_cache_persist
+      && frame->level > 0
+      && frame->unwind->can_persist != NULL)
+    {
+      frame->persist = new frame_persist_info;
+      frame_persist_frames.push_back (frame);
+    }
+}
+
+/* Record that the unwinder of FRAME read the register REGNUM of FRAME,
+   and found VAL.  */
+
+static void
+frame_persist_record_register (frame_info *frame, int regnum, value *val)
+{
+  frame_persist_info *persist = frame->persist;
+
+  for (const auto &reg : persist->registers)
+    if (reg.first == regnum)
+      return;
+
+  try
+    {
+      if (value_lazy (val))
+	value_fetch_lazy (val);
+      persist->registers.emplace_back (regnum,
+				       release_value (value_copy (val)));
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      persist->complete = false;
+    }
+}
+
 /* See frame.h.  */
 
 void
@@ -574,9 +712,15 @@ compute_frame_id (struct frame_info *fi)
 
       frame_debug_printf ("fi=%d", fi->level);
 
+      scoped_restore restore_recording
+	= make_scoped_restore (&frame_persist_recording, fi);
+
       /* Find the unwinder.  */
       if (fi->unwind == NULL)
-	frame_unwind_find_by_frame (fi, &fi->prologue_cache);
+	{
+	  frame_unwind_find_by_frame (fi, &fi->prologue_cache);
+	  frame_persist_start (fi);
+	}
 
       /* Find THIS frame's ID.  */
       /* Default to outermost if no ID is found.  */
@@ -1231,9 +1375,22 @@ frame_unwind_register_value (frame_info *next_frame, int regnum)
     frame_unwind_find_by_frame (next_frame, &next_frame->prologue_cache);
 
   /* Ask this frame to unwind its register.  */
-  value *value = next_frame->unwind->prev_register (next_frame,
-						    &next_frame->prologue_cache,
-						    regnum);
+  value *value;
+  {
+    scoped_restore restore_recording
+      = make_scoped_restore (&frame_persist_recording, next_frame);
+
+    value = next_frame->unwind->prev_register (next_frame,
+					       &next_frame->prologue_cache,
+					       regnum);
+  }
+
+  /* If the unwinder of NEXT_FRAME's previous frame is reading this
+     register, record its value.  */
+  if (frame_persist_recording != NULL
+      && frame_persist_recording->next == next_frame
+      && frame_persist_recording->persist != NULL)
+    frame_persist_record_register (frame_persist_recording, regnum, value);
 
   if (frame_debug)
     {
@@ -1657,8 +1814,14 @@ get_current_frame (void)
     validate_registers_access ();
 
   if (sentinel_frame == NULL)
-    sentinel_frame =
-      create_sentinel_frame (current_program_space, get_current_regcache ());
+    {
+      struct regcache *regcache = get_current_regcache ();
+
+      sentinel_frame = create_sentinel_frame (current_program_space,
+					      regcache);
+      frame_chain_target = regcache->target ();
+      frame_chain_ptid = regcache->ptid ();
+    }
 
   /* Set the current frame before computing the frame id, to avoid
      recursion inside compute_frame_id, in case the frame's
@@ -2009,6 +2172,37 @@ frame_observer_target_changed (struct target_ops *target)
   reinit_frame_cache ();
 }
 
+/* Deallocate the unwinder and frame base caches of FI.  The prologue
+   cache of a frame that was kept across stops is a copy, which is not
+   deallocated.  */
+
+static void
+frame_dealloc_caches (struct frame_info *fi)
+{
+  if (fi->prologue_cache && fi->unwind->dealloc_cache
+      && (fi->persist == NULL || !fi->persist->copied))
+    fi->unwind->dealloc_cache (fi, fi->prologue_cache);
+  if (fi->base_cache && fi->base->unwind->dealloc_cache)
+    fi->base->unwind->dealloc_cache (fi, fi->base_cache);
+}
+
+/* Return true if FI, a frame of the current frame chain, can be kept
+   across stops.  */
+
+static bool
+frame_persist_keep_p (struct frame_info *fi)
+{
+  return (fi->persist != NULL
+	  && fi->persist->complete
+	  && fi->persist->stack_p
+	  && fi->level > 0
+	  && fi->this_id.p == frame_id_status::COMPUTED
+	  && fi->unwind != NULL
+	  && fi->unwind->type == NORMAL_FRAME
+	  && fi->unwind->can_persist != NULL
+	  && fi->unwind->can_persist (fi, fi->prologue_cache));
+}
+
 /* Flush the entire frame cache.  */
 
 void
@@ -2018,18 +2212,116 @@ reinit_frame_cache (void)
 
   ++frame_cache_generation;
 
-  /* Tear down all frame caches.  */
+  /* Find the frames of the chain that are linked in, and those that
+     can be kept.  */
+  for (frame_info *frame : frame_persist_frames)
+    {
+      frame->persist->linked = false;
+      frame->persist->kept = false;
+    }
+
+  std::vector<frame_info *> kept;
+  bool keep_p = frame_cache_persist && !frame_persist_stale;
+  struct frame_info *outermost = NULL;
+
   for (fi = sentinel_frame; fi != NULL; fi = fi->prev)
     {
-      if (fi->prologue_cache && fi->unwind->dealloc_cache)
-	fi->unwind->dealloc_cache (fi, fi->prologue_cache);
-      if (fi->base_cache && fi->base->unwind->dealloc_cache)
-	fi->base->unwind->dealloc_cache (fi, fi->base_cache);
+      if (fi->level >= 0
+	  && fi->this_id.p == frame_id_status::COMPUTED
+	  && fi->this_id.value.stack_status == FID_STACK_VALID)
+	outermost = fi;
+
+      if (fi->persist != NULL)
+	{
+	  fi->persist->linked = true;
+	  if (keep_p && frame_persist_keep_p (fi))
+	    {
+	      fi->persist->kept = true;
+	      kept.push_back (fi);
+	    }
+	}
     }
 
-  /* Since we can't really be sure what the first object allocated was.  */
+  /* The frames kept at the previous flush that were not reused, and
+     are outer to the chain, are most likely still valid: the chain
+     often only covers the innermost frames, for instance when the
+     inferior stopped in the middle of a "next".  */
+  bool same_thread_p = (frame_chain_target == frame_persist_target
+			&& frame_chain_ptid == frame_persist_ptid);
+  bool carry_over_p = keep_p && (kept.empty () || same_thread_p);
+
+  if (!kept.empty ())
+    {
+      frame_persist_target = frame_chain_target;
+      frame_persist_ptid = frame_chain_ptid;
+    }
+
+  for (frame_info *frame : frame_persist_kept)
+    if (carry_over_p
+	&& !frame->persist->linked
+	&& (outermost == NULL
+	    || gdbarch_inner_than (frame->persist->gdbarch,
+				   outermost->this_id.value.stack_addr,
+				   frame->this_id.value.stack_addr)))
+      {
+	frame->persist->kept = true;
+	kept.push_back (frame);
+      }
+
+  /* Tear down all frame caches, but those of the kept frames.  The
+     frames kept at the previous flush that were not reused are not in
+     the chain.  */
+  for (fi = sentinel_frame; fi != NULL; fi = fi->prev)
+    if (fi->persist == NULL || !fi->persist->kept)
+      frame_dealloc_caches (fi);
+  for (frame_info *frame : frame_persist_kept)
+    if (!frame->persist->linked && !frame->persist->kept)
+      frame_dealloc_caches (frame);
+
+  for (frame_info *frame : frame_persist_frames)
+    if (!frame->persist->kept)
+      {
+	delete frame->persist;
+	frame->persist = NULL;
+      }
+
+  /* Copy the kept frames to the other persistent obstack.  The frame
+     base is chosen again if a kept frame is reused.  */
+  struct obstack *persist_obstack
+    = &frame_persist_obstacks[!frame_persist_obstack_index];
+  for (frame_info *&frame : kept)
+    {
+      if (frame->base_cache && frame->base->unwind->dealloc_cache)
+	frame->base->unwind->dealloc_cache (frame, frame->base_cache);
+
+      frame_info *copy = XOBNEW (persist_obstack, struct frame_info);
+      *copy = *frame;
+      copy->prologue_cache
+	= frame->unwind->copy_cache (frame->persist->gdbarch,
+				     frame->prologue_cache, persist_obstack);
+      copy->base = NULL;
+      copy->base_cache = NULL;
+      copy->next = NULL;
+      copy->prev_p = false;
+      copy->prev = NULL;
+      copy->stop_string = NULL;
+      copy->persist->linked = false;
+      copy->persist->copied = true;
+      frame = copy;
+    }
+
+  frame_persist_frames = kept;
+  frame_persist_kept = std::move (kept);
+  frame_persist_cursor = 0;
+  frame_persist_stale = false;
+  frame_persist_kept_count = frame_persist_kept.size ();
+
+  /* Nothing refers to the frames of the previous stops anymore.  */
   obstack_free (&frame_cache_obstack, 0);
   obstack_init (&frame_cache_obstack);
+  obstack_free (&frame_persist_obstacks[frame_persist_obstack_index], 0);
+  obstack_init (&frame_persist_obstacks[frame_persist_obstack_index]);
+  frame_persist_obstack_index = !frame_persist_obstack_index;
 
   if (sentinel_frame != NULL)
     annotate_frames_invalid ();
@@ -2070,6 +2362,193 @@ frame_register_unwind_location (struct frame_info *this_frame, int regnum,
     }
 }
 
+/* Record the PC and the stack of FRAME, whose ID was just computed, so
+   that FRAME can be kept across stops.  */
+
+static void
+frame_persist_record_stack (struct frame_info *frame)
+{
+  frame_persist_info *persist = frame->persist;
+  const frame_id &id = frame->this_id.value;
+
+  if (!persist->complete
+      || id.stack_status != FID_STACK_VALID
+      || get_frame_type (frame) != NORMAL_FRAME)
+    return;
+
+  /* The stack pointer is read as part of what the unwinding of FRAME
+     depends on.  */
+  scoped_restore restore_recording
+    = make_scoped_restore (&frame_persist_recording, frame);
+
+  try
+    {
+      struct gdbarch *gdbarch = get_frame_arch (frame);
+      CORE_ADDR sp = get_frame_sp (frame);
+
+      if (sp != id.stack_addr
+	  && !gdbarch_inner_than (gdbarch, sp, id.stack_addr))
+	return;
+
+      CORE_ADDR start = std::min (sp, id.stack_addr);
+      CORE_ADDR end = std::max (sp, id.stack_addr);
+      if (end - start > frame_persist_max_stack_size)
+	return;
+
+      struct frame_info *next = frame->next;
+      int inline_depth = 0;
+      while (get_frame_type (next) == INLINE_FRAME)
+	{
+	  next = next->next;
+	  inline_depth++;
+	}
+
+      persist->gdbarch = gdbarch;
+      persist->pc = get_frame_pc (frame);
+      persist->next_type = get_frame_type (next);
+      persist->inline_depth = inline_depth;
+      persist->stack_start = start;
+      persist->stack.resize (end - start);
+      read_memory (start, persist->stack.data (), persist->stack.size ());
+      persist->stack_p = true;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      persist->complete = false;
+    }
+}
+
+/* Return true if FI, a frame kept from a previous stop, is still valid
+   as the previous frame of NEXT_FRAME: the registers that its unwinder
+   read, as unwound by NEXT_FRAME, and its stack did not change.  */
+
+static bool
+frame_persist_valid_p (struct frame_info *fi, struct frame_info *next_frame)
+{
+  frame_persist_info *persist = fi->persist;
+
+  try
+    {
+      for (const auto &reg : persist->registers)
+	{
+	  value *val = frame_unwind_register_value (next_frame, reg.first);
+	  const value *old_val = reg.second.get ();
+
+	  if (value_lazy (val))
+	    value_fetch_lazy (val);
+
+	  LONGEST len = TYPE_LENGTH (value_type (val));
+	  if (len != TYPE_LENGTH (value_type (old_val))
+	      || !value_contents_eq (val, 0, old_val, 0, len))
+	    return false;
+	}
+
+      gdb::byte_vector stack (persist->stack.size ());
+      read_memory (persist->stack_start, stack.data (), stack.size ());
+      return stack == persist->stack;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return false;
+    }
+}
+
+/* If a frame kept from a previous stop is still valid as the previous
+   frame of THIS_FRAME, link it in and return it.  Otherwise return
+   NULL.  */
+
+static struct frame_info *
+frame_persist_reuse (struct frame_info *this_frame)
+{
+  if (!frame_cache_persist
+      || frame_persist_stale
+      || frame_persist_kept.empty ()
+      || this_frame->level < 0
+      || frame_chain_target != frame_persist_target
+      || frame_chain_ptid != frame_persist_ptid)
+    return NULL;
+
+  CORE_ADDR pc;
+  struct gdbarch *gdbarch;
+
+  try
+    {
+      pc = frame_unwind_pc (this_frame);
+      gdbarch = frame_unwind_arch (this_frame);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return NULL;
+    }
+
+  struct frame_info *next = this_frame;
+  int inline_depth = 0;
+  while (get_frame_type (next) == INLINE_FRAME)
+    {
+      next = next->next;
+      inline_depth++;
+    }
+  enum frame_type next_type = get_frame_type (next);
+
+  /* Start with the frame after the last one reused; when unwinding an
+     unchanged part of the stack, that is the one.  */
+  size_t count = frame_persist_kept.size ();
+  for (size_t i = 0; i < count; i++)
+    {
+      size_t index = (frame_persist_cursor + i) % count;
+      struct frame_info *fi = frame_persist_kept[index];
+      frame_persist_info *persist = fi->persist;
+
+      if (persist->linked
+	  || persist->pc != pc
+	  || persist->gdbarch != gdbarch
+	  || persist->next_type != next_type
+	  || persist->inline_depth != inline_depth
+	  || fi->pspace != this_frame->pspace
+	  || fi->aspace != this_frame->aspace)
+	continue;
+
+      /* A frame with the same ID in the chain is a cycle, which the
+	 normal unwinding reports.  */
+      if (!frame_persist_valid_p (fi, this_frame)
+	  || frame_stash_find (fi->this_id.value) != NULL)
+	{
+	  frame_persist_misses++;
+	  continue;
+	}
+
+      fi->level = this_frame->level + 1;
+      fi->next = this_frame;
+      fi->prev_p = false;
+      fi->prev = NULL;
+      fi->stop_reason = UNWIND_NO_REASON;
+      fi->stop_string = NULL;
+
+      /* The PC, function and architecture of the frame before FI were
+	 not validated, so compute them again.  */
+      fi->prev_arch.p = false;
+      fi->prev_pc.status = CC_UNKNOWN;
+      fi->prev_pc.masked = false;
+      fi->prev_func.status = CC_UNKNOWN;
+      fi->prev_func.addr = 0;
+
+      this_frame->prev = fi;
+      persist->linked = true;
+
+      bool stashed = frame_stash_add (fi);
+      gdb_assert (stashed);
+
+      frame_persist_cursor = index + 1;
+      frame_persist_hits++;
+
+      frame_debug_printf ("  -> %s // kept", fi->to_string ().c_str ());
+
+      return fi;
+    }
+
+  return NULL;
+}
+
 /* Get the previous raw frame, and check that it is not identical to
    same other frame frame already in the chain.  If it is, there is
    most likely a stack cycle, so we discard it, and mark THIS_FRAME as
@@ -2092,7 +2571,12 @@ frame_register_unwind_location (struct frame_info *this_frame, int regnum,
 static struct frame_info *
 get_prev_frame_maybe_check_cycle (struct frame_info *this_frame)
 {
-  struct frame_info *prev_frame = get_prev_frame_raw (this_frame);
+  /* Reuse a frame kept from a previous stop if it is still valid.  */
+  struct frame_info *prev_frame = frame_persist_reuse (this_frame);
+  if (prev_frame != NULL)
+    return prev_frame;
+
+  prev_frame = get_prev_frame_raw (this_frame);
 
   /* Don't compute the frame id of the current frame yet.  Unwinding
      the sentinel frame can fail (e.g., if the thread is gone and we
@@ -2158,6 +2642,8 @@ get_prev_frame_maybe_check_cycle (struct frame_info *this_frame)
 	  this_frame->prev = NULL;
 	  prev_frame = NULL;
 	}
+      else if (prev_frame->persist != NULL)
+	frame_persist_record_stack (prev_frame);
     }
   catch (const gdb_exception &ex)
     {
@@ -2244,9 +2730,14 @@ get_prev_frame_always_1 (struct frame_info *this_frame)
 
   /* Check that this frame is unwindable.  If it isn't, don't try to
      unwind to the prev frame.  */
-  this_frame->stop_reason
-    = this_frame->unwind->stop_reason (this_frame,
-				       &this_frame->prologue_cache);
+  {
+    scoped_restore restore_recording
+      = make_scoped_restore (&frame_persist_recording, this_frame);
+
+    this_frame->stop_reason
+      = this_frame->unwind->stop_reason (this_frame,
+					 &this_frame->prologue_cache);
+  }
 
   if (this_frame->stop_reason != UNWIND_NO_REASON)
     {
@@ -2937,8 +3428,13 @@ frame_unwind_arch (struct frame_info *next_frame)
 	frame_unwind_find_by_frame (next_frame, &next_frame->prologue_cache);
 
       if (next_frame->unwind->prev_arch != NULL)
-	arch = next_frame->unwind->prev_arch (next_frame,
-					      &next_frame->prologue_cache);
+	{
+	  scoped_restore restore_recording
+	    = make_scoped_restore (&frame_persist_recording, next_frame);
+
+	  arch = next_frame->unwind->prev_arch (next_frame,
+						&next_frame->prologue_cache);
+	}
       else
 	arch = get_frame_arch (next_frame);
 
@@ -3122,6 +3618,51 @@ frame_prepare_for_sniffer (struct frame_info *frame,
   frame->unwind = unwind;
 }
 
+/* The new_objfile and free_objfile observers.  The kept frames may
+   depend on the symbols and unwind info of the objfiles.  */
+
+static void
+frame_persist_objfiles_changed (struct objfile *objfile)
+{
+  frame_persist_stale = true;
+}
+
+/* Implement "maint set frame-cache persist".  */
+
+static void
+set_frame_cache_persist (const char *args, int from_tty,
+			 struct cmd_list_element *c)
+{
+  frame_persist_stale = true;
+}
+
+/* Implement "maint show frame-cache persist".  */
+
+static void
+show_frame_cache_persist (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether frames are kept across stops is %s.\n"),
+		    value);
+}
+
+/* Implement "maint print frame-cache-statistics".  */
+
+static void
+maintenance_print_frame_cache_statistics (const char *args, int from_tty)
+{
+  printf_filtered (_("Frame cache statistics:\n"));
+  printf_filtered (_("  frames kept at the last flush: %u\n"),
+		   frame_persist_kept_count);
+  printf_filtered (_("  kept frames reused: %u\n"), frame_persist_hits);
+  printf_filtered (_("  kept frames found invalid: %u\n"),
+		   frame_persist_misses);
+}
+
+static struct cmd_list_element *set_frame_cache_cmdlist;
+static struct cmd_list_element *show_frame_cache_cmdlist;
+
 static struct cmd_list_element *set_backtrace_cmdlist;
 static struct cmd_list_element *show_backtrace_cmdlist;
 
@@ -3161,11 +3702,48 @@ void
 _initialize_frame ()
 {
   obstack_init (&frame_cache_obstack);
+  obstack_init (&frame_persist_obstacks[0]);
+  obstack_init (&frame_persist_obstacks[1]);
 
   frame_stash_create ();
 
   gdb::observers::target_changed.attach (frame_observer_target_changed,
 					 "frame");
+  gdb::observers::new_objfile.attach (frame_persist_objfiles_changed,
+				      "frame");
+  gdb::observers::free_objfile.attach (frame_persist_objfiles_changed,
+				       "frame");
+
+  add_setshow_prefix_cmd ("frame-cache", class_maintenance,
+			  _("\
+Set frame cache specific variables."),
+			  _("\
+Show frame cache specific variables."),
+			  &set_frame_cache_cmdlist, &show_frame_cache_cmdlist,
+			  &maintenance_set_cmdlist, &maintenance_show_cmdlist);
+
+  add_setshow_boolean_cmd ("persist", class_maintenance,
+			   &frame_cache_persist, _("\
+Set whether frames are kept across stops."), _("\
+Show whether frames are kept across stops."), _("\
+When enabled, the frames other than the innermost one are kept when the\n\
+inferior runs.  At the next stop, a kept frame is reused as the caller\n\
+of a frame if it is at the same PC, if the registers its unwinder read\n\
+still have the same values, and if its stack did not change.  This\n\
+saves unwinding the outer frames again when only the innermost frames\n\
+changed, as when stepping."),
+			   set_frame_cache_persist,
+			   show_frame_cache_persist,
+			   &set_frame_cache_cmdlist,
+			   &show_frame_cache_cmdlist);
+
+  add_cmd ("frame-cache-statistics", class_maintenance,
+	   maintenance_print_frame_cache_statistics, _("\
+Print statistics about the frames kept across stops.\n\
+Print how many frames were kept the last time the frame cache was\n\
+flushed, how many kept frames were reused, and how many were found\n\
+invalid."),
+	   &maintenanceprintlist);
 
   add_setshow_prefix_cmd ("backtrace", class_maintenance,
 			  _("\
@@ -46,6 +46,7 @@
 #include "location.h"
 #include "gdbsupport/function-view.h"
 #include "gdbsupport/def-vector.h"
+#include "gdbsupport/pathstuff.h"
 #include <algorithm>
 #include "inferior.h"
 
@@ -149,6 +150,9 @@ struct linespec_state
      space.  */
   struct program_space *search_pspace;
 
+  /* If not NULL, the search is restricted to just these objfiles.  */
+  const std::vector<objfile *> *search_objfiles;
+
   /* The default symtab to use, if no other symtab is specified.  */
   struct symtab *default_symtab;
 
@@ -363,7 +367,7 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct linespec_state *state);
 
 static std::vector<block_symbol> *find_label_symbols
   (struct linespec_state *self, std::vector<block_symbol> *function_symbols,
@@ -396,7 +400,7 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct linespec_state *state);
 
 static std::vector<symtab_and_line> decode_digits_ordinary
   (struct linespec_state *self,
@@ -1143,6 +1147,26 @@ maybe_add_address (htab_t set, struct program_space *pspace, CORE_ADDR addr)
   return 1;
 }
 
+/* Call CALLBACK for each objfile of the current program space that
+   STATE searches.  */
+
+static void
+iterate_over_search_objfiles (struct linespec_state *state,
+			      gdb::function_view<void (objfile *)> callback)
+{
+  if (state->search_objfiles == nullptr)
+    {
+      for (objfile *objfile : current_program_space->objfiles ())
+	callback (objfile);
+    }
+  else
+    {
+      for (objfile *objfile : *state->search_objfiles)
+	if (objfile->pspace == current_program_space)
+	  callback (objfile);
+    }
+}
+
 /* A helper that walks over all matching symtabs in all objfiles and
    calls CALLBACK for each symbol matching NAME.  If SEARCH_PSPACE is
    not NULL, then the search is restricted to just that program
@@ -1167,7 +1191,7 @@ iterate_over_all_matching_symtabs
 
       set_current_program_space (pspace);
 
-      for (objfile *objfile : current_program_space->objfiles ())
+      iterate_over_search_objfiles (state, [&] (objfile *objfile)
 	{
 	  objfile->expand_symtabs_matching (NULL, &lookup_name, NULL, NULL,
 					    (SEARCH_GLOBAL_BLOCK
@@ -1205,7 +1229,7 @@ iterate_over_all_matching_symtabs
 		    }
 		}
 	    }
-	}
+	});
     }
 }
 
@@ -2127,7 +2151,7 @@ create_sals_line_offset (struct linespec_state *self,
       initialize_defaults (&self->default_symtab, &self->default_line);
       *ls->file_symtabs
 	= collect_symtabs_from_filename (self->default_symtab->filename,
-					 self->search_pspace);
+					 self);
       use_default = 1;
     }
 
@@ -2410,7 +2434,7 @@ convert_explicit_location_to_linespec (struct linespec_state *self,
       try
 	{
 	  *result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2635,7 +2659,7 @@ parse_linespec (linespec_parser *parser, const char *arg,
 	{
 	  *PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser));
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3310,6 +3334,37 @@ decode_line_1 (const struct event_location *location, int flags,
 
 /* See linespec.h.  */
 
+bool
+location_found_in_objfiles (const struct event_location *location,
+			    int flags,
+			    struct program_space *search_pspace,
+			    const std::vector<objfile *> &objfiles)
+{
+  if (objfiles.empty ())
+    return false;
+
+  linespec_parser parser (flags, current_language,
+			  search_pspace, NULL, 0, NULL);
+  PARSER_STATE (&parser)->search_objfiles = &objfiles;
+
+  scoped_restore_current_program_space restore_pspace;
+
+  try
+    {
+      return !event_location_to_sals (&parser, location).empty ();
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* Nothing was found in OBJFILES.  Any other error may not be
+	 specific to OBJFILES, so be conservative.  */
+      if (except.error == NOT_FOUND_ERROR)
+	return false;
+      return true;
+    }
+}
+
+/* See linespec.h.  */
+
 std::vector<symtab_and_line>
 decode_line_with_current_source (const char *string, int flags)
 {
@@ -3787,18 +3842,51 @@ symtab_collector::operator () (struct symtab *symtab)
 
 } // namespace
 
+/* Find the symtabs of the current program space matching FILE that
+   STATE searches, and call COLLECTOR for each of them.  */
+
+static void
+collect_pspace_symtabs_from_filename (const char *file,
+				      struct linespec_state *state,
+				      symtab_collector &collector)
+{
+  if (state->search_objfiles == nullptr)
+    {
+      iterate_over_symtabs (file, collector);
+      return;
+    }
+
+  /* As in iterate_over_symtabs, but only for the objfiles searched:
+     first the expanded symtabs, then the others.  */
+  gdb::unique_xmalloc_ptr<char> real_path;
+  if (IS_ABSOLUTE_PATH (file))
+    real_path = gdb_realpath (file);
+
+  iterate_over_search_objfiles (state, [&] (objfile *objfile)
+    {
+      iterate_over_objfile_symtabs (objfile, file, real_path.get (),
+				    collector);
+    });
+  iterate_over_search_objfiles (state, [&] (objfile *objfile)
+    {
+      objfile->map_symtabs_matching_filename (file, real_path.get (),
+					      collector);
+    });
+}
+
 /* Given a file name, return a list of all matching symtabs.  If
-   SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   STATE->SEARCH_PSPACE is not NULL, the search is restricted to just
+   that program space.  If STATE->SEARCH_OBJFILES is not NULL, the
+   search is restricted to just these objfiles.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct linespec_state *state)
 {
   symtab_collector collector;
 
   /* Find that file's data.  */
-  if (search_pspace == NULL)
+  if (state->search_pspace == NULL)
     {
       for (struct program_space *pspace : program_spaces)
 	{
@@ -3806,27 +3894,28 @@ collect_symtabs_from_filename (const char *file,
 	    continue;
 
 	  set_current_program_space (pspace);
-	  iterate_over_symtabs (file, collector);
+	  collect_pspace_symtabs_from_filename (file, state, collector);
 	}
     }
   else
     {
-      set_current_program_space (search_pspace);
-      iterate_over_symtabs (file, collector);
+      set_current_program_space (state->search_pspace);
+      collect_pspace_symtabs_from_filename (file, state, collector);
     }
 
   return collector.release_symtabs ();
 }
 
-/* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+/* Return all the symtabs associated to the FILENAME.  If
+   STATE->SEARCH_PSPACE is not NULL, the search is restricted to just
+   that program space.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct linespec_state *state)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, state);
 
   if (result.empty ())
     {
@@ -4321,7 +4410,7 @@ search_minsyms_for_name (struct collect_info *info,
 
 	  set_current_program_space (pspace);
 
-	  for (objfile *objfile : current_program_space->objfiles ())
+	  iterate_over_search_objfiles (info->state, [&] (objfile *objfile)
 	    {
 	      iterate_over_minimal_symbols (objfile, name,
 					    [&] (struct minimal_symbol *msym)
@@ -4331,7 +4420,7 @@ search_minsyms_for_name (struct collect_info *info,
 							  &minsyms);
 					      return false;
 					    });
-	    }
+	    });
 	}
     }
   else
@@ -18,6 +18,7 @@
 #define LINESPEC_H 1
 
 struct symtab;
+struct objfile;
 
 #include "location.h"
 
@@ -85,6 +86,17 @@ extern std::vector<symtab_and_line>
 		       struct program_space *search_pspace,
 		       struct symtab *default_symtab, int default_line);
 
+/* Return true if decoding LOCATION, a linespec or explicit location,
+   as decode_line_1 would with FLAGS and SEARCH_PSPACE, but looking
+   only at the symbols and source files of OBJFILES, finds anything.
+   When it doesn't, OBJFILES have no part in the result of decoding
+   LOCATION.  */
+
+extern bool location_found_in_objfiles
+  (const struct event_location *location, int flags,
+   struct program_space *search_pspace,
+   const std::vector<objfile *> &objfiles);
+
 /* Parse LOCATION and return results.  This is the "full"
    interface to this module, which handles multiple results
    properly.
@@ -107,7 +107,9 @@ output_nondebug_symbol (ui_out *uiout,
 /* This is the guts of the commands '-symbol-info-functions',
    '-symbol-info-variables', and '-symbol-info-types'.  It searches for
    symbols matching KING, NAME_REGEXP, TYPE_REGEXP, and EXCLUDE_MINSYMS,
-   and then prints the matching [m]symbols in an MI structured format.  */
+   and then prints the matching [m]symbols in an MI structured format.
+   When SYMBOL_SEARCH_STREAMING is set, the matches of each objfile are
+   printed as soon as they are found.  */
 
 static void
 mi_symbol_info (enum search_domain kind, const char *name_regexp,
@@ -118,54 +120,81 @@ mi_symbol_info (enum search_domain kind, const char *name_regexp,
   sym_search.set_symbol_type_regexp (type_regexp);
   sym_search.set_exclude_minsyms (exclude_minsyms);
   sym_search.set_max_search_results (max_results);
-  std::vector<symbol_search> symbols = sym_search.search ();
   ui_out *uiout = current_uiout;
-  int i = 0;
 
-  ui_out_emit_tuple outer_symbols_emitter (uiout, "symbols");
+  /* The searcher validates the regexps before finding any match, so
+     nothing is printed if they are invalid.  */
+  gdb::optional<ui_out_emit_tuple> outer_symbols_emitter;
+  gdb::optional<ui_out_emit_list> debug_symbols_list_emitter;
+  gdb::optional<ui_out_emit_list> nondebug_symbols_list_emitter;
 
-  /* Debug symbols are placed first. */
-  if (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+  auto output_symbols = [&] (std::vector<symbol_search> &symbols)
     {
-      ui_out_emit_list debug_symbols_list_emitter (uiout, "debug");
+      size_t i = 0;
 
-      /* As long as we have debug symbols...  */
-      while (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+      if (!outer_symbols_emitter.has_value ())
+	outer_symbols_emitter.emplace (uiout, "symbols");
+
+      /* Debug symbols are placed first. */
+      if (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
 	{
-	  symtab *symtab = symbol_symtab (symbols[i].symbol);
-	  ui_out_emit_tuple symtab_tuple_emitter (uiout, nullptr);
+	  if (!debug_symbols_list_emitter.has_value ())
+	    debug_symbols_list_emitter.emplace (uiout, "debug");
+
+	  /* As long as we have debug symbols...  */
+	  while (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+	    {
+	      symtab *symtab = symbol_symtab (symbols[i].symbol);
+	      ui_out_emit_tuple symtab_tuple_emitter (uiout, nullptr);
 
-	  uiout->field_string ("filename",
-			       symtab_to_filename_for_display (symtab));
-	  uiout->field_string ("fullname", symtab_to_fullname (symtab));
+	      uiout->field_string ("filename",
+				   symtab_to_filename_for_display (symtab));
+	      uiout->field_string ("fullname", symtab_to_fullname (symtab));
 
-	  ui_out_emit_list symbols_list_emitter (uiout, "symbols");
+	      ui_out_emit_list symbols_list_emitter (uiout, "symbols");
 
-	  /* As long as we have debug symbols from this symtab...  */
-	  for (; (i < symbols.size ()
-		  && symbols[i].msymbol.minsym == nullptr
-		  && symbol_symtab (symbols[i].symbol) == symtab);
-	       ++i)
-	    {
-	      symbol_search &s = symbols[i];
+	      /* As long as we have debug symbols from this symtab...  */
+	      for (; (i < symbols.size ()
+		      && symbols[i].msymbol.minsym == nullptr
+		      && symbol_symtab (symbols[i].symbol) == symtab);
+		   ++i)
+		{
+		  symbol_search &s = symbols[i];
 
-	      output_debug_symbol (uiout, kind, s.symbol, s.block);
+		  output_debug_symbol (uiout, kind, s.symbol, s.block);
+		}
 	    }
 	}
-    }
-
-  /* Non-debug symbols are placed after.  */
-  if (i < symbols.size ())
-    {
-      ui_out_emit_list nondebug_symbols_list_emitter (uiout, "nondebug");
 
-      /* As long as we have nondebug symbols...  */
-      for (; i < symbols.size (); i++)
+      /* Non-debug symbols are placed after.  */
+      if (i < symbols.size ())
 	{
-	  gdb_assert (symbols[i].msymbol.minsym != nullptr);
-	  output_nondebug_symbol (uiout, symbols[i].msymbol);
+	  debug_symbols_list_emitter.reset ();
+	  if (!nondebug_symbols_list_emitter.has_value ())
+	    nondebug_symbols_list_emitter.emplace (uiout, "nondebug");
+
+	  /* As long as we have nondebug symbols...  */
+	  for (; i < symbols.size (); i++)
+	    {
+	      gdb_assert (symbols[i].msymbol.minsym != nullptr);
+	      output_nondebug_symbol (uiout, symbols[i].msymbol);
+	    }
 	}
+
+      return true;
+    };
+
+  if (symbol_search_streaming)
+    sym_search.search (output_symbols);
+  else
+    {
+      std::vector<symbol_search> symbols = sym_search.search ();
+      output_symbols (symbols);
     }
+
+  /* The "symbols" tuple is output even when nothing matched.  */
+  if (!outer_symbols_emitter.has_value ())
+    outer_symbols_emitter.emplace (uiout, "symbols");
 }
 
 /* Helper to parse the option text from an -max-results argument and return
@@ -574,6 +574,42 @@ iterate_over_minimal_symbols
 
 /* See minsyms.h.  */
 
+void
+iterate_over_minimal_symbol_candidates
+    (struct objfile *objf, const lookup_name_info &lookup_name,
+     gdb::function_view<bool (struct minimal_symbol *)> callback)
+{
+  objfile_per_bfd_storage *per_bfd = objf->per_bfd;
+  minimal_symbol *msymbols = per_bfd->msymbols.get ();
+
+  /* The index is sorted according to the case sensitivity setting, so
+     it must be rebuilt if that changes.  */
+  std::unique_ptr<symbol_name_index> &index = per_bfd->msymbol_name_index;
+  if (index == nullptr || !index->valid_p ())
+    {
+      index.reset (new symbol_name_index);
+      for (int i = 0; i < per_bfd->minimal_symbol_count; ++i)
+	index->add (msymbols[i].natural_name (), msymbols[i].language (), i);
+      index->finish ();
+    }
+
+  std::vector<unsigned> candidates;
+  if (index->find_candidates (lookup_name, candidates))
+    {
+      for (unsigned idx : candidates)
+	if (callback (&msymbols[idx]))
+	  return;
+    }
+  else
+    {
+      for (minimal_symbol *msymbol : objf->msymbols ())
+	if (callback (msymbol))
+	  return;
+    }
+}
+
+/* See minsyms.h.  */
+
 bound_minimal_symbol
 lookup_minimal_symbol_linkage (const char *name, struct objfile *objf)
 {
@@ -1452,6 +1488,7 @@ minimal_symbol_reader::install ()
 
       m_objfile->per_bfd->minimal_symbol_count = mcount;
       m_objfile->per_bfd->msymbols = std::move (msym_holder);
+      m_objfile->per_bfd->msymbol_name_index.reset ();
 
 #if CXX_STD_THREAD
       /* Mutex that is used when modifying or accessing the demangled
@@ -1474,7 +1511,8 @@ minimal_symbol_reader::install ()
 		 {
 		   /* This will be freed later, by compute_and_set_names.  */
 		   gdb::unique_xmalloc_ptr<char> demangled_name
-		     = symbol_find_demangled_name (msym, msym->linkage_name ());
+		     = symbol_find_demangled_name (msym, msym->linkage_name (),
+						   m_objfile->per_bfd);
 		   msym->set_demangled_name
 		     (demangled_name.release (),
 		      &m_objfile->per_bfd->storage_obstack);
@@ -289,6 +289,18 @@ void iterate_over_minimal_symbols
     (struct objfile *objf, const lookup_name_info &name,
      gdb::function_view<bool (struct minimal_symbol *)> callback);
 
+/* Call CALLBACK for the minimal symbols of the objfile OBJF whose
+   natural name may match LOOKUP_NAME, in table order.  This uses a
+   sorted index of the names, built on first use, so unlike walking
+   all the minimal symbols its cost depends on the number of
+   candidates.  CALLBACK may be called for symbols that don't match,
+   so it must check the name itself.  Iteration stops if CALLBACK
+   returns true.  */
+
+void iterate_over_minimal_symbol_candidates
+    (struct objfile *objf, const lookup_name_info &lookup_name,
+     gdb::function_view<bool (struct minimal_symbol *)> callback);
+
 /* Compute the upper bound of MINSYM.  The upper bound is the last
    address thought to be part of the symbol.  If the symbol has a
    size, it is used.  Otherwise use the lesser of the next minimal
@@ -54,6 +54,7 @@
 #include "btrace.h"
 #include "gdbsupport/pathstuff.h"
 #include "stack.h"
+#include "demangle-cache.h"
 
 #include <algorithm>
 #include <vector>
@@ -115,6 +116,11 @@ get_objfile_pspace_data (struct program_space *pspace)
 
 static const struct bfd_key<objfile_per_bfd_storage> objfiles_bfd_data;
 
+objfile_per_bfd_storage::objfile_per_bfd_storage (bfd *bfd)
+  : minsyms_read (false), m_bfd (bfd)
+{
+}
+
 objfile_per_bfd_storage::~objfile_per_bfd_storage ()
 {
 }
@@ -476,6 +482,7 @@ objfile::make (bfd *bfd_, const char *name_, objfile_flags flags_,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->new_objfiles_available = 1;
+  invalidate_compunit_pc_index (current_program_space);
 
   return result;
 }
@@ -606,6 +613,7 @@ objfile::~objfile ()
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (pspace)->section_map_dirty = 1;
+  invalidate_compunit_pc_index (pspace);
 }
 
 
@@ -661,8 +669,10 @@ objfile_relocate1 (struct objfile *objfile,
 	  {
 	    struct linetable *l;
 
-	    /* First the line table.  */
-	    l = SYMTAB_LINETABLE (s);
+	    /* First the line table.  Line tables that have not been
+	       read in yet will be read with the new offsets, so don't
+	       force them to be read here.  */
+	    l = s->linetable;
 	    if (l)
 	      {
 		for (int i = 0; i < l->nitems; ++i)
@@ -727,6 +737,7 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  invalidate_compunit_pc_index (objfile->pspace);
 
   /* Update the table in exec_ops, used to read memory.  */
   struct obj_section *s;
@@ -1262,13 +1273,15 @@ pc_in_section (CORE_ADDR pc, const char *name)
 
 
 /* Set section_map_dirty so section map will be rebuilt next time it
-   is used.  Called by reread_symbols.  */
+   is used, and likewise for the compunit PC index.  Called by
+   reread_symbols.  */
 
 void
 objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+  invalidate_compunit_pc_index (current_program_space);
 }
 
 /* See comments in objfiles.h.  */
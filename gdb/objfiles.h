@@ -38,8 +38,10 @@
 #include "gdbsupport/refcounted-object.h"
 #include "jit.h"
 #include "quick-symbol.h"
+#include "symbol-name-index.h"
 #include <forward_list>
 
+class bfd_demangle_cache;
 struct htab;
 struct objfile_data;
 struct partial_symbol;
@@ -233,9 +235,7 @@ struct minimal_symbol_iterator
 
 struct objfile_per_bfd_storage
 {
-  objfile_per_bfd_storage (bfd *bfd)
-    : minsyms_read (false), m_bfd (bfd)
-  {}
+  objfile_per_bfd_storage (bfd *bfd);
 
   ~objfile_per_bfd_storage ();
 
@@ -286,6 +286,11 @@ struct objfile_per_bfd_storage
 
   htab_up demangled_names_hash;
 
+  /* The entries of the demangle cache for this BFD, or NULL if the
+     demangle cache is not used.  See demangle-cache.h.  */
+
+  std::unique_ptr<bfd_demangle_cache> demangle_cache;
+
   /* The per-objfile information about the entry point, the scope (file/func)
      containing the entry point, and the scope of the user's main() func.  */
 
@@ -341,6 +346,12 @@ struct objfile_per_bfd_storage
      hash table.  */
   std::bitset<nr_languages> demangled_hash_languages;
 
+  /* An index of the natural names of the minimal symbols, by their
+     position in MSYMBOLS.  It is built on demand, see
+     iterate_over_minimal_symbol_candidates.  */
+
+  std::unique_ptr<symbol_name_index> msymbol_name_index;
+
 private:
   /* The BFD this object is associated to.  */
 
@@ -36,6 +36,7 @@
 #include "gdbcmd.h"
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 
 static struct partial_symbol *lookup_partial_symbol (struct objfile *,
 						     struct partial_symtab *,
@@ -71,6 +72,7 @@ psymtab_storage::install_psymtab (partial_symtab *pst)
 {
   pst->next = psymtabs;
   psymtabs = pst;
+  name_index.reset ();
 }
 
 
@@ -1091,6 +1093,79 @@ recursively_search_psymtabs
   return result == PST_SEARCHED_AND_FOUND;
 }
 
+/* Return true if PS, or one of its shared dependencies, is in
+   MAY_MATCH with a true value.  MAY_MATCH also memoizes the result
+   for each psymtab.  */
+
+static bool
+psymtab_may_match (partial_symtab *ps,
+		   std::unordered_map<partial_symtab *, bool> &may_match)
+{
+  auto iter = may_match.find (ps);
+  if (iter != may_match.end ())
+    return iter->second;
+
+  /* Guard against cycles.  */
+  may_match[ps] = false;
+
+  for (int i = 0; i < ps->number_of_dependencies; ++i)
+    if (ps->dependencies[i]->user != NULL
+	&& psymtab_may_match (ps->dependencies[i], may_match))
+      {
+	may_match[ps] = true;
+	return true;
+      }
+
+  return false;
+}
+
+/* Mark the psymtabs of PARTIAL_SYMTABS that can't hold a partial
+   symbol matching LOOKUP_NAME, neither themselves nor through their
+   shared dependencies, as already searched, so that
+   recursively_search_psymtabs does not walk their symbols.  This uses
+   the name index of PARTIAL_SYMTABS, which is built on first use.  */
+
+static void
+skip_non_matching_psymtabs (psymtab_storage *partial_symtabs,
+			    const lookup_name_info &lookup_name)
+{
+  std::unique_ptr<symbol_name_index> &index = partial_symtabs->name_index;
+  std::vector<partial_symtab *> &psymtabs
+    = partial_symtabs->name_index_psymtabs;
+
+  /* The index is sorted according to the case sensitivity setting, so
+     it must be rebuilt if that changes.  */
+  if (index == nullptr || !index->valid_p ())
+    {
+      index.reset (new symbol_name_index);
+      psymtabs.clear ();
+      for (partial_symtab *ps : partial_symtabs->range ())
+	{
+	  unsigned idx = psymtabs.size ();
+	  psymtabs.push_back (ps);
+	  for (partial_symbol *psym : ps->global_psymbols)
+	    index->add (psym->ginfo.search_name (), psym->ginfo.language (),
+			idx);
+	  for (partial_symbol *psym : ps->static_psymbols)
+	    index->add (psym->ginfo.search_name (), psym->ginfo.language (),
+			idx);
+	}
+      index->finish ();
+    }
+
+  std::vector<unsigned> candidates;
+  if (!index->find_candidates (lookup_name, candidates))
+    return;
+
+  std::unordered_map<partial_symtab *, bool> may_match;
+  for (unsigned idx : candidates)
+    may_match[psymtabs[idx]] = true;
+
+  for (partial_symtab *ps : partial_symtabs->range ())
+    if (!psymtab_may_match (ps, may_match))
+      ps->searched_flag = PST_SEARCHED_AND_NOT_FOUND;
+}
+
 /* Psymtab version of expand_symtabs_matching.  See its definition in
    the definition of quick_symbol_functions in symfile.h.  */
 
@@ -1111,7 +1186,11 @@ psymbol_functions::expand_symtabs_matching
 
   gdb::optional<lookup_name_info> psym_lookup_name;
   if (lookup_name != nullptr)
-    psym_lookup_name = lookup_name->make_ignore_params ();
+    {
+      psym_lookup_name = lookup_name->make_ignore_params ();
+      skip_non_matching_psymtabs (m_partial_symtabs.get (),
+				  *psym_lookup_name);
+    }
 
   /* This invariant is documented in quick-functions.h.  */
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
@@ -1353,6 +1432,8 @@ partial_symtab::add_psymbol (const partial_symbol &psymbol,
   if (where == psymbol_placement::GLOBAL && !added)
     return;
 
+  partial_symtabs->name_index.reset ();
+
   /* Save pointer to partial symbol in psymtab, growing symtab if needed.  */
   std::vector<partial_symbol *> &list
     = (where == psymbol_placement::STATIC
@@ -1467,6 +1548,7 @@ psymtab_storage::discard_psymtab (struct partial_symtab *pst)
     prev_pst = &((*prev_pst)->next);
   (*prev_pst) = pst->next;
   delete pst;
+  name_index.reset ();
 }
 
 
@@ -24,6 +24,7 @@
 #include "symfile.h"
 #include "gdbsupport/next-iterator.h"
 #include "bcache.h"
+#include "symbol-name-index.h"
 
 struct partial_symbol;
 
@@ -137,6 +138,15 @@ class psymtab_storage
 
   psymbol_bcache psymbol_cache;
 
+  /* An index of the search names of the partial symbols, by the
+     position of their psymtab in NAME_INDEX_PSYMTABS.  It is built on
+     demand by psymbol_functions::expand_symtabs_matching, and
+     discarded whenever a psymtab or a partial symbol is added or
+     removed.  */
+
+  std::unique_ptr<symbol_name_index> name_index;
+  std::vector<partial_symtab *> name_index_psymtabs;
+
 private:
 
   /* The obstack where allocations are made.  This is lazily allocated
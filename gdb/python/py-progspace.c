@@ -440,6 +440,72 @@ pspy_find_pc_line (PyObject *o, PyObject *args)
   return result;
 }
 
+/* Return a new reference to a dictionary holding the counters of
+   STATS, or NULL with a Python error set.  */
+
+static gdbpy_ref<>
+symbol_cache_statistics_to_dict (const symbol_cache_statistics &stats)
+{
+  gdbpy_ref<> dict (PyDict_New ());
+  if (dict == NULL)
+    return NULL;
+
+  const std::pair<const char *, unsigned int> counters[] = {
+    { "size", stats.size },
+    { "hits", stats.hits },
+    { "not_found_hits", stats.not_found_hits },
+    { "misses", stats.misses },
+    { "evictions", stats.evictions },
+    { "resizes", stats.resizes },
+  };
+
+  for (const auto &counter : counters)
+    {
+      gdbpy_ref<> value = gdb_py_object_from_ulongest (counter.second);
+      if (value == NULL
+	  || PyDict_SetItemString (dict.get (), counter.first,
+				   value.get ()) < 0)
+	return NULL;
+    }
+
+  return dict;
+}
+
+/* Implementation of symbol_cache_statistics (self) -> Dictionary.
+   Returns the usage statistics of the symbol cache of this program
+   space, or None if it has no symbol cache.  */
+
+static PyObject *
+pspy_symbol_cache_statistics (PyObject *o, PyObject *args)
+{
+  pspace_object *self = (pspace_object *) o;
+  symbol_cache_statistics global_stats, static_stats;
+
+  PSPY_REQUIRE_VALID (self);
+
+  if (!get_symbol_cache_statistics (self->pspace, &global_stats,
+				    &static_stats))
+    Py_RETURN_NONE;
+
+  gdbpy_ref<> result (PyDict_New ());
+  if (result == NULL)
+    return NULL;
+
+  gdbpy_ref<> global_dict = symbol_cache_statistics_to_dict (global_stats);
+  if (global_dict == NULL
+      || PyDict_SetItemString (result.get (), "global",
+			       global_dict.get ()) < 0)
+    return NULL;
+
+  gdbpy_ref<> static_dict = symbol_cache_statistics_to_dict (static_stats);
+  if (static_dict == NULL
+      || PyDict_SetItemString (result.get (), "static",
+			       static_dict.get ()) < 0)
+    return NULL;
+
+  return result.release ();
+}
+
 /* Implementation of is_valid (self) -> Boolean.
    Returns True if this program space still exists in GDB.  */
 
@@ -555,6 +621,9 @@ Return the name of the shared library holding a given address, or None." },
   { "find_pc_line", pspy_find_pc_line, METH_VARARGS,
     "find_pc_line (pc) -> Symtab_and_line.\n\
 Return the gdb.Symtab_and_line object corresponding to the pc value." },
+  { "symbol_cache_statistics", pspy_symbol_cache_statistics, METH_NOARGS,
+    "symbol_cache_statistics () -> Dictionary.\n\
+Return the usage statistics of the symbol cache, or None." },
   { "is_valid", pspy_is_valid, METH_NOARGS,
     "is_valid () -> Boolean.\n\
 Return true if this program space is valid, false if not." },
@@ -21,6 +21,7 @@
 #include "ser-event.h"
 #if CXX_STD_THREAD
 #include <mutex>
+#include <thread>
 #endif
 #include "gdbsupport/event-loop.h"
 
@@ -38,6 +39,10 @@ static std::vector<std::function<void ()>> runnables;
 
 static std::mutex runnable_mutex;
 
+/* The main thread's thread id.  */
+
+static std::thread::id main_thread_id;
+
 #endif
 
 /* Run all the queued runnables.  */
@@ -89,10 +94,26 @@ run_on_main_thread (std::function<void ()> &&func)
   serial_event_set (runnable_event);
 }
 
+/* See run-on-main-thread.h.  */
+
+bool
+is_main_thread ()
+{
+#if CXX_STD_THREAD
+  return std::this_thread::get_id () == main_thread_id;
+#else
+  return true;
+#endif
+}
+
 void _initialize_run_on_main_thread ();
 void
 _initialize_run_on_main_thread ()
 {
+#if CXX_STD_THREAD
+  main_thread_id = std::this_thread::get_id ();
+#endif
+
   runnable_event = make_serial_event ();
   add_file_handler (serial_event_fd (runnable_event), run_events, nullptr,
 		    "run-on-main-thread");
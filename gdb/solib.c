@@ -644,6 +644,11 @@ free_so (struct so_list *so)
 }
 
 
+/* If true, the debug info of shared libraries is only read when some
+   lookup first needs it, instead of when the library is loaded.  */
+
+static bool lazy_solib_symbols = false;
+
 /* Read in symbols for shared object SO.  If SYMFILE_VERBOSE is set in FLAGS,
    be chatty about it.  Return true if any symbols were actually loaded.  */
 
@@ -663,6 +668,8 @@ solib_read_symbols (struct so_list *so, symfile_add_flags flags)
     {
 
       flags |= current_inferior ()->symfile_flags;
+      if (lazy_solib_symbols)
+	flags |= SYMFILE_NO_READ;
 
       try
 	{
@@ -998,7 +1005,7 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 	}
 
     if (loaded_any_symbols)
-      breakpoint_re_set ();
+      breakpoint_re_set_objfiles ();
 
     if (from_tty && pattern && ! any_matches)
       printf_unfiltered
@@ -1417,6 +1424,15 @@ gdb_sysroot_changed (const char *ignored, int from_tty,
   reload_shared_libraries (ignored, from_tty, e);
 }
 
+static void
+show_lazy_solib_symbols (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Lazy reading of shared library debug "
+			    "information is %s.\n"),
+		    value);
+}
+
 static void
 show_auto_solib_add (struct ui_file *file, int from_tty,
 		     struct cmd_list_element *c, const char *value)
@@ -1695,6 +1711,19 @@ inferior.  Otherwise, symbols must be loaded manually, using \
 			   show_auto_solib_add,
 			   &setlist, &showlist);
 
+  add_setshow_boolean_cmd ("lazy-solib-symbols", class_support,
+			   &lazy_solib_symbols, _("\
+Set lazy reading of shared library debug information."), _("\
+Show lazy reading of shared library debug information."), _("\
+If \"on\", the debug information of a shared library is not read when\n\
+the library is loaded, but the first time a symbol lookup needs it.\n\
+Lookups by address only read the library containing the address.\n\
+This makes loading many shared libraries faster when only a few of\n\
+them are actually inspected."),
+			   NULL,
+			   show_lazy_solib_symbols,
+			   &setlist, &showlist);
+
   set_show_commands sysroot_cmds
     = add_setshow_optional_filename_cmd ("sysroot", class_support,
 					 &gdb_sysroot, _("\
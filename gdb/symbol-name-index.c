@@ -0,0 +1,329 @@
+/* Sorted index of symbol names for GDB.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "symbol-name-index.h"
+#include "symtab.h"
+#include "cp-support.h"
+#include "safe-ctype.h"
+#include "gdbsupport/selftest.h"
+#include <algorithm>
+
+/* Return true if the names of language LANG can be put in the
+   index.  These are the languages that use the default symbol name
+   matcher, plus C++, whose components are handled.  */
+
+static bool
+indexed_language_p (enum language lang)
+{
+  switch (lang)
+    {
+    case language_unknown:
+    case language_auto:
+    case language_c:
+    case language_cplus:
+    case language_asm:
+    case language_minimal:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Return the part of LOOKUP_NAME that a matching name must start
+   with, literally (up to case), at the start of one of its
+   components.
+
+   The symbol name matchers skip whitespace next to punctuation, and
+   C++ ABI tags, so the key stops at the first character that is
+   not part of an identifier or a scope operator.  Names with ABI tags
+   are not indexed, see symbol_name_index::add.  */
+
+static std::string
+lookup_key (const char *lookup_name)
+{
+  while (ISSPACE (*lookup_name) || *lookup_name == ':')
+    ++lookup_name;
+
+  const char *end = lookup_name;
+  while (ISALNUM (*end) || *end == '_' || *end == '$'
+	 || *end == ':' || *end == '.' || *end == '~')
+    ++end;
+
+  return std::string (lookup_name, end - lookup_name);
+}
+
+symbol_name_index::symbol_name_index ()
+  : m_casing (case_sensitivity)
+{
+}
+
+/* See symbol-name-index.h.  */
+
+void
+symbol_name_index::add (const char *name, enum language lang, unsigned idx)
+{
+  gdb_assert (!m_finished);
+
+  if (!indexed_language_p (lang) || strchr (name, '[') != nullptr)
+    {
+      if (m_unindexed.empty () || m_unindexed.back () != idx)
+	m_unindexed.push_back (idx);
+      return;
+    }
+
+  m_languages.set (lang);
+
+  /* Only C++ names match at the start of their components; for the
+     other languages, the whole name is matched.  */
+  if (lang == language_cplus && strstr (name, "::") != nullptr)
+    {
+      unsigned int previous_len = 0;
+      for (unsigned int current_len = cp_find_first_component (name);
+	   name[current_len] != '\0';
+	   current_len += cp_find_first_component (name + current_len))
+	{
+	  gdb_assert (name[current_len] == ':');
+	  m_components.push_back ({ name + previous_len, idx });
+	  /* Skip the '::'.  */
+	  current_len += 2;
+	  previous_len = current_len;
+	}
+      m_components.push_back ({ name + previous_len, idx });
+    }
+  else
+    m_components.push_back ({ name, idx });
+}
+
+/* See symbol-name-index.h.  */
+
+void
+symbol_name_index::finish ()
+{
+  gdb_assert (!m_finished);
+
+  m_casing = case_sensitivity;
+  auto *name_cmp = m_casing == case_sensitive_on ? strcmp : strcasecmp;
+
+  std::sort (m_components.begin (), m_components.end (),
+	     [&] (const component &left, const component &right)
+	     {
+	       return name_cmp (left.name, right.name) < 0;
+	     });
+  m_components.shrink_to_fit ();
+
+  std::sort (m_unindexed.begin (), m_unindexed.end ());
+  m_unindexed.erase (std::unique (m_unindexed.begin (), m_unindexed.end ()),
+		     m_unindexed.end ());
+  m_unindexed.shrink_to_fit ();
+
+  m_finished = true;
+}
+
+/* See symbol-name-index.h.  */
+
+bool
+symbol_name_index::valid_p () const
+{
+  return m_finished && m_casing == case_sensitivity;
+}
+
+/* See symbol-name-index.h.  */
+
+bool
+symbol_name_index::find_candidates (const lookup_name_info &lookup_name,
+				    std::vector<unsigned> &result) const
+{
+  if (!valid_p ())
+    return false;
+
+  /* In Ada mode, a verbatim lookup name makes all the languages use
+     the Ada matcher, see language_defn::get_symbol_name_matcher.  */
+  if (current_language->la_language == language_ada)
+    return false;
+
+  /* The lookup name may be different for each language.  */
+  std::vector<std::string> keys;
+  for (int i = 0; i < nr_languages; ++i)
+    {
+      if (!m_languages.test (i))
+	continue;
+
+      std::string key
+	= lookup_key (lookup_name.language_lookup_name ((enum language) i));
+      if (key.empty ())
+	return false;
+      if (std::find (keys.begin (), keys.end (), key) == keys.end ())
+	keys.push_back (std::move (key));
+    }
+
+  auto *name_cmp = m_casing == case_sensitive_on ? strcmp : strcasecmp;
+  auto *name_ncmp = m_casing == case_sensitive_on ? strncmp : strncasecmp;
+
+  size_t first = result.size ();
+  for (const std::string &key : keys)
+    {
+      auto iter
+	= std::lower_bound (m_components.begin (), m_components.end (),
+			    key.c_str (),
+			    [&] (const component &elem, const char *name)
+			    {
+			      return name_cmp (elem.name, name) < 0;
+			    });
+      for (; (iter != m_components.end ()
+	      && name_ncmp (iter->name, key.c_str (), key.size ()) == 0);
+	   ++iter)
+	result.push_back (iter->idx);
+    }
+
+  result.insert (result.end (), m_unindexed.begin (), m_unindexed.end ());
+
+  std::sort (result.begin () + first, result.end ());
+  result.erase (std::unique (result.begin () + first, result.end ()),
+		result.end ());
+  return true;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Check that the index returns at least all the names that match,
+   using the real symbol name matchers, and not too many more.  */
+
+static void
+test_symbol_name_index ()
+{
+  struct test_name
+  {
+    const char *name;
+    enum language lang;
+  };
+
+  static const test_name names[] = {
+    { "func", language_c },
+    { "function", language_c },
+    { "other_func", language_c },
+    { "Func", language_c },
+    { "func.cold", language_minimal },
+    { "ns::func(int)", language_cplus },
+    { "ns::function", language_cplus },
+    { "ns::inner::func", language_cplus },
+    { "ns2::func<ns::inner>::method(char const*)", language_cplus },
+    { "A::~A()", language_cplus },
+    { "A::operator<(A const&)", language_cplus },
+    { "(anonymous namespace)::func", language_cplus },
+    { "tagged[abi:cxx11](int)", language_cplus },
+    { "pck__func", language_ada },
+  };
+
+  symbol_name_index index;
+  for (unsigned i = 0; i < ARRAY_SIZE (names); ++i)
+    index.add (names[i].name, names[i].lang, i);
+  index.finish ();
+
+  /* Return the items that may match LOOKUP, as a bitmask, or -1 if the
+     index can't tell.  */
+  auto candidates = [&] (const lookup_name_info &lookup)
+    {
+      std::vector<unsigned> result;
+      if (!index.find_candidates (lookup, result))
+	return -1;
+      int mask = 0;
+      for (unsigned idx : result)
+	mask |= 1 << idx;
+      return mask;
+    };
+
+  /* Return the items that do match LOOKUP, as a bitmask.  */
+  auto matches = [&] (const lookup_name_info &lookup)
+    {
+      int mask = 0;
+      for (unsigned i = 0; i < ARRAY_SIZE (names); ++i)
+	{
+	  symbol_name_matcher_ftype *matcher
+	    = language_def (names[i].lang)->get_symbol_name_matcher (lookup);
+	  if (matcher (names[i].name, lookup, nullptr))
+	    mask |= 1 << i;
+	}
+      return mask;
+    };
+
+  /* The items that always are candidates.  */
+  const int unindexed = (1 << 12) | (1 << 13);
+
+  auto check = [&] (const char *name, symbol_name_match_type match_type,
+		    bool completion_mode, int expected)
+    {
+      lookup_name_info lookup (name, match_type, completion_mode);
+      int found = candidates (lookup);
+      SELF_CHECK (found == (expected | unindexed));
+      SELF_CHECK ((found & matches (lookup)) == matches (lookup));
+    };
+
+  check ("func", symbol_name_match_type::WILD, true,
+	 (1 << 0) | (1 << 1) | (1 << 4) | (1 << 5) | (1 << 6) | (1 << 7)
+	 | (1 << 8) | (1 << 11));
+  check ("func", symbol_name_match_type::FULL, false,
+	 (1 << 0) | (1 << 1) | (1 << 4) | (1 << 5) | (1 << 6) | (1 << 7)
+	 | (1 << 8) | (1 << 11));
+  check ("ns::func(int", symbol_name_match_type::FULL, true,
+	 (1 << 5) | (1 << 6));
+  check ("::ns::f", symbol_name_match_type::FULL, true,
+	 (1 << 5) | (1 << 6));
+  check ("inner::func", symbol_name_match_type::WILD, false, 1 << 7);
+  check ("method", symbol_name_match_type::WILD, true, 1 << 8);
+  check ("~A", symbol_name_match_type::WILD, true, 1 << 9);
+  check ("operator <", symbol_name_match_type::WILD, true, 1 << 10);
+  check ("other", symbol_name_match_type::FULL, true, 1 << 2);
+
+  /* An empty lookup name matches everything.  */
+  lookup_name_info empty ("", symbol_name_match_type::FULL, true);
+  SELF_CHECK (candidates (empty) == -1);
+
+  /* The index is sorted for a given case sensitivity.  */
+  scoped_restore restore_casing
+    = make_scoped_restore (&case_sensitivity, case_sensitive_off);
+  SELF_CHECK (!index.valid_p ());
+
+  symbol_name_index nocase_index;
+  for (unsigned i = 0; i < ARRAY_SIZE (names); ++i)
+    nocase_index.add (names[i].name, names[i].lang, i);
+  nocase_index.finish ();
+
+  std::vector<unsigned> result;
+  lookup_name_info upper ("FUNC", symbol_name_match_type::FULL, false);
+  SELF_CHECK (nocase_index.find_candidates (upper, result));
+  SELF_CHECK (std::find (result.begin (), result.end (), 0) != result.end ());
+  SELF_CHECK (std::find (result.begin (), result.end (), 3) != result.end ());
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void _initialize_symbol_name_index ();
+void
+_initialize_symbol_name_index ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("symbol_name_index",
+			    selftests::test_symbol_name_index);
+#endif
+}
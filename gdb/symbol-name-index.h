@@ -0,0 +1,105 @@
+/* Sorted index of symbol names for GDB.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SYMBOL_NAME_INDEX_H
+#define SYMBOL_NAME_INDEX_H
+
+#include "language.h"
+#include <bitset>
+#include <vector>
+
+class lookup_name_info;
+
+/* A sorted index of the names of a set of items -- symbols, or
+   symbol tables holding symbols -- used to quickly find the items
+   whose names may match a lookup name, instead of trying all of them.
+   This is what makes completion fast on programs with millions of
+   symbols.
+
+   Like the name component table of the DWARF indexes, the index holds
+   every component of a C++ name ("ns::func" is found as "ns::func"
+   and "func"), so that wild matching works.  Items whose names can't
+   be indexed this way (names of other languages, whose matching rules
+   are more involved) are kept on the side and are candidates for any
+   lookup.
+
+   The index is a superset filter: it returns the items that may
+   match, and the caller still has to check the names with the
+   language's symbol name matcher.
+
+   An item is identified by an unsigned number chosen by the owner of
+   the index; several names may be added for the same item.  */
+
+class symbol_name_index
+{
+public:
+  symbol_name_index ();
+
+  DISABLE_COPY_AND_ASSIGN (symbol_name_index);
+
+  /* Add NAME, a name of language LANG, for the item IDX.  NAME must
+     outlive the index.  */
+  void add (const char *name, enum language lang, unsigned idx);
+
+  /* Sort the index.  This must be called after all the names have been
+     added, and before the index is searched.  */
+  void finish ();
+
+  /* Return true if the index was sorted using the current case
+     sensitivity setting, and so can be searched.  */
+  bool valid_p () const;
+
+  /* If the index can tell which items may match LOOKUP_NAME, append
+     them to RESULT, in increasing order and without duplicates, and
+     return true.  Otherwise, for example if the lookup name is empty,
+     return false; then any item may match.  */
+  bool find_candidates (const lookup_name_info &lookup_name,
+			std::vector<unsigned> &result) const;
+
+  /* Return the number of entries in the index, for statistics.  */
+  size_t size () const
+  {
+    return m_components.size () + m_unindexed.size ();
+  }
+
+private:
+  /* A name component, and the item it belongs to.  */
+  struct component
+  {
+    const char *name;
+    unsigned idx;
+  };
+
+  /* The sorted name components.  */
+  std::vector<component> m_components;
+
+  /* The items that have names that are not in M_COMPONENTS.  */
+  std::vector<unsigned> m_unindexed;
+
+  /* The languages of the names in M_COMPONENTS.  */
+  std::bitset<nr_languages> m_languages;
+
+  /* The case sensitivity setting M_COMPONENTS is sorted for.  */
+  enum case_sensitivity m_casing;
+
+  /* True once finish has been called.  */
+  bool m_finished = false;
+};
+
+#endif /* SYMBOL_NAME_INDEX_H */
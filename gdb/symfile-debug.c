@@ -442,6 +442,26 @@ objfile::find_pc_sect_compunit_symtab (struct bound_minimal_symbol msymbol,
 		      host_address_to_string (section),
 		      warn_if_readin);
 
+  /* If the partial symbols have not been read yet (see "set
+     lazy-solib-symbols"), don't read them just to find out that PC is
+     in some other objfile.  */
+  if ((flags & OBJF_PSYMTABS_READ) == 0)
+    {
+      struct obj_section *pc_section
+	= section != nullptr ? section : find_pc_section (pc);
+      struct objfile *owner = (separate_debug_objfile_backlink != nullptr
+			       ? separate_debug_objfile_backlink : this);
+
+      if (pc_section != nullptr && pc_section->objfile != owner)
+	{
+	  if (debug_symfile)
+	    fprintf_filtered (gdb_stdlog,
+			      "qf->find_pc_sect_compunit_symtab (...) ="
+			      " NULL (pc not in objfile)\n");
+	  return nullptr;
+	}
+    }
+
   for (const auto &iter : qf)
     {
       retval = iter->find_pc_sect_compunit_symtab (this, msymbol, pc, section,
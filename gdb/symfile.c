@@ -61,6 +61,7 @@
 #include "gdbsupport/selftest.h"
 #include "cli/cli-style.h"
 #include "gdbsupport/forward-scope-exit.h"
+#include "demangle-cache.h"
 
 #include <sys/types.h>
 #include <fcntl.h>
@@ -768,6 +769,8 @@ default_symfile_segments (bfd *abfd)
 static void
 read_symbols (struct objfile *objfile, symfile_add_flags add_flags)
 {
+  global_demangle_cache.load (objfile->per_bfd);
+
   (*objfile->sf->sym_read) (objfile, add_flags);
   objfile->per_bfd->minsyms_read = true;
 
@@ -792,6 +795,8 @@ read_symbols (struct objfile *objfile, symfile_add_flags add_flags)
     }
   if ((add_flags & SYMFILE_NO_READ) == 0)
     objfile->require_partial_symbols (false);
+
+  global_demangle_cache.store (objfile->per_bfd);
 }
 
 /* Initialize entry point information for this objfile.  */
@@ -1004,7 +1009,7 @@ finish_new_objfile (struct objfile *objfile, symfile_add_flags add_flags)
     }
   else if ((add_flags & SYMFILE_DEFER_BP_RESET) == 0)
     {
-      breakpoint_re_set ();
+      breakpoint_re_set_objfiles ();
     }
 
   /* We're done reading the symbol file; finish off complaints.  */
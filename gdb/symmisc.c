@@ -120,6 +120,10 @@ dump_objfile (struct objfile *objfile)
   printf_filtered (", %d minsyms\n\n",
 		   objfile->per_bfd->minimal_symbol_count);
 
+  /* See "set lazy-solib-symbols".  */
+  if ((objfile->flags & OBJF_PSYMTABS_READ) == 0)
+    printf_filtered ("Partial symbols not read yet\n\n");
+
   objfile->dump ();
 
   if (objfile->compunit_symtabs != NULL)
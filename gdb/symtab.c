@@ -67,17 +67,24 @@
 #include "progspace-and-thread.h"
 #include "gdbsupport/gdb_optional.h"
 #include "filename-seen-cache.h"
+#include "demangle-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
+#include <set>
+#include <unordered_map>
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 /* Forward declarations for local functions.  */
 
 static void rbreak_command (const char *, int);
 
-static int find_line_common (struct linetable *, int, int *, int);
+static int find_line_common (struct objfile *, struct linetable *, int,
+			     int *, int);
 
 static struct block_symbol
   lookup_symbol_aux (const char *name,
@@ -126,8 +133,8 @@ static const program_space_key<main_info> main_progspace_key;
 /* The default symbol cache size.
    There is no extra cpu cost for large N (except when flushing the cache,
    which is rare).  The value here is just a first attempt.  A better default
-   value may be higher or lower.  A prime number can make up for a bad hash
-   computation, so that's why the number is what it is.  */
+   value may be higher or lower.  The cache grows by itself when it is too
+   small for the working set, see symbol_cache_auto_resize.  */
 #define DEFAULT_SYMBOL_CACHE_SIZE 1021
 
 /* The maximum symbol cache size.
@@ -135,6 +142,12 @@ static const program_space_key<main_info> main_progspace_key;
    there's no point in allowing a user typo to make gdb consume all memory.  */
 #define MAX_SYMBOL_CACHE_SIZE (1024*1024)
 
+/* The number of slots in each set of the symbol cache.  A symbol can
+   be stored in any of the slots of the set its hash selects, so that
+   a few symbols with colliding hashes don't keep evicting each
+   other.  */
+#define SYMBOL_CACHE_WAYS 4
+
 /* symbol_cache_lookup returns this if a previous lookup failed to find the
    symbol in any objfile.  */
 #define SYMBOL_LOOKUP_FAILED \
@@ -155,6 +168,9 @@ struct symbol_cache_slot
 {
   enum symbol_cache_slot_state state;
 
+  /* The hash of the lookup, see hash_symbol_entry.  */
+  unsigned int hash;
+
   /* The objfile that was current when the symbol was looked up.
      This is only needed for global blocks, but for simplicity's sake
      we allocate the space for both.  If data shows the extra space used
@@ -170,7 +186,11 @@ struct symbol_cache_slot
      Instead we just make the current objfile part of the context of
      cache lookup.  This means we can record the same symbol multiple times,
      each with a different "current objfile" that was in effect when the
-     lookup was saved in the cache, but cache space is pretty cheap.  */
+     lookup was saved in the cache, but cache space is pretty cheap.
+
+     The search order does not matter when the symbol is not found in
+     any objfile, so failed lookups are always recorded with a NULL
+     context, and are shared by all the contexts.  */
   const struct objfile *objfile_context;
 
   union
@@ -195,35 +215,58 @@ symbol_cache_clear_slot (struct symbol_cache_slot *slot)
 }
 
 /* Symbols don't specify global vs static block.
-   So keep them in separate caches.  */
+   So keep them in separate caches.
+
+   The cache is set-associative: the hash of a lookup selects a set of
+   SYMBOL_CACHE_WAYS slots, which are kept in most recently used
+   order.  A new entry replaces the least recently used slot of its
+   set.  */
 
 struct block_symbol_cache
 {
-  unsigned int hits;
-  unsigned int misses;
-  unsigned int collisions;
+  /* Create a cache with room for at least SIZE symbols.  */
+  explicit block_symbol_cache (unsigned int size)
+    : n_sets ((size + SYMBOL_CACHE_WAYS - 1) / SYMBOL_CACHE_WAYS),
+      symbols (n_sets * SYMBOL_CACHE_WAYS)
+  {
+    stats.size = symbols.size ();
+  }
 
-  /* SYMBOLS is a variable length array of this size.
-     One can imagine that in general one cache (global/static) should be a
-     fraction of the size of the other, but there's no data at the moment
-     on which to decide.  */
-  unsigned int size;
+  ~block_symbol_cache ()
+  {
+    clear ();
+  }
 
-  struct symbol_cache_slot symbols[1];
-};
+  DISABLE_COPY_AND_ASSIGN (block_symbol_cache);
 
-/* Clear all slots of BSC and free BSC.  */
+  /* Return the first slot of the set for HASH.  */
+  struct symbol_cache_slot *set (unsigned int hash)
+  {
+    return &symbols[(hash % n_sets) * SYMBOL_CACHE_WAYS];
+  }
 
-static void
-destroy_block_symbol_cache (struct block_symbol_cache *bsc)
-{
-  if (bsc != nullptr)
-    {
-      for (unsigned int i = 0; i < bsc->size; i++)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
-      xfree (bsc);
-    }
-}
+  /* Clear all the slots.  */
+  void clear ()
+  {
+    for (symbol_cache_slot &slot : symbols)
+      symbol_cache_clear_slot (&slot);
+  }
+
+  struct symbol_cache_statistics stats;
+
+  /* The number of evictions since the cache was created or flushed.
+     This is what decides when to grow the cache.  */
+  unsigned int recent_evictions = 0;
+
+  /* The number of sets.  */
+  unsigned int n_sets;
+
+  /* The slots, N_SETS sets of SYMBOL_CACHE_WAYS consecutive slots.
+     One can imagine that in general one cache (global/static) should be a
+     fraction of the size of the other, but there's no data at the moment
+     on which to decide.  Each cache grows independently, as needed.  */
+  std::vector<symbol_cache_slot> symbols;
+};
 
 /* The symbol cache.
 
@@ -233,20 +276,21 @@ destroy_block_symbol_cache (struct block_symbol_cache *bsc)
    overall gdb performance.
 
    Symbols are hashed on the name, its domain, and block.
-   They are also hashed on their objfile for objfile-specific lookups.  */
+   They are also hashed on their objfile for objfile-specific lookups.
+
+   Symbols may be looked up from worker threads, so all the accesses to
+   the cache are done with MUTEX held.  */
 
 struct symbol_cache
 {
   symbol_cache () = default;
 
-  ~symbol_cache ()
-  {
-    destroy_block_symbol_cache (global_symbols);
-    destroy_block_symbol_cache (static_symbols);
-  }
+  std::unique_ptr<block_symbol_cache> global_symbols;
+  std::unique_ptr<block_symbol_cache> static_symbols;
 
-  struct block_symbol_cache *global_symbols = nullptr;
-  struct block_symbol_cache *static_symbols = nullptr;
+#if CXX_STD_THREAD
+  std::mutex mutex;
+#endif
 };
 
 /* Program space key for finding its symbol cache.  */
@@ -267,11 +311,19 @@ static unsigned int new_symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
    the original value from here.  */
 static unsigned int symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
 
+/* True if the symbol cache may grow beyond SYMBOL_CACHE_SIZE, when the
+   symbols looked up don't fit.  */
+static bool symbol_cache_auto_resize = true;
+
 /* True if a file may be known by two different basenames.
    This is the uncommon case, and significantly slows down gdb.
    Default set to "off" to not slow down the common case.  */
 bool basenames_may_differ = false;
 
+/* See symtab.h.  */
+
+bool symbol_search_streaming = false;
+
 /* Allow the user to configure the debugger behavior with respect
    to multiple-choice menus when more than one symbol matches during
    a symbol lookup.  */
@@ -479,6 +531,44 @@ compare_glob_filenames_for_search (const char *filename,
   }
 }
 
+/* Return true if symtab S matches the file name NAME, whose base name
+   is BASE_NAME, for iterate_over_some_symtabs.  REAL_PATH is as for
+   that function.  */
+
+static bool
+symtab_matches_filename (symtab *s, const char *name, const char *base_name,
+			 const char *real_path)
+{
+  if (compare_filenames_for_search (s->filename, name))
+    return true;
+
+  /* Before we invoke realpath, which can get expensive when many
+     files are involved, do a quick comparison of the basenames.  */
+  if (! basenames_may_differ
+      && FILENAME_CMP (base_name, lbasename (s->filename)) != 0)
+    return false;
+
+  if (compare_filenames_for_search (symtab_to_fullname (s), name))
+    return true;
+
+  /* If the user gave us an absolute path, try to find the file in
+     this symtab and use its absolute path.  */
+  if (real_path != NULL)
+    {
+      const char *fullname = symtab_to_fullname (s);
+
+      gdb_assert (IS_ABSOLUTE_PATH (real_path));
+      gdb_assert (IS_ABSOLUTE_PATH (name));
+      gdb::unique_xmalloc_ptr<char> fullname_real_path
+	= gdb_realpath (fullname);
+      fullname = fullname_real_path.get ();
+      if (FILENAME_CMP (real_path, fullname) == 0)
+	return true;
+    }
+
+  return false;
+}
+
 /* Check for a symtab of a specific name by searching some symtabs.
    This is a helper function for callbacks of iterate_over_symtabs.
 
@@ -506,46 +596,9 @@ iterate_over_some_symtabs (const char *name,
   for (cust = first; cust != NULL && cust != after_last; cust = cust->next)
     {
       for (symtab *s : compunit_filetabs (cust))
-	{
-	  if (compare_filenames_for_search (s->filename, name))
-	    {
-	      if (callback (s))
-		return true;
-	      continue;
-	    }
-
-	  /* Before we invoke realpath, which can get expensive when many
-	     files are involved, do a quick comparison of the basenames.  */
-	  if (! basenames_may_differ
-	      && FILENAME_CMP (base_name, lbasename (s->filename)) != 0)
-	    continue;
-
-	  if (compare_filenames_for_search (symtab_to_fullname (s), name))
-	    {
-	      if (callback (s))
-		return true;
-	      continue;
-	    }
-
-	  /* If the user gave us an absolute path, try to find the file in
-	     this symtab and use its absolute path.  */
-	  if (real_path != NULL)
-	    {
-	      const char *fullname = symtab_to_fullname (s);
-
-	      gdb_assert (IS_ABSOLUTE_PATH (real_path));
-	      gdb_assert (IS_ABSOLUTE_PATH (name));
-	      gdb::unique_xmalloc_ptr<char> fullname_real_path
-		= gdb_realpath (fullname);
-	      fullname = fullname_real_path.get ();
-	      if (FILENAME_CMP (real_path, fullname) == 0)
-		{
-		  if (callback (s))
-		    return true;
-		  continue;
-		}
-	    }
-	}
+	if (symtab_matches_filename (s, name, base_name, real_path)
+	    && callback (s))
+	  return true;
     }
 
   return false;
@@ -574,9 +627,8 @@ iterate_over_symtabs (const char *name,
 
   for (objfile *objfile : current_program_space->objfiles ())
     {
-      if (iterate_over_some_symtabs (name, real_path.get (),
-				     objfile->compunit_symtabs, NULL,
-				     callback))
+      if (iterate_over_objfile_symtabs (objfile, name, real_path.get (),
+					callback))
 	return;
     }
 
@@ -823,7 +875,8 @@ create_demangled_names_hash (struct objfile_per_bfd_storage *per_bfd)
 
 gdb::unique_xmalloc_ptr<char>
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
-			    const char *mangled)
+			    const char *mangled,
+			    objfile_per_bfd_storage *per_bfd)
 {
   gdb::unique_xmalloc_ptr<char> demangled;
   int i;
@@ -831,27 +884,48 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
   if (gsymbol->language () == language_unknown)
     gsymbol->m_language = language_auto;
 
+  bfd_demangle_cache *cache
+    = per_bfd != nullptr ? per_bfd->demangle_cache.get () : nullptr;
+  enum language kind = gsymbol->language ();
+  if (cache != nullptr)
+    {
+      enum language language;
+
+      if (cache->lookup (kind, mangled, &language, &demangled))
+	{
+	  global_demangle_cache.hit ();
+	  gsymbol->m_language = language;
+	  return demangled;
+	}
+      global_demangle_cache.miss ();
+    }
+
   if (gsymbol->language () != language_auto)
     {
       const struct language_defn *lang = language_def (gsymbol->language ());
 
       lang->sniff_from_mangled_name (mangled, &demangled);
-      return demangled;
     }
-
-  for (i = language_unknown; i < nr_languages; ++i)
+  else
     {
-      enum language l = (enum language) i;
-      const struct language_defn *lang = language_def (l);
-
-      if (lang->sniff_from_mangled_name (mangled, &demangled))
+      for (i = language_unknown; i < nr_languages; ++i)
 	{
-	  gsymbol->m_language = l;
-	  return demangled;
+	  enum language l = (enum language) i;
+	  const struct language_defn *lang = language_def (l);
+
+	  if (lang->sniff_from_mangled_name (mangled, &demangled))
+	    {
+	      gsymbol->m_language = l;
+	      break;
+	    }
 	}
+      if (i == nr_languages)
+	demangled.reset (nullptr);
     }
 
-  return NULL;
+  if (cache != nullptr)
+    cache->record (kind, mangled, gsymbol->language (), demangled.get ());
+  return demangled;
 }
 
 /* Set both the mangled and demangled (if any) names for GSYMBOL based
@@ -932,7 +1006,8 @@ general_symbol_info::compute_and_set_names (gdb::string_view linkage_name,
 
       if (demangled_name.get () == nullptr)
 	 demangled_name
-	   = symbol_find_demangled_name (this, linkage_name_copy.data ());
+	   = symbol_find_demangled_name (this, linkage_name_copy.data (),
+					 per_bfd);
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
 	 linkage_name_copy==linkage_name.  In this case, we already have the
@@ -1244,14 +1319,66 @@ eq_symbol_entry (const struct symbol_cache_slot *slot,
   return 1;
 }
 
-/* Given a cache of size SIZE, return the size of the struct (with variable
-   length array) in bytes.  */
+/* Return the slot of the set starting at SET that records the lookup
+   of NAME,DOMAIN with hash HASH in OBJFILE_CONTEXT, or NULL.  */
 
-static size_t
-symbol_cache_byte_size (unsigned int size)
+static struct symbol_cache_slot *
+symbol_cache_find_slot (struct symbol_cache_slot *set, unsigned int hash,
+			const struct objfile *objfile_context,
+			const char *name, domain_enum domain)
+{
+  for (int i = 0; i < SYMBOL_CACHE_WAYS; ++i)
+    if (set[i].state != SYMBOL_SLOT_UNUSED
+	&& set[i].hash == hash
+	&& eq_symbol_entry (&set[i], objfile_context, name, domain))
+      return &set[i];
+
+  return NULL;
+}
+
+/* Make SLOT the most recently used slot of the set starting at SET,
+   by moving it first.  Return its new address, that is, SET.  */
+
+static struct symbol_cache_slot *
+symbol_cache_touch_slot (struct symbol_cache_slot *set,
+			 struct symbol_cache_slot *slot)
+{
+  std::rotate (set, slot, slot + 1);
+  return set;
+}
+
+/* Double the size of BSC, keeping its entries.  */
+
+static void
+grow_block_symbol_cache (struct block_symbol_cache *bsc)
 {
-  return (sizeof (struct block_symbol_cache)
-	  + ((size - 1) * sizeof (struct symbol_cache_slot)));
+  std::vector<symbol_cache_slot> old_symbols = std::move (bsc->symbols);
+  unsigned int old_n_sets = bsc->n_sets;
+
+  bsc->n_sets *= 2;
+  bsc->symbols = std::vector<symbol_cache_slot> (bsc->n_sets
+						 * SYMBOL_CACHE_WAYS);
+
+  /* The entries of an old set go to one of two new sets, which thus
+     can't overflow.  Moving the slots moves the ownership of the
+     names of not-found lookups.  */
+  for (unsigned int i = 0; i < old_n_sets; ++i)
+    for (int j = 0; j < SYMBOL_CACHE_WAYS; ++j)
+      {
+	const symbol_cache_slot &old = old_symbols[i * SYMBOL_CACHE_WAYS + j];
+
+	if (old.state == SYMBOL_SLOT_UNUSED)
+	  continue;
+
+	struct symbol_cache_slot *slot = bsc->set (old.hash);
+	while (slot->state != SYMBOL_SLOT_UNUSED)
+	  ++slot;
+	*slot = old;
+      }
+
+  bsc->stats.size = bsc->symbols.size ();
+  ++bsc->stats.resizes;
+  bsc->recent_evictions = 0;
 }
 
 /* Resize CACHE.  */
@@ -1259,42 +1386,38 @@ symbol_cache_byte_size (unsigned int size)
 static void
 resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 {
-  /* If there's no change in size, don't do anything.
-     All caches have the same size, so we can just compare with the size
-     of the global symbols cache.  */
-  if ((cache->global_symbols != NULL
-       && cache->global_symbols->size == new_size)
-      || (cache->global_symbols == NULL
-	  && new_size == 0))
-    return;
-
-  destroy_block_symbol_cache (cache->global_symbols);
-  destroy_block_symbol_cache (cache->static_symbols);
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
 
   if (new_size == 0)
     {
-      cache->global_symbols = NULL;
-      cache->static_symbols = NULL;
+      cache->global_symbols.reset ();
+      cache->static_symbols.reset ();
     }
   else
     {
-      size_t total_size = symbol_cache_byte_size (new_size);
-
-      cache->global_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->static_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->global_symbols->size = new_size;
-      cache->static_symbols->size = new_size;
+      cache->global_symbols.reset (new block_symbol_cache (new_size));
+      cache->static_symbols.reset (new block_symbol_cache (new_size));
     }
 }
 
+#if CXX_STD_THREAD
+/* Mutex to hold when creating the symbol cache of a program space,
+   which may be done by a worker thread.  */
+
+static std::mutex symbol_cache_create_mutex;
+#endif
+
 /* Return the symbol cache of PSPACE.
    Create one if it doesn't exist yet.  */
 
 static struct symbol_cache *
 get_symbol_cache (struct program_space *pspace)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (symbol_cache_create_mutex);
+#endif
   struct symbol_cache *cache = symbol_cache_key.get (pspace);
 
   if (cache == NULL)
@@ -1341,43 +1464,53 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
   set_symbol_cache_size (symbol_cache_size);
 }
 
-/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache of PSPACE.
+/* Return the cache for BLOCK in CACHE, or NULL if the cache is
+   disabled.  */
+
+static struct block_symbol_cache *
+get_block_symbol_cache (struct symbol_cache *cache, enum block_enum block)
+{
+  if (block == GLOBAL_BLOCK)
+    return cache->global_symbols.get ();
+  else
+    return cache->static_symbols.get ();
+}
+
+/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache CACHE.
    OBJFILE_CONTEXT is the current objfile, which may be NULL.
    The result is the symbol if found, SYMBOL_LOOKUP_FAILED if a previous lookup
    failed (and thus this one will too), or NULL if the symbol is not present
-   in the cache.
-   *BSC_PTR and *SLOT_PTR are set to the cache and slot of the symbol, which
-   can be used to save the result of a full lookup attempt.  */
+   in the cache.  */
 
 static struct block_symbol
 symbol_cache_lookup (struct symbol_cache *cache,
 		     struct objfile *objfile_context, enum block_enum block,
-		     const char *name, domain_enum domain,
-		     struct block_symbol_cache **bsc_ptr,
-		     struct symbol_cache_slot **slot_ptr)
+		     const char *name, domain_enum domain)
 {
-  struct block_symbol_cache *bsc;
-  unsigned int hash;
-  struct symbol_cache_slot *slot;
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
+  struct block_symbol_cache *bsc = get_block_symbol_cache (cache, block);
 
-  if (block == GLOBAL_BLOCK)
-    bsc = cache->global_symbols;
-  else
-    bsc = cache->static_symbols;
   if (bsc == NULL)
-    {
-      *bsc_ptr = NULL;
-      *slot_ptr = NULL;
-      return {};
-    }
+    return {};
 
-  hash = hash_symbol_entry (objfile_context, name, domain);
-  slot = bsc->symbols + hash % bsc->size;
+  unsigned int hash = hash_symbol_entry (objfile_context, name, domain);
+  struct symbol_cache_slot *set = bsc->set (hash);
+  struct symbol_cache_slot *slot
+    = symbol_cache_find_slot (set, hash, objfile_context, name, domain);
 
-  *bsc_ptr = bsc;
-  *slot_ptr = slot;
+  /* A lookup that failed is recorded without context.  */
+  if (slot == NULL && objfile_context != NULL)
+    {
+      hash = hash_symbol_entry (NULL, name, domain);
+      set = bsc->set (hash);
+      slot = symbol_cache_find_slot (set, hash, NULL, name, domain);
+      if (slot != NULL && slot->state != SYMBOL_SLOT_NOT_FOUND)
+	slot = NULL;
+    }
 
-  if (eq_symbol_entry (slot, objfile_context, name, domain))
+  if (slot != NULL)
     {
       if (symbol_lookup_debug)
 	fprintf_unfiltered (gdb_stdlog,
@@ -1386,9 +1519,13 @@ symbol_cache_lookup (struct symbol_cache *cache,
 			    slot->state == SYMBOL_SLOT_NOT_FOUND
 			    ? " (not found)" : "",
 			    name, domain_name (domain));
-      ++bsc->hits;
+      ++bsc->stats.hits;
+      slot = symbol_cache_touch_slot (set, slot);
       if (slot->state == SYMBOL_SLOT_NOT_FOUND)
-	return SYMBOL_LOOKUP_FAILED;
+	{
+	  ++bsc->stats.not_found_hits;
+	  return SYMBOL_LOOKUP_FAILED;
+	}
       return slot->value.found;
     }
 
@@ -1401,54 +1538,99 @@ symbol_cache_lookup (struct symbol_cache *cache,
 			  block == GLOBAL_BLOCK ? "Global" : "Static",
 			  name, domain_name (domain));
     }
-  ++bsc->misses;
+  ++bsc->stats.misses;
   return {};
 }
 
-/* Mark SYMBOL as found in SLOT.
+/* Return a cleared slot of BSC in which to record the lookup of
+   NAME,DOMAIN in OBJFILE_CONTEXT, evicting the least recently used
+   entry of its set if needed.  The slot is made the most recently
+   used one of its set.  */
+
+static struct symbol_cache_slot *
+symbol_cache_new_slot (struct block_symbol_cache *bsc,
+		       const struct objfile *objfile_context,
+		       const char *name, domain_enum domain)
+{
+  /* Grow the cache once it has replaced as many entries as it can
+     hold: the working set doesn't fit.  */
+  if (symbol_cache_auto_resize
+      && bsc->recent_evictions >= bsc->symbols.size ()
+      && bsc->symbols.size () * 2 <= MAX_SYMBOL_CACHE_SIZE)
+    grow_block_symbol_cache (bsc);
+
+  unsigned int hash = hash_symbol_entry (objfile_context, name, domain);
+  struct symbol_cache_slot *set = bsc->set (hash);
+
+  /* Another thread may have recorded the same lookup after we missed
+     it; just replace that entry.  */
+  struct symbol_cache_slot *slot
+    = symbol_cache_find_slot (set, hash, objfile_context, name, domain);
+  if (slot == NULL)
+    {
+      slot = &set[SYMBOL_CACHE_WAYS - 1];
+      if (slot->state != SYMBOL_SLOT_UNUSED)
+	{
+	  ++bsc->stats.evictions;
+	  ++bsc->recent_evictions;
+	}
+    }
+
+  symbol_cache_clear_slot (slot);
+  slot = symbol_cache_touch_slot (set, slot);
+  slot->hash = hash;
+  slot->objfile_context = objfile_context;
+  return slot;
+}
+
+/* Mark SYMBOL, found in BLOCK, as the result of the lookup of
+   NAME,DOMAIN in block BLOCK_INDEX of CACHE.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  It is *not*
    necessarily the objfile the symbol was found in.  */
 
 static void
-symbol_cache_mark_found (struct block_symbol_cache *bsc,
-			 struct symbol_cache_slot *slot,
+symbol_cache_mark_found (struct symbol_cache *cache,
+			 enum block_enum block_index,
 			 struct objfile *objfile_context,
+			 const char *name, domain_enum domain,
 			 struct symbol *symbol,
 			 const struct block *block)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
+  struct block_symbol_cache *bsc = get_block_symbol_cache (cache, block_index);
+
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+
+  struct symbol_cache_slot *slot
+    = symbol_cache_new_slot (bsc, objfile_context, name, domain);
   slot->state = SYMBOL_SLOT_FOUND;
-  slot->objfile_context = objfile_context;
   slot->value.found.symbol = symbol;
   slot->value.found.block = block;
 }
 
-/* Mark symbol NAME, DOMAIN as not found in SLOT.
-   OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
-   if it's not needed to distinguish lookups (STATIC_BLOCK).  */
+/* Mark symbol NAME, DOMAIN as not found in block BLOCK_INDEX of any
+   objfile.  */
 
 static void
-symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
-			     struct symbol_cache_slot *slot,
-			     struct objfile *objfile_context,
+symbol_cache_mark_not_found (struct symbol_cache *cache,
+			     enum block_enum block_index,
 			     const char *name, domain_enum domain)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
+  struct block_symbol_cache *bsc = get_block_symbol_cache (cache, block_index);
+
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+
+  struct symbol_cache_slot *slot
+    = symbol_cache_new_slot (bsc, NULL, name, domain);
   slot->state = SYMBOL_SLOT_NOT_FOUND;
-  slot->objfile_context = objfile_context;
   slot->value.not_found.name = xstrdup (name);
   slot->value.not_found.domain = domain;
 }
@@ -1459,10 +1641,14 @@ static void
 symbol_cache_flush (struct program_space *pspace)
 {
   struct symbol_cache *cache = symbol_cache_key.get (pspace);
-  int pass;
 
   if (cache == NULL)
     return;
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
+
   if (cache->global_symbols == NULL)
     {
       gdb_assert (symbol_cache_size == 0);
@@ -1473,38 +1659,33 @@ symbol_cache_flush (struct program_space *pspace)
   /* If the cache is untouched since the last flush, early exit.
      This is important for performance during the startup of a program linked
      with 100s (or 1000s) of shared libraries.  */
-  if (cache->global_symbols->misses == 0
-      && cache->static_symbols->misses == 0)
+  if (cache->global_symbols->stats.misses == 0
+      && cache->static_symbols->stats.misses == 0)
     return;
 
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
-
-  for (pass = 0; pass < 2; ++pass)
+  /* Keep the size the caches have grown to, the next program is
+     likely to need the same.  */
+  for (block_symbol_cache *bsc : { cache->global_symbols.get (),
+				   cache->static_symbols.get () })
     {
-      struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
-      unsigned int i;
-
-      for (i = 0; i < bsc->size; ++i)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
+      bsc->clear ();
+      bsc->stats = symbol_cache_statistics ();
+      bsc->stats.size = bsc->symbols.size ();
+      bsc->recent_evictions = 0;
     }
-
-  cache->global_symbols->hits = 0;
-  cache->global_symbols->misses = 0;
-  cache->global_symbols->collisions = 0;
-  cache->static_symbols->hits = 0;
-  cache->static_symbols->misses = 0;
-  cache->static_symbols->collisions = 0;
 }
 
 /* Dump CACHE.  */
 
 static void
-symbol_cache_dump (const struct symbol_cache *cache)
+symbol_cache_dump (struct symbol_cache *cache)
 {
   int pass;
 
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
+
   if (cache->global_symbols == NULL)
     {
       printf_filtered ("  <disabled>\n");
@@ -1514,7 +1695,7 @@ symbol_cache_dump (const struct symbol_cache *cache)
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
+	= (pass == 0 ? cache->global_symbols : cache->static_symbols).get ();
       unsigned int i;
 
       if (pass == 0)
@@ -1522,7 +1703,7 @@ symbol_cache_dump (const struct symbol_cache *cache)
       else
 	printf_filtered ("Static symbols:\n");
 
-      for (i = 0; i < bsc->size; ++i)
+      for (i = 0; i < bsc->symbols.size (); ++i)
 	{
 	  const struct symbol_cache_slot *slot = &bsc->symbols[i];
 
@@ -1589,24 +1770,46 @@ maintenance_flush_symbol_cache (const char *args, int from_tty)
     }
 }
 
-/* Print usage statistics of CACHE.  */
+/* See symtab.h.  */
 
-static void
-symbol_cache_stats (struct symbol_cache *cache)
+bool
+get_symbol_cache_statistics (struct program_space *pspace,
+			     struct symbol_cache_statistics *global_stats,
+			     struct symbol_cache_statistics *static_stats)
 {
-  int pass;
+  /* If the cache hasn't been created yet, avoid creating one.  */
+  struct symbol_cache *cache = symbol_cache_key.get (pspace);
+
+  if (cache == NULL)
+    return false;
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> lock (cache->mutex);
+#endif
 
   if (cache->global_symbols == NULL)
+    return false;
+
+  *global_stats = cache->global_symbols->stats;
+  *static_stats = cache->static_symbols->stats;
+  return true;
+}
+
+/* Print usage statistics of the symbol cache of PSPACE.  */
+
+static void
+symbol_cache_stats (struct program_space *pspace)
+{
+  struct symbol_cache_statistics stats[2];
+
+  if (!get_symbol_cache_statistics (pspace, &stats[0], &stats[1]))
     {
       printf_filtered ("  <disabled>\n");
       return;
     }
 
-  for (pass = 0; pass < 2; ++pass)
+  for (int pass = 0; pass < 2; ++pass)
     {
-      const struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
-
       QUIT;
 
       if (pass == 0)
@@ -1614,10 +1817,12 @@ symbol_cache_stats (struct symbol_cache *cache)
       else
 	printf_filtered ("Static block cache stats:\n");
 
-      printf_filtered ("  size:       %u\n", bsc->size);
-      printf_filtered ("  hits:       %u\n", bsc->hits);
-      printf_filtered ("  misses:     %u\n", bsc->misses);
-      printf_filtered ("  collisions: %u\n", bsc->collisions);
+      printf_filtered ("  size:           %u\n", stats[pass].size);
+      printf_filtered ("  hits:           %u\n", stats[pass].hits);
+      printf_filtered ("  not-found hits: %u\n", stats[pass].not_found_hits);
+      printf_filtered ("  misses:         %u\n", stats[pass].misses);
+      printf_filtered ("  evictions:      %u\n", stats[pass].evictions);
+      printf_filtered ("  resizes:        %u\n", stats[pass].resizes);
     }
 }
 
@@ -1628,8 +1833,6 @@ maintenance_print_symbol_cache_statistics (const char *args, int from_tty)
 {
   for (struct program_space *pspace : program_spaces)
     {
-      struct symbol_cache *cache;
-
       printf_filtered (_("Symbol cache statistics for pspace %d\n%s:\n"),
 		       pspace->num,
 		       pspace->symfile_object_file != NULL
@@ -1637,11 +1840,10 @@ maintenance_print_symbol_cache_statistics (const char *args, int from_tty)
 		       : "(no object file)");
 
       /* If the cache hasn't been created yet, avoid creating one.  */
-      cache = symbol_cache_key.get (pspace);
-      if (cache == NULL)
+      if (symbol_cache_key.get (pspace) == NULL)
 	printf_filtered ("  empty, no stats available\n");
       else
-	symbol_cache_stats (cache);
+	symbol_cache_stats (pspace);
     }
 }
 
@@ -2636,16 +2838,13 @@ lookup_global_or_static_symbol (const char *name,
   struct symbol_cache *cache = get_symbol_cache (current_program_space);
   struct block_symbol result;
   struct global_or_static_sym_lookup_data lookup_data;
-  struct block_symbol_cache *bsc;
-  struct symbol_cache_slot *slot;
 
   gdb_assert (block_index == GLOBAL_BLOCK || block_index == STATIC_BLOCK);
   gdb_assert (objfile == nullptr || block_index == GLOBAL_BLOCK);
 
   /* First see if we can find the symbol in the cache.
      This works because we use the current objfile to qualify the lookup.  */
-  result = symbol_cache_lookup (cache, objfile, block_index, name, domain,
-				&bsc, &slot);
+  result = symbol_cache_lookup (cache, objfile, block_index, name, domain);
   if (result.symbol != NULL)
     {
       if (SYMBOL_LOOKUP_FAILED_P (result))
@@ -2667,9 +2866,10 @@ lookup_global_or_static_symbol (const char *name,
     }
 
   if (result.symbol != NULL)
-    symbol_cache_mark_found (bsc, slot, objfile, result.symbol, result.block);
+    symbol_cache_mark_found (cache, block_index, objfile, name, domain,
+			     result.symbol, result.block);
   else
-    symbol_cache_mark_not_found (bsc, slot, objfile, name, domain);
+    symbol_cache_mark_not_found (cache, block_index, name, domain);
 
   return result;
 }
@@ -2896,6 +3096,308 @@ iterate_over_symbols_terminated
   return callback (&block_sym);
 }
 
+/* The PC to compunit index.
+
+   find_pc_sect_compunit_symtab must consider every expanded compunit
+   whose global block contains the PC, in the order in which the
+   objfiles and their compunits are linked.  Walking all of them for
+   each PC is slow when there are many compunits, e.g. when unwinding a
+   deep stack.  So the address ranges of the compunits of a program
+   space are merged into a sorted list of segments.  Each segment
+   lists the compunits that may contain the addresses of the segment,
+   in the order of the walk.
+
+   The index is not updated when compunits are expanded.  As
+   add_compunit_symtab_to_objfile links new compunits at the front of
+   the list of their objfile, the compunits added since the index was
+   built are the ones before the first compunit that was indexed for
+   the objfile.  They are considered first, and the index is rebuilt
+   when there are too many of them.  */
+
+struct compunit_pc_index_entry
+{
+  /* The index of the objfile of CUST in
+     compunit_pc_index::objfiles.  */
+  unsigned int objfile_index;
+
+  struct compunit_symtab *cust;
+};
+
+struct compunit_pc_index_objfile
+{
+  struct objfile *objfile;
+
+  /* The first compunit of OBJFILE when the index was built.  */
+  struct compunit_symtab *first_cust;
+};
+
+struct compunit_pc_index
+{
+  /* False if the ranges of the compunits overlap too much for the
+     index to be useful.  */
+  bool usable = true;
+
+  /* The objfiles of the program space, in order.  */
+  std::vector<compunit_pc_index_objfile> objfiles;
+
+  /* The number of compunits in the index.  */
+  size_t n_compunits = 0;
+
+  /* The start addresses of the segments, in Eytzinger order: the
+     children of BOUNDS[K] are BOUNDS[2K] and BOUNDS[2K+1].  This
+     keeps the first steps of the binary search in a few cache lines.
+     BOUNDS[0] is unused.  */
+  std::vector<CORE_ADDR> bounds;
+
+  /* For each element of BOUNDS, the index of the segment it
+     starts.  */
+  std::vector<unsigned int> segments;
+
+  /* The candidates of segment I are CANDIDATES[OFFSETS[I]] up to
+     CANDIDATES[OFFSETS[I + 1]].  */
+  std::vector<unsigned int> offsets;
+  std::vector<compunit_pc_index_entry> candidates;
+};
+
+/* The index of a program space.  It is shared with the lookups in
+   progress, so that they can go on if the index is rebuilt while
+   they expand symtabs.  */
+
+struct compunit_pc_index_holder
+{
+  std::shared_ptr<compunit_pc_index> index;
+};
+
+/* Program space key for finding its compunit PC index.  */
+
+static const program_space_key<compunit_pc_index_holder>
+  compunit_pc_index_key;
+
+/* Whether find_pc_sect_compunit_symtab uses the compunit PC index.  */
+
+static bool compunit_pc_index_enabled = true;
+
+/* See symtab.h.  */
+
+void
+invalidate_compunit_pc_index (struct program_space *pspace)
+{
+  compunit_pc_index_holder *holder = compunit_pc_index_key.get (pspace);
+
+  if (holder != nullptr)
+    holder->index.reset ();
+}
+
+/* Store the segment starts SORTED into INDEX->BOUNDS in Eytzinger
+   order, from node K of the tree.  I is the index of the next element
+   of SORTED to store.  Return the index of the element that follows
+   the subtree.  */
+
+static size_t
+compunit_pc_index_layout (compunit_pc_index *index,
+			  const std::vector<CORE_ADDR> &sorted,
+			  size_t i, size_t k)
+{
+  if (k < index->bounds.size ())
+    {
+      i = compunit_pc_index_layout (index, sorted, i, 2 * k);
+      index->bounds[k] = sorted[i];
+      index->segments[k] = i;
+      ++i;
+      i = compunit_pc_index_layout (index, sorted, i, 2 * k + 1);
+    }
+
+  return i;
+}
+
+/* Build the compunit PC index of PSPACE.  */
+
+static std::shared_ptr<compunit_pc_index>
+build_compunit_pc_index (struct program_space *pspace)
+{
+  struct interval
+  {
+    CORE_ADDR start, end;
+
+    /* The index of the compunit in ENTRIES.  */
+    unsigned int rank;
+  };
+
+  std::shared_ptr<compunit_pc_index> index
+    = std::make_shared<compunit_pc_index> ();
+  std::vector<compunit_pc_index_entry> entries;
+  std::vector<interval> intervals;
+
+  for (objfile *objfile : pspace->objfiles ())
+    {
+      unsigned int objfile_index = index->objfiles.size ();
+
+      index->objfiles.push_back ({ objfile, objfile->compunit_symtabs });
+      for (compunit_symtab *cust : objfile->compunits ())
+	{
+	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (cust);
+	  const struct block *global_block
+	    = BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
+	  CORE_ADDR start = BLOCK_START (global_block);
+	  CORE_ADDR end = BLOCK_END (global_block);
+	  unsigned int rank = entries.size ();
+
+	  entries.push_back ({ objfile_index, cust });
+	  if (start >= end)
+	    continue;
+
+	  if (BLOCKVECTOR_MAP (bv) == nullptr)
+	    {
+	      intervals.push_back ({ start, end, rank });
+	      continue;
+	    }
+
+	  /* Only the addresses the map knows about can match.  */
+	  CORE_ADDR region_start = 0;
+	  void *region_obj = nullptr;
+	  auto add_region = [&] (CORE_ADDR region_end)
+	    {
+	      CORE_ADDR lo = std::max (region_start, start);
+	      CORE_ADDR hi = std::min (region_end, end);
+
+	      if (region_obj != nullptr && lo < hi)
+		intervals.push_back ({ lo, hi, rank });
+	    };
+	  addrmap_foreach (BLOCKVECTOR_MAP (bv),
+			   [&] (CORE_ADDR addr, void *obj)
+			   {
+			     if (addr >= end)
+			       return 1;
+			     add_region (addr);
+			     region_start = addr;
+			     region_obj = obj;
+			     return 0;
+			   });
+	  add_region (end);
+	}
+    }
+  index->n_compunits = entries.size ();
+
+  /* Sweep the ranges in address order, keeping the set of the
+     compunits that contain the current address.  */
+  std::vector<interval> by_end = intervals;
+  std::sort (intervals.begin (), intervals.end (),
+	     [] (const interval &a, const interval &b)
+	     {
+	       return a.start < b.start;
+	     });
+  std::sort (by_end.begin (), by_end.end (),
+	     [] (const interval &a, const interval &b)
+	     {
+	       return a.end < b.end;
+	     });
+
+  /* Give up if the compunits overlap so much that the segments would
+     list most of the compunits anyway.  */
+  size_t max_candidates = 8 * intervals.size () + 4096;
+  std::vector<CORE_ADDR> sorted;
+  std::set<unsigned int> active;
+  auto starts = intervals.begin ();
+  auto ends = by_end.begin ();
+
+  while (starts != intervals.end () || ends != by_end.end ())
+    {
+      CORE_ADDR addr;
+
+      if (starts == intervals.end ())
+	addr = ends->end;
+      else if (ends == by_end.end ())
+	addr = starts->start;
+      else
+	addr = std::min (starts->start, ends->end);
+
+      for (; ends != by_end.end () && ends->end == addr; ++ends)
+	active.erase (ends->rank);
+      for (; starts != intervals.end () && starts->start == addr; ++starts)
+	active.insert (starts->rank);
+
+      /* Merge the segment with the previous one if they have the same
+	 candidates.  */
+      if (!sorted.empty ())
+	{
+	  size_t prev = index->offsets.back ();
+
+	  if (index->candidates.size () - prev == active.size ()
+	      && std::equal (active.begin (), active.end (),
+			     index->candidates.begin () + prev,
+			     [&] (unsigned int rank,
+				  const compunit_pc_index_entry &entry)
+			     {
+			       return entries[rank].cust == entry.cust;
+			     }))
+	    continue;
+	}
+
+      sorted.push_back (addr);
+      index->offsets.push_back (index->candidates.size ());
+      for (unsigned int rank : active)
+	index->candidates.push_back (entries[rank]);
+
+      if (index->candidates.size () > max_candidates)
+	{
+	  index->usable = false;
+	  return index;
+	}
+    }
+  index->offsets.push_back (index->candidates.size ());
+
+  index->bounds.resize (sorted.size () + 1);
+  index->segments.resize (sorted.size () + 1);
+  compunit_pc_index_layout (index.get (), sorted, 0, 1);
+
+  return index;
+}
+
+/* Return the compunit PC index of PSPACE, building it if needed.
+   Return NULL if the index is disabled or not usable.  */
+
+static std::shared_ptr<compunit_pc_index>
+get_compunit_pc_index (struct program_space *pspace)
+{
+  if (!compunit_pc_index_enabled)
+    return nullptr;
+
+  compunit_pc_index_holder *holder = compunit_pc_index_key.get (pspace);
+  if (holder == nullptr)
+    holder = compunit_pc_index_key.emplace (pspace);
+
+  if (holder->index == nullptr)
+    holder->index = build_compunit_pc_index (pspace);
+
+  if (!holder->index->usable)
+    return nullptr;
+  return holder->index;
+}
+
+/* Return the segment of INDEX that contains PC, or -1 if PC is before
+   the first segment.  */
+
+static int
+compunit_pc_index_segment (const compunit_pc_index *index, CORE_ADDR pc)
+{
+  size_t n = index->bounds.size () - 1;
+  size_t k = 1;
+
+  /* Find the first segment that starts after PC.  */
+  while (k <= n)
+    k = 2 * k + (index->bounds[k] <= pc);
+
+  /* K went down to the right after the node, and then left at each
+     step: remove those steps.  */
+  while ((k & 1) != 0)
+    k >>= 1;
+  k >>= 1;
+
+  if (k == 0)
+    return (int) n - 1;
+  return (int) index->segments[k] - 1;
+}
+
 /* Find the compunit symtab associated with PC and SECTION.
    This will read in debug info as necessary.  */
 
@@ -2927,81 +3429,140 @@ find_pc_sect_compunit_symtab (CORE_ADDR pc, struct obj_section *section)
      It might be swifter to create several symtabs with the same name
      like xcoff does (I'm not sure).
 
-     It also happens for objfiles that have their functions reordered.
-     For these, the symtab we are looking for is not necessarily read in.  */
+     It also happens for objfiles that have their functions reordered.
+     For these, the symtab we are looking for is not necessarily read in.  */
+
+  /* Consider CUST of OBJ_FILE.  Return the compunit symtab found if
+     the search is over, NULL otherwise.  */
+  auto consider = [&] (objfile *obj_file,
+		       compunit_symtab *cust) -> compunit_symtab *
+    {
+      const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (cust);
+      const struct block *global_block
+	= BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
+      CORE_ADDR start = BLOCK_START (global_block);
+      CORE_ADDR end = BLOCK_END (global_block);
+      bool in_range_p = start <= pc && pc < end;
+      if (!in_range_p)
+	return nullptr;
+
+      if (BLOCKVECTOR_MAP (bv))
+	{
+	  if (addrmap_find (BLOCKVECTOR_MAP (bv), pc) == nullptr)
+	    return nullptr;
+
+	  return cust;
+	}
+
+      CORE_ADDR range = end - start;
+      if (best_cust != nullptr
+	  && range >= best_cust_range)
+	/* Cust doesn't have a smaller range than best_cust, skip it.  */
+	return nullptr;
+
+      /* For an objfile that has its functions reordered,
+	 find_pc_psymtab will find the proper partial symbol table
+	 and we simply return its corresponding symtab.  */
+      /* In order to better support objfiles that contain both
+	 stabs and coff debugging info, we continue on if a psymtab
+	 can't be found.  */
+      if ((obj_file->flags & OBJF_REORDERED) != 0)
+	{
+	  struct compunit_symtab *result;
+
+	  result
+	    = obj_file->find_pc_sect_compunit_symtab (msymbol,
+						      pc,
+						      section,
+						      0);
+	  if (result != NULL)
+	    return result;
+	}
+
+      if (section != 0)
+	{
+	  struct symbol *sym = NULL;
+	  struct block_iterator iter;
+
+	  for (int b_index = GLOBAL_BLOCK;
+	       b_index <= STATIC_BLOCK && sym == NULL;
+	       ++b_index)
+	    {
+	      const struct block *b = BLOCKVECTOR_BLOCK (bv, b_index);
+	      ALL_BLOCK_SYMBOLS (b, iter, sym)
+		{
+		  fixup_symbol_section (sym, obj_file);
+		  if (matching_obj_sections (sym->obj_section (obj_file),
+					     section))
+		    break;
+		}
+	    }
+	  if (sym == NULL)
+	    return nullptr;	/* No symbol in this symtab matches
+				   section.  */
+	}
+
+      /* Cust is best found sofar, save it.  */
+      best_cust = cust;
+      best_cust_range = range;
+      return nullptr;
+    };
 
-  for (objfile *obj_file : current_program_space->objfiles ())
+  std::shared_ptr<compunit_pc_index> index
+    = get_compunit_pc_index (current_program_space);
+  if (index != nullptr)
     {
-      for (compunit_symtab *cust : obj_file->compunits ())
+      /* Only the candidates of the segment of PC can contain it.  They
+	 are considered in the same order as in the walk below, after
+	 the compunits expanded since the index was built.  */
+      int segment = compunit_pc_index_segment (index.get (), pc);
+      auto cand = index->candidates.end ();
+      auto cand_end = index->candidates.end ();
+      size_t max_pending = std::max (index->n_compunits / 16, (size_t) 32);
+      size_t n_pending = 0;
+
+      if (segment >= 0)
 	{
-	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (cust);
-	  const struct block *global_block
-	    = BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK);
-	  CORE_ADDR start = BLOCK_START (global_block);
-	  CORE_ADDR end = BLOCK_END (global_block);
-	  bool in_range_p = start <= pc && pc < end;
-	  if (!in_range_p)
-	    continue;
+	  cand = index->candidates.begin () + index->offsets[segment];
+	  cand_end = index->candidates.begin () + index->offsets[segment + 1];
+	}
+
+      for (unsigned int i = 0; i < index->objfiles.size (); ++i)
+	{
+	  objfile *obj_file = index->objfiles[i].objfile;
 
-	  if (BLOCKVECTOR_MAP (bv))
+	  for (compunit_symtab *cust = obj_file->compunit_symtabs;
+	       cust != index->objfiles[i].first_cust;
+	       cust = cust->next)
 	    {
-	      if (addrmap_find (BLOCKVECTOR_MAP (bv), pc) == nullptr)
-		continue;
+	      /* Rebuild the index next time if too many compunits are
+		 not in it.  */
+	      if (++n_pending == max_pending)
+		invalidate_compunit_pc_index (current_program_space);
 
-	      return cust;
+	      compunit_symtab *result = consider (obj_file, cust);
+	      if (result != nullptr)
+		return result;
 	    }
 
-	  CORE_ADDR range = end - start;
-	  if (best_cust != nullptr
-	      && range >= best_cust_range)
-	    /* Cust doesn't have a smaller range than best_cust, skip it.  */
-	    continue;
-	
-	  /* For an objfile that has its functions reordered,
-	     find_pc_psymtab will find the proper partial symbol table
-	     and we simply return its corresponding symtab.  */
-	  /* In order to better support objfiles that contain both
-	     stabs and coff debugging info, we continue on if a psymtab
-	     can't be found.  */
-	  if ((obj_file->flags & OBJF_REORDERED) != 0)
+	  for (; cand != cand_end && cand->objfile_index == i; ++cand)
 	    {
-	      struct compunit_symtab *result;
-
-	      result
-		= obj_file->find_pc_sect_compunit_symtab (msymbol,
-							  pc,
-							  section,
-							  0);
-	      if (result != NULL)
+	      compunit_symtab *result = consider (obj_file, cand->cust);
+	      if (result != nullptr)
 		return result;
 	    }
-
-	  if (section != 0)
+	}
+    }
+  else
+    {
+      for (objfile *obj_file : current_program_space->objfiles ())
+	{
+	  for (compunit_symtab *cust : obj_file->compunits ())
 	    {
-	      struct symbol *sym = NULL;
-	      struct block_iterator iter;
-
-	      for (int b_index = GLOBAL_BLOCK;
-		   b_index <= STATIC_BLOCK && sym == NULL;
-		   ++b_index)
-		{
-		  const struct block *b = BLOCKVECTOR_BLOCK (bv, b_index);
-		  ALL_BLOCK_SYMBOLS (b, iter, sym)
-		    {
-		      fixup_symbol_section (sym, obj_file);
-		      if (matching_obj_sections (sym->obj_section (obj_file),
-						 section))
-			break;
-		    }
-		}
-	      if (sym == NULL)
-		continue;		/* No symbol in this symtab matches
-					   section.  */
+	      compunit_symtab *result = consider (obj_file, cust);
+	      if (result != nullptr)
+		return result;
 	    }
-
-	  /* Cust is best found sofar, save it.  */
-	  best_cust = cust;
-	  best_cust_range = range;
 	}
     }
 
@@ -3402,6 +3963,247 @@ find_pc_line_symtab (CORE_ADDR pc)
   return sal.symtab;
 }
 
+/* Line table indexes.
+
+   Looking up a line in a line table used to scan all of it, and
+   looking up a line in all the symtabs of a source file scanned all
+   the symtabs of all the objfiles.  Both are slow for big programs,
+   so they are indexed per objfile, the first time they are needed.
+
+   The index of a line table lists its statement entries sorted by
+   line, and then by position in the table.  The entries for one line
+   are thus found with a binary search, in table order.
+
+   The filetab index of an objfile maps each file name to the symtabs
+   with that name, in the order of a walk of the compunits of the
+   objfile.  Like the compunit PC index, it is not updated when
+   compunits are expanded; the compunits added since it was built are
+   those before the first indexed compunit of the objfile, and they
+   are walked before the indexed ones.  */
+
+struct line_table_index_entry
+{
+  int line;
+
+  /* The index of the entry in the line table.  */
+  int index;
+
+  bool operator< (const line_table_index_entry &other) const
+  {
+    if (line != other.line)
+      return line < other.line;
+    return index < other.index;
+  }
+};
+
+/* Hash and equality functions for file names, consistent with
+   FILENAME_CMP.  */
+
+struct filetab_index_hash
+{
+  size_t operator() (const char *filename) const
+  {
+    return filename_hash (filename);
+  }
+};
+
+struct filetab_index_eq
+{
+  bool operator() (const char *a, const char *b) const
+  {
+    return FILENAME_CMP (a, b) == 0;
+  }
+};
+
+/* The line table indexes of an objfile.  */
+
+struct line_table_indexes
+{
+  /* The index of each line table of the objfile that was looked
+     up.  */
+  std::unordered_map<const struct linetable *,
+		     std::vector<line_table_index_entry>> line_tables;
+
+  /* True if FILETABS is up to date.  */
+  bool filetabs_valid = false;
+
+  /* The first compunit of the objfile when FILETABS was built.  */
+  struct compunit_symtab *first_cust = nullptr;
+
+  /* The number of compunits in FILETABS.  */
+  size_t n_compunits = 0;
+
+  /* The symtabs of the objfile, by file name.  */
+  std::unordered_map<const char *, std::vector<struct symtab *>,
+		     filetab_index_hash, filetab_index_eq> filetabs;
+
+  /* The symtabs of the objfile, by base name of their file name.  */
+  std::unordered_map<const char *, std::vector<struct symtab *>,
+		     filetab_index_hash, filetab_index_eq> basenames;
+};
+
+/* Objfile key for finding its line table indexes.  */
+
+static const objfile_key<line_table_indexes> line_table_indexes_key;
+
+/* Whether line lookups use the line table indexes.  */
+
+static bool line_table_index_enabled = true;
+
+/* Return the line table indexes of OBJFILE, creating them if
+   needed.  */
+
+static line_table_indexes *
+get_line_table_indexes (struct objfile *objfile)
+{
+  line_table_indexes *indexes = line_table_indexes_key.get (objfile);
+  if (indexes == nullptr)
+    indexes = line_table_indexes_key.emplace (objfile);
+  return indexes;
+}
+
+/* Return the index of line table L of OBJFILE, building it if
+   needed.  */
+
+static const std::vector<line_table_index_entry> &
+get_line_table_index (struct objfile *objfile, const struct linetable *l)
+{
+  line_table_indexes *indexes = get_line_table_indexes (objfile);
+
+  auto iter = indexes->line_tables.find (l);
+  if (iter != indexes->line_tables.end ())
+    return iter->second;
+
+  std::vector<line_table_index_entry> &index = indexes->line_tables[l];
+  for (int i = 0; i < l->nitems; ++i)
+    {
+      /* find_line_common only considers statements, and only looks
+	 up positive line numbers.  */
+      if (l->item[i].is_stmt && l->item[i].line > 0)
+	index.push_back ({ l->item[i].line, i });
+    }
+  std::sort (index.begin (), index.end ());
+  index.shrink_to_fit ();
+
+  return index;
+}
+
+/* Return the line table indexes of OBJFILE, with the indexes of its
+   symtabs by file name up to date.  The compunits from the start of
+   the objfile's list to FIRST_CUST, which were expanded since the
+   indexes were built, are not in them.  */
+
+static line_table_indexes *
+get_filetab_indexes (struct objfile *objfile)
+{
+  line_table_indexes *indexes = get_line_table_indexes (objfile);
+
+  /* Rebuild the index if too many compunits are not in it.  */
+  if (indexes->filetabs_valid)
+    {
+      size_t max_pending = std::max (indexes->n_compunits / 16,
+				     (size_t) 32);
+      size_t n_pending = 0;
+
+      for (compunit_symtab *cu = objfile->compunit_symtabs;
+	   cu != indexes->first_cust;
+	   cu = cu->next)
+	if (++n_pending == max_pending)
+	  {
+	    indexes->filetabs_valid = false;
+	    break;
+	  }
+    }
+
+  if (!indexes->filetabs_valid)
+    {
+      indexes->filetabs.clear ();
+      indexes->basenames.clear ();
+      indexes->n_compunits = 0;
+      indexes->first_cust = objfile->compunit_symtabs;
+      for (compunit_symtab *cu : objfile->compunits ())
+	{
+	  for (symtab *s : compunit_filetabs (cu))
+	    {
+	      indexes->filetabs[s->filename].push_back (s);
+	      indexes->basenames[lbasename (s->filename)].push_back (s);
+	    }
+	  ++indexes->n_compunits;
+	}
+      indexes->filetabs_valid = true;
+    }
+
+  return indexes;
+}
+
+/* Call CALLBACK for each symtab of OBJFILE whose file name is
+   FILENAME, in the order of a walk of the compunits of OBJFILE.  Stop
+   and return true as soon as CALLBACK returns true, return false
+   otherwise.  */
+
+static bool
+iterate_over_filetabs_named
+  (struct objfile *objfile, const char *filename,
+   gdb::function_view<bool (struct symtab *)> callback)
+{
+  if (!line_table_index_enabled)
+    {
+      for (compunit_symtab *cu : objfile->compunits ())
+	for (symtab *s : compunit_filetabs (cu))
+	  if (FILENAME_CMP (filename, s->filename) == 0 && callback (s))
+	    return true;
+      return false;
+    }
+
+  line_table_indexes *indexes = get_filetab_indexes (objfile);
+
+  for (compunit_symtab *cu = objfile->compunit_symtabs;
+       cu != indexes->first_cust;
+       cu = cu->next)
+    for (symtab *s : compunit_filetabs (cu))
+      if (FILENAME_CMP (filename, s->filename) == 0 && callback (s))
+	return true;
+
+  auto iter = indexes->filetabs.find (filename);
+  if (iter != indexes->filetabs.end ())
+    for (symtab *s : iter->second)
+      if (callback (s))
+	return true;
+
+  return false;
+}
+
+/* See symtab.h.  */
+
+bool
+iterate_over_objfile_symtabs (struct objfile *objfile, const char *name,
+			      const char *real_path,
+			      gdb::function_view<bool (symtab *)> callback)
+{
+  /* Without the basename check of iterate_over_some_symtabs, any
+     symtab may match.  */
+  if (!line_table_index_enabled || basenames_may_differ)
+    return iterate_over_some_symtabs (name, real_path,
+				      objfile->compunit_symtabs, NULL,
+				      callback);
+
+  line_table_indexes *indexes = get_filetab_indexes (objfile);
+
+  if (iterate_over_some_symtabs (name, real_path, objfile->compunit_symtabs,
+				 indexes->first_cust, callback))
+    return true;
+
+  const char *base_name = lbasename (name);
+  auto iter = indexes->basenames.find (base_name);
+  if (iter != indexes->basenames.end ())
+    for (symtab *s : iter->second)
+      if (symtab_matches_filename (s, name, base_name, real_path)
+	  && callback (s))
+	return true;
+
+  return false;
+}
+
 /* Find line number LINE in any symtab whose name is the same as
    SYMTAB.
 
@@ -3428,7 +4230,8 @@ find_line_symtab (struct symtab *sym_tab, int line,
   /* First try looking it up in the given symtab.  */
   best_linetable = SYMTAB_LINETABLE (sym_tab);
   best_symtab = sym_tab;
-  best_index = find_line_common (best_linetable, line, &exact, 0);
+  best_index = find_line_common (SYMTAB_OBJFILE (sym_tab), best_linetable,
+				 line, &exact, 0);
   if (best_index < 0 || !exact)
     {
       /* Didn't find an exact match.  So we better keep looking for
@@ -3451,44 +4254,42 @@ find_line_symtab (struct symtab *sym_tab, int line,
       for (objfile *objfile : current_program_space->objfiles ())
 	objfile->expand_symtabs_with_fullname (symtab_to_fullname (sym_tab));
 
-      for (objfile *objfile : current_program_space->objfiles ())
+      auto check_symtab = [&] (symtab *s)
 	{
-	  for (compunit_symtab *cu : objfile->compunits ())
+	  struct linetable *l;
+	  int ind;
+
+	  if (FILENAME_CMP (symtab_to_fullname (sym_tab),
+			    symtab_to_fullname (s)) != 0)
+	    return false;
+	  l = SYMTAB_LINETABLE (s);
+	  ind = find_line_common (SYMTAB_OBJFILE (s), l, line, &exact, 0);
+	  if (ind >= 0)
 	    {
-	      for (symtab *s : compunit_filetabs (cu))
+	      if (exact)
 		{
-		  struct linetable *l;
-		  int ind;
-
-		  if (FILENAME_CMP (sym_tab->filename, s->filename) != 0)
-		    continue;
-		  if (FILENAME_CMP (symtab_to_fullname (sym_tab),
-				    symtab_to_fullname (s)) != 0)
-		    continue;	
-		  l = SYMTAB_LINETABLE (s);
-		  ind = find_line_common (l, line, &exact, 0);
-		  if (ind >= 0)
-		    {
-		      if (exact)
-			{
-			  best_index = ind;
-			  best_linetable = l;
-			  best_symtab = s;
-			  goto done;
-			}
-		      if (best == 0 || l->item[ind].line < best)
-			{
-			  best = l->item[ind].line;
-			  best_index = ind;
-			  best_linetable = l;
-			  best_symtab = s;
-			}
-		    }
+		  best_index = ind;
+		  best_linetable = l;
+		  best_symtab = s;
+		  return true;
+		}
+	      if (best == 0 || l->item[ind].line < best)
+		{
+		  best = l->item[ind].line;
+		  best_index = ind;
+		  best_linetable = l;
+		  best_symtab = s;
 		}
 	    }
-	}
+	  return false;
+	};
+
+      for (objfile *objfile : current_program_space->objfiles ())
+	if (iterate_over_filetabs_named (objfile, sym_tab->filename,
+					 check_symtab))
+	  break;
     }
-done:
+
   if (best_index < 0)
     return NULL;
 
@@ -3517,7 +4318,8 @@ find_pcs_for_symtab_line (struct symtab *symtab, int line,
       int was_exact;
       int idx;
 
-      idx = find_line_common (SYMTAB_LINETABLE (symtab), line, &was_exact,
+      idx = find_line_common (SYMTAB_OBJFILE (symtab),
+			      SYMTAB_LINETABLE (symtab), line, &was_exact,
 			      start);
       if (idx < 0)
 	break;
@@ -3605,15 +4407,16 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
   return true;
 }
 
-/* Given a line table and a line number, return the index into the line
-   table for the pc of the nearest line whose number is >= the specified one.
+/* Given a line table of OBJFILE and a line number, return the index
+   into the line table for the pc of the nearest line whose number is >=
+   the specified one.
    Return -1 if none is found.  The value is >= 0 if it is an index.
    START is the index at which to start searching the line table.
 
    Set *EXACT_MATCH nonzero if the value returned is an exact match.  */
 
 static int
-find_line_common (struct linetable *l, int lineno,
+find_line_common (struct objfile *objfile, struct linetable *l, int lineno,
 		  int *exact_match, int start)
 {
   int i;
@@ -3633,6 +4436,43 @@ find_line_common (struct linetable *l, int lineno,
   if (l == 0)
     return -1;
 
+  if (line_table_index_enabled)
+    {
+      const std::vector<line_table_index_entry> &index
+	= get_line_table_index (objfile, l);
+
+      /* The first entry for LINENO at or after START, if any.  */
+      auto iter = std::lower_bound (index.begin (), index.end (),
+				    line_table_index_entry { lineno, start });
+      if (iter != index.end () && iter->line == lineno)
+	{
+	  *exact_match = 1;
+	  return iter->index;
+	}
+
+      /* Otherwise, ITER is the first entry of the smallest line
+	 > LINENO.  Find the first line with an entry at or after
+	 START.  */
+      while (iter != index.end ())
+	{
+	  int line = iter->line;
+	  auto line_end
+	    = std::partition_point (iter, index.end (),
+				    [=] (const line_table_index_entry &entry)
+				    {
+				      return entry.line == line;
+				    });
+	  auto found = std::lower_bound (iter, line_end,
+					 line_table_index_entry { line,
+								  start });
+	  if (found != line_end)
+	    return found->index;
+	  iter = line_end;
+	}
+
+      return -1;
+    }
+
   len = l->nitems;
   for (i = start; i < len; i++)
     {
@@ -4753,7 +5593,8 @@ global_symbol_searcher::add_matching_symbols
 	(objfile *objfile,
 	 const gdb::optional<compiled_regex> &preg,
 	 const gdb::optional<compiled_regex> &treg,
-	 std::set<symbol_search> *result_set) const
+	 std::set<symbol_search> *result_set,
+	 size_t max_results) const
 {
   enum search_domain kind = m_kind;
 
@@ -4811,7 +5652,7 @@ global_symbol_searcher::add_matching_symbols
 			      && SYMBOL_DOMAIN (sym) == MODULE_DOMAIN
 			      && SYMBOL_LINE (sym) != 0))))
 		{
-		  if (result_set->size () < m_max_search_results)
+		  if (result_set->size () < max_results)
 		    {
 		      /* Match, insert if not already in the results.  */
 		      symbol_search ss (block, sym);
@@ -4833,7 +5674,7 @@ global_symbol_searcher::add_matching_symbols
 bool
 global_symbol_searcher::add_matching_msymbols
 	(objfile *objfile, const gdb::optional<compiled_regex> &preg,
-	 std::vector<symbol_search> *results) const
+	 std::vector<symbol_search> *results, size_t max_results) const
 {
   enum search_domain kind = m_kind;
 
@@ -4862,7 +5703,7 @@ global_symbol_searcher::add_matching_msymbols
 		       VAR_DOMAIN).symbol == NULL)
 		    {
 		      /* Matching msymbol, add it to the results list.  */
-		      if (results->size () < m_max_search_results)
+		      if (results->size () < max_results)
 			results->emplace_back (GLOBAL_BLOCK, msymbol, objfile);
 		      else
 			return false;
@@ -4877,14 +5718,11 @@ global_symbol_searcher::add_matching_msymbols
 
 /* See symtab.h.  */
 
-std::vector<symbol_search>
-global_symbol_searcher::search () const
+void
+global_symbol_searcher::compile_regexps
+	(gdb::optional<compiled_regex> *preg,
+	 gdb::optional<compiled_regex> *treg) const
 {
-  gdb::optional<compiled_regex> preg;
-  gdb::optional<compiled_regex> treg;
-
-  gdb_assert (m_kind != ALL_DOMAIN);
-
   if (m_symbol_name_regexp != NULL)
     {
       const char *symbol_name_regexp = m_symbol_name_regexp;
@@ -4925,17 +5763,30 @@ global_symbol_searcher::search () const
 
       int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
 				? REG_ICASE : 0);
-      preg.emplace (symbol_name_regexp, cflags,
-		    _("Invalid regexp"));
+      preg->emplace (symbol_name_regexp, cflags,
+		     _("Invalid regexp"));
     }
 
   if (m_symbol_type_regexp != NULL)
     {
       int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
 				? REG_ICASE : 0);
-      treg.emplace (m_symbol_type_regexp, cflags,
-		    _("Invalid regexp"));
+      treg->emplace (m_symbol_type_regexp, cflags,
+		     _("Invalid regexp"));
     }
+}
+
+/* See symtab.h.  */
+
+std::vector<symbol_search>
+global_symbol_searcher::search () const
+{
+  gdb::optional<compiled_regex> preg;
+  gdb::optional<compiled_regex> treg;
+
+  gdb_assert (m_kind != ALL_DOMAIN);
+
+  compile_regexps (&preg, &treg);
 
   bool found_msymbol = false;
   std::set<symbol_search> result_set;
@@ -4949,7 +5800,8 @@ global_symbol_searcher::search () const
 	 RESULT_SET set.  Use a set here so that we can easily detect
 	 duplicates as we go, and can therefore track how many unique
 	 matches we have found so far.  */
-      if (!add_matching_symbols (objfile, preg, treg, &result_set))
+      if (!add_matching_symbols (objfile, preg, treg, &result_set,
+				 m_max_search_results))
 	break;
     }
 
@@ -4967,7 +5819,8 @@ global_symbol_searcher::search () const
     {
       gdb_assert (m_kind == VARIABLES_DOMAIN || m_kind == FUNCTIONS_DOMAIN);
       for (objfile *objfile : current_program_space->objfiles ())
-	if (!add_matching_msymbols (objfile, preg, &result))
+	if (!add_matching_msymbols (objfile, preg, &result,
+				    m_max_search_results))
 	  break;
     }
 
@@ -4976,6 +5829,73 @@ global_symbol_searcher::search () const
 
 /* See symtab.h.  */
 
+void
+global_symbol_searcher::search
+	(gdb::function_view<bool (std::vector<symbol_search> &)> callback) const
+{
+  gdb::optional<compiled_regex> preg;
+  gdb::optional<compiled_regex> treg;
+
+  gdb_assert (m_kind != ALL_DOMAIN);
+
+  compile_regexps (&preg, &treg);
+
+  /* The number of results that may still be passed to CALLBACK.  */
+  size_t remaining = m_max_search_results;
+  bool found_msymbol = false;
+  std::vector<symbol_search> batch;
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      found_msymbol |= expand_symtabs (objfile, preg);
+
+      /* Unlike SEARCH above, the set only holds the matches of this
+	 objfile, which is where duplicates come from: the compunits of
+	 an objfile often share a header.  It is emptied once they have
+	 been passed to CALLBACK.  */
+      std::set<symbol_search> result_set;
+      bool complete = add_matching_symbols (objfile, preg, treg,
+					    &result_set, remaining);
+
+      if (!result_set.empty ())
+	{
+	  batch.assign (result_set.begin (), result_set.end ());
+	  result_set.clear ();
+	  remaining -= batch.size ();
+	  if (!callback (batch))
+	    return;
+	  batch.clear ();
+	}
+
+      if (!complete || remaining == 0)
+	return;
+    }
+
+  if ((found_msymbol || (filenames.empty () && m_kind == VARIABLES_DOMAIN))
+      && !m_exclude_minsyms
+      && !treg.has_value ())
+    {
+      gdb_assert (m_kind == VARIABLES_DOMAIN || m_kind == FUNCTIONS_DOMAIN);
+      for (objfile *objfile : current_program_space->objfiles ())
+	{
+	  bool complete = add_matching_msymbols (objfile, preg, &batch,
+						 remaining);
+
+	  if (!batch.empty ())
+	    {
+	      remaining -= batch.size ();
+	      if (!callback (batch))
+		return;
+	      batch.clear ();
+	    }
+
+	  if (!complete || remaining == 0)
+	    return;
+	}
+    }
+}
+
+/* See symtab.h.  */
+
 std::string
 symbol_to_info_string (struct symbol *sym, int block,
 		       enum search_domain kind)
@@ -5096,7 +6016,8 @@ print_msymbol_info (struct bound_minimal_symbol msymbol)
 /* This is the guts of the commands "info functions", "info types", and
    "info variables".  It calls search_symbols to find all matches and then
    print_[m]symbol_info to print out some useful information about the
-   matches.  */
+   matches.  When SYMBOL_SEARCH_STREAMING is set, the matches of each
+   objfile are printed as soon as they are found.  */
 
 static void
 symtab_symbol_info (bool quiet, bool exclude_minsyms,
@@ -5107,6 +6028,7 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
     {"variable", "function", "type", "module"};
   const char *last_filename = "";
   int first = 1;
+  bool header_printed = false;
 
   gdb_assert (kind != ALL_DOMAIN);
 
@@ -5116,10 +6038,15 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
   global_symbol_searcher spec (kind, regexp);
   spec.set_symbol_type_regexp (t_regexp);
   spec.set_exclude_minsyms (exclude_minsyms);
-  std::vector<symbol_search> symbols = spec.search ();
 
-  if (!quiet)
+  /* Print the header, once, after the search has validated the
+     regexps.  */
+  auto print_header = [&] ()
     {
+      if (header_printed || quiet)
+	return;
+      header_printed = true;
+
       if (regexp != NULL)
 	{
 	  if (t_regexp != NULL)
@@ -5141,32 +6068,49 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
 	  else
 	    printf_filtered (_("All defined %ss:\n"), classnames[kind]);
 	}
-    }
+    };
 
-  for (const symbol_search &p : symbols)
+  auto print_results = [&] (std::vector<symbol_search> &symbols)
     {
-      QUIT;
+      print_header ();
 
-      if (p.msymbol.minsym != NULL)
+      for (const symbol_search &p : symbols)
 	{
-	  if (first)
+	  QUIT;
+
+	  if (p.msymbol.minsym != NULL)
 	    {
-	      if (!quiet)
-		printf_filtered (_("\nNon-debugging symbols:\n"));
-	      first = 0;
+	      if (first)
+		{
+		  if (!quiet)
+		    printf_filtered (_("\nNon-debugging symbols:\n"));
+		  first = 0;
+		}
+	      print_msymbol_info (p.msymbol);
+	    }
+	  else
+	    {
+	      print_symbol_info (kind,
+				 p.symbol,
+				 p.block,
+				 last_filename);
+	      last_filename
+		= symtab_to_filename_for_display (symbol_symtab (p.symbol));
 	    }
-	  print_msymbol_info (p.msymbol);
-	}
-      else
-	{
-	  print_symbol_info (kind,
-			     p.symbol,
-			     p.block,
-			     last_filename);
-	  last_filename
-	    = symtab_to_filename_for_display (symbol_symtab (p.symbol));
 	}
+
+      return true;
+    };
+
+  if (symbol_search_streaming)
+    spec.search (print_results);
+  else
+    {
+      std::vector<symbol_search> symbols = spec.search ();
+      print_results (symbols);
     }
+
+  print_header ();
 }
 
 /* Structure to hold the values of the options used by the 'info variables'
@@ -5838,21 +6782,21 @@ default_collect_symbol_completion_matches_break_on
   if (code == TYPE_CODE_UNDEF)
     {
       for (objfile *objfile : current_program_space->objfiles ())
-	{
-	  for (minimal_symbol *msymbol : objfile->msymbols ())
-	    {
-	      QUIT;
+	iterate_over_minimal_symbol_candidates
+	  (objfile, lookup_name, [&] (minimal_symbol *msymbol)
+	   {
+	     QUIT;
 
-	      if (completion_skip_symbol (mode, msymbol))
-		continue;
+	     if (completion_skip_symbol (mode, msymbol))
+	       return false;
 
-	      completion_list_add_msymbol (tracker, msymbol, lookup_name,
-					   sym_text, word);
+	     completion_list_add_msymbol (tracker, msymbol, lookup_name,
+					  sym_text, word);
 
-	      completion_list_objc_symbol (tracker, msymbol, lookup_name,
-					   sym_text, word);
-	    }
-	}
+	     completion_list_objc_symbol (tracker, msymbol, lookup_name,
+					  sym_text, word);
+	     return false;
+	   });
     }
 
   /* Add completions for all currently loaded symbol tables.  */
@@ -7002,6 +7946,19 @@ one base name, and gdb will do file name comparisons more efficiently."),
 			   NULL, NULL,
 			   &setlist, &showlist);
 
+  add_setshow_boolean_cmd ("symbol-search-streaming", class_support,
+			   &symbol_search_streaming, _("\
+Set whether symbol searches print their matches one objfile at a time."), _("\
+Show whether symbol searches print their matches one objfile at a time."), _("\
+If set, \"info functions\", \"info variables\", \"info types\" and the\n\
+-symbol-info-* MI commands print the matches of each objfile, sorted,\n\
+as soon as they are found, and only keep one objfile's matches in memory.\n\
+A symbol found in several objfiles is printed once for each of them.\n\
+If not set (the default), the matches of all objfiles are collected and\n\
+sorted together before any of them is printed."),
+			   NULL, NULL,
+			   &setlist, &showlist);
+
   add_setshow_zuinteger_cmd ("symtab-create", no_class, &symtab_create_debug,
 			     _("Set debugging of symbol table creation."),
 			     _("Show debugging of symbol table creation."), _("\
@@ -7030,6 +7987,38 @@ If zero then the symbol cache is disabled."),
 			     &maintenance_set_cmdlist,
 			     &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("symbol-cache-auto-resize", class_maintenance,
+			   &symbol_cache_auto_resize, _("\
+Set whether the symbol cache grows when it is too small."), _("\
+Show whether the symbol cache grows when it is too small."), _("\
+When on, the symbol cache grows beyond symbol-cache-size, up to\n\
+1048576 entries, when the symbols looked up don't fit in it."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_setshow_boolean_cmd ("compunit-pc-index", class_maintenance,
+			   &compunit_pc_index_enabled, _("\
+Set whether compunit symtabs are found by PC with an index."), _("\
+Show whether compunit symtabs are found by PC with an index."), _("\
+When on, GDB finds the compunit symtab of a PC with a sorted index\n\
+of the address ranges of the expanded compunit symtabs.  When off,\n\
+GDB checks each of the expanded compunit symtabs."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_setshow_boolean_cmd ("line-table-index", class_maintenance,
+			   &line_table_index_enabled, _("\
+Set whether lines are looked up in line tables with an index."), _("\
+Show whether lines are looked up in line tables with an index."), _("\
+When on, GDB finds the entries of a line in a line table, and the\n\
+symtabs of a source file, with indexes built the first time they are\n\
+needed.  When off, GDB scans the line tables and the symtabs."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_cmd ("symbol-cache", class_maintenance, maintenance_print_symbol_cache,
 	   _("Dump the symbol cache for each program space."),
 	   &maintenanceprintlist);
@@ -590,10 +590,13 @@ extern CORE_ADDR get_symbol_address (const struct symbol *sym);
    language of that symbol.  If the language is set to language_auto,
    it will attempt to find any demangling algorithm that works and
    then set the language appropriately.  The returned name is allocated
-   by the demangler and should be xfree'd.  */
+   by the demangler and should be xfree'd.  If PER_BFD is not NULL and
+   has a demangle cache, the name is looked up there first, and
+   recorded there otherwise.  */
 
 extern gdb::unique_xmalloc_ptr<char> symbol_find_demangled_name
-     (struct general_symbol_info *gsymbol, const char *mangled);
+     (struct general_symbol_info *gsymbol, const char *mangled,
+      objfile_per_bfd_storage *per_bfd = nullptr);
 
 /* Return true if NAME matches the "search" name of SYMBOL, according
    to the symbol's language.  */
@@ -1402,7 +1405,7 @@ struct symtab
 };
 
 #define SYMTAB_COMPUNIT(symtab) ((symtab)->compunit_symtab)
-#define SYMTAB_LINETABLE(symtab) ((symtab)->linetable)
+#define SYMTAB_LINETABLE(symtab) (symtab_linetable (symtab))
 #define SYMTAB_LANGUAGE(symtab) ((symtab)->language)
 #define SYMTAB_BLOCKVECTOR(symtab) \
   COMPUNIT_BLOCKVECTOR (SYMTAB_COMPUNIT (symtab))
@@ -1412,6 +1415,17 @@ struct symtab
 #define SYMTAB_DIRNAME(symtab) \
   COMPUNIT_DIRNAME (SYMTAB_COMPUNIT (symtab))
 
+/* Symbol readers that defer reading the line tables of a compunit
+   until they are needed implement this interface.  */
+
+struct line_table_reader
+{
+  virtual ~line_table_reader () = default;
+
+  /* Read the line tables of the symtabs of CUST and install them.  */
+  virtual void read_line_tables (struct compunit_symtab *cust) = 0;
+};
+
 /* Compunit symtabs contain the actual "symbol table", aka blockvector, as well
    as the list of all source files (what gdb has historically associated with
    the term "symtab").
@@ -1531,6 +1545,11 @@ struct compunit_symtab
      containing this one.  An included compunit may itself be
      included by another.  */
   struct compunit_symtab *user;
+
+  /* If non-NULL, the line tables of the symtabs of this compunit have
+     not been read in yet.  They are read in by this object the first
+     time one of them is requested, see symtab_linetable.  */
+  struct line_table_reader *pending_line_tables;
 };
 
 using compunit_symtab_range = next_range<compunit_symtab>;
@@ -1546,6 +1565,26 @@ using compunit_symtab_range = next_range<compunit_symtab>;
 #define COMPUNIT_EPILOGUE_UNWIND_VALID(cust) ((cust)->epilogue_unwind_valid)
 #define COMPUNIT_MACRO_TABLE(cust) ((cust)->macro_table)
 
+/* Return the line table of SYMTAB, reading the line tables of its
+   compunit first if that was deferred.  */
+
+static inline struct linetable *&
+symtab_linetable (struct symtab *symtab)
+{
+  struct compunit_symtab *cust = symtab->compunit_symtab;
+
+  if (cust->pending_line_tables != nullptr)
+    {
+      struct line_table_reader *reader = cust->pending_line_tables;
+
+      /* Clear this first, so that we don't try again if reading fails.  */
+      cust->pending_line_tables = nullptr;
+      reader->read_line_tables (cust);
+    }
+
+  return symtab->linetable;
+}
+
 /* A range adapter to allowing iterating over all the file tables
    within a compunit.  */
 
@@ -1845,6 +1884,12 @@ extern struct compunit_symtab *find_pc_compunit_symtab (CORE_ADDR);
 extern struct compunit_symtab *
   find_pc_sect_compunit_symtab (CORE_ADDR, struct obj_section *);
 
+/* Rebuild the index used by find_pc_sect_compunit_symtab for PSPACE
+   next time it is needed.  Called when objfiles are added, removed or
+   relocated.  */
+
+extern void invalidate_compunit_pc_index (struct program_space *pspace);
+
 extern bool find_pc_line_pc_range (CORE_ADDR, CORE_ADDR *, CORE_ADDR *);
 
 extern void reread_symbols (int from_tty);
@@ -2142,6 +2187,17 @@ class global_symbol_searcher
      removed.  */
   std::vector<symbol_search> search () const;
 
+  /* Like the above, but rather than collecting every match before
+     returning, pass the matches to CALLBACK one objfile at a time.  The
+     matches in each batch are sorted and de-duplicated as above, but the
+     batches are not merged, so only the matches of a single objfile are
+     held in memory at once.  A symbol found in several objfiles is
+     passed once for each of them.  The debug symbols of all objfiles are
+     passed before any minimal symbol.  CALLBACK may take the contents of
+     the vector; if it returns false, the search stops.  */
+  void search (gdb::function_view<bool (std::vector<symbol_search> &)>
+	       callback) const;
+
   /* The set of source files to search in for matching symbols.  This is
      currently public so that it can be populated after this object has
      been constructed.  */
@@ -2171,6 +2227,11 @@ class global_symbol_searcher
      of SIZE_MAX, there is no "unlimited".  */
   size_t m_max_search_results = SIZE_MAX;
 
+  /* Compile M_SYMBOL_NAME_REGEXP into PREG and M_SYMBOL_TYPE_REGEXP into
+     TREG, leaving them empty when there is no such regexp.  */
+  void compile_regexps (gdb::optional<compiled_regex> *preg,
+			gdb::optional<compiled_regex> *treg) const;
+
   /* Expand symtabs in OBJFILE that match PREG, are of type M_KIND.  Return
      true if any msymbols were seen that we should later consider adding to
      the results list.  */
@@ -2179,30 +2240,37 @@ class global_symbol_searcher
 
   /* Add symbols from symtabs in OBJFILE that match PREG, and TREG, and are
      of type M_KIND, to the results set RESULTS_SET.  Return false if we
-     stop adding results early due to having already found too many results
-     (based on M_MAX_SEARCH_RESULTS limit), otherwise return true.
-     Returning true does not indicate that any results were added, just
-     that we didn't _not_ add a result due to reaching MAX_SEARCH_RESULTS.  */
+     stop adding results early due to RESULT_SET already holding
+     MAX_RESULTS results, otherwise return true.  Returning true does not
+     indicate that any results were added, just that we didn't _not_ add
+     a result due to reaching MAX_RESULTS.  */
   bool add_matching_symbols (objfile *objfile,
 			     const gdb::optional<compiled_regex> &preg,
 			     const gdb::optional<compiled_regex> &treg,
-			     std::set<symbol_search> *result_set) const;
+			     std::set<symbol_search> *result_set,
+			     size_t max_results) const;
 
   /* Add msymbols from OBJFILE that match PREG and M_KIND, to the results
      vector RESULTS.  Return false if we stop adding results early due to
-     having already found too many results (based on max search results
-     limit M_MAX_SEARCH_RESULTS), otherwise return true.  Returning true
-     does not indicate that any results were added, just that we didn't
-     _not_ add a result due to reaching MAX_SEARCH_RESULTS.  */
+     RESULTS already holding MAX_RESULTS results, otherwise return true.
+     Returning true does not indicate that any results were added, just
+     that we didn't _not_ add a result due to reaching MAX_RESULTS.  */
   bool add_matching_msymbols (objfile *objfile,
 			      const gdb::optional<compiled_regex> &preg,
-			      std::vector<symbol_search> *results) const;
+			      std::vector<symbol_search> *results,
+			      size_t max_results) const;
 
   /* Return true if MSYMBOL is of type KIND.  */
   static bool is_suitable_msymbol (const enum search_domain kind,
 				   const minimal_symbol *msymbol);
 };
 
+/* True if the "info functions", "info variables" and "info types"
+   commands, and their MI counterparts, print the matches of each objfile
+   as soon as they are found rather than sorting all the matches of the
+   program together.  */
+extern bool symbol_search_streaming;
+
 /* When searching for Fortran symbols within modules (functions/variables)
    we return a vector of this type.  The first item in the pair is the
    module symbol, and the second item is the symbol for the function or
@@ -2257,6 +2325,41 @@ extern unsigned int symtab_create_debug;
 
 extern unsigned int symbol_lookup_debug;
 
+/* Usage statistics of the global or static block part of the symbol
+   cache of a program space.  */
+
+struct symbol_cache_statistics
+{
+  /* The number of entries the cache can hold.  */
+  unsigned int size = 0;
+
+  /* The number of lookups found in the cache, including the lookups
+     that are known to fail.  */
+  unsigned int hits = 0;
+
+  /* The number of hits for lookups that are known to fail.  */
+  unsigned int not_found_hits = 0;
+
+  /* The number of lookups not found in the cache.  */
+  unsigned int misses = 0;
+
+  /* The number of entries replaced by newer ones.  */
+  unsigned int evictions = 0;
+
+  /* The number of times the cache grew.  */
+  unsigned int resizes = 0;
+};
+
+/* If PSPACE has an enabled symbol cache, store the usage statistics of
+   its global and static block parts in *GLOBAL_STATS and *STATIC_STATS,
+   and return true.  Otherwise return false.  The counters are reset
+   when the cache is flushed.  */
+
+extern bool get_symbol_cache_statistics
+  (struct program_space *pspace,
+   struct symbol_cache_statistics *global_stats,
+   struct symbol_cache_statistics *static_stats);
+
 extern bool basenames_may_differ;
 
 bool compare_filenames_for_search (const char *filename,
@@ -2271,6 +2374,17 @@ bool iterate_over_some_symtabs (const char *name,
 				struct compunit_symtab *after_last,
 				gdb::function_view<bool (symtab *)> callback);
 
+/* Call CALLBACK for each expanded symtab of OBJFILE matching NAME, as
+   iterate_over_some_symtabs does for all the compunits of OBJFILE, and
+   in the same order.  Only the symtabs whose file has the same base
+   name as NAME are checked, found with an index of the symtabs of
+   OBJFILE, unless "maint set line-table-index" is off or base names
+   may differ.  */
+
+bool iterate_over_objfile_symtabs
+  (struct objfile *objfile, const char *name, const char *real_path,
+   gdb::function_view<bool (symtab *)> callback);
+
 void iterate_over_symtabs (const char *name,
 			   gdb::function_view<bool (symtab *)> callback);
 
@@ -0,0 +1,53 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2021 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Enough symbols that the dictionaries have several groups of
+   slots.  */
+
+#define DEFINE4(prefix) \
+  int prefix##0 = 1; int prefix##1 = 2; int prefix##2 = 3; int prefix##3 = 4;
+#define DEFINE16(prefix) \
+  DEFINE4 (prefix##0) DEFINE4 (prefix##1) DEFINE4 (prefix##2) DEFINE4 (prefix##3)
+
+DEFINE16 (global_)
+DEFINE16 (other_)
+
+/* A structure tag and a variable with the same name, in the same
+   block.  */
+
+struct same_name
+{
+  int member;
+};
+
+int same_name = 42;
+
+static int static_var = 7;
+
+static int
+static_func (int x)
+{
+  return x + static_var;
+}
+
+int
+main (void)
+{
+  struct same_name s = { 1 };
+
+  return static_func (s.member) + same_name + global_12;
+}
@@ -0,0 +1,61 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2021 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int counter;
+
+void
+stop (void)
+{
+  counter++;
+}
+
+int
+recurse (int depth)
+{
+  volatile int local = depth;
+
+  if (depth > 0)
+    return recurse (depth - 1) + local;
+  stop ();
+  stop ();
+  return local;
+}
+
+/* Inlined in OUTER, so that the frame of OUTER is above an inline
+   frame.  */
+
+static inline __attribute__ ((always_inline)) void
+middle (void)
+{
+  stop ();
+}
+
+void
+outer (void)
+{
+  while (counter < 4)
+    middle ();
+}
+
+int
+main (void)
+{
+  int result = recurse (10);
+
+  outer ();
+  return result;
+}
@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2021 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+
+template<typename T, typename U>
+struct pair_holder
+{
+  T first;
+  U second;
+
+  T get_first (U unused) { return first; }
+};
+
+template<typename T>
+unsigned
+count (T x)
+{
+  return (unsigned) x;
+}
+
+int
+main ()
+{
+  pair_holder<int, char> a = { 1, 'a' };
+  pair_holder<long, unsigned char> b = { 2, 'b' };
+
+  return (a.get_first ('x') + b.get_first ('y')
+	  + count<short> (3) + count<long long> (4));
+}
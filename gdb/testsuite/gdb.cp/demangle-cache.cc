@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2021 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace demangle_ns
+{
+  struct thing
+  {
+    int method (int x) { return x + 1; }
+  };
+
+  int
+  func (int x)
+  {
+    return x * 2;
+  }
+
+  int
+  func (double x)
+  {
+    return (int) x;
+  }
+}
+
+template<typename T>
+T
+identity (T x)
+{
+  return x;
+}
+
+int
+main ()
+{
+  demangle_ns::thing t;
+
+  return (demangle_ns::func (1) + demangle_ns::func (2.0)
+	  + t.method (3) + identity<long> (4));
+}
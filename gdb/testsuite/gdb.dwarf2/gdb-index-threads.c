@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2021 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct shared_type
+{
+  int x;
+};
+
+static int shared_static = 1;
+int global_1 = 2;
+
+extern int func_2 (struct shared_type *);
+
+static int
+shared_func (void)
+{
+  return shared_static;
+}
+
+int
+main (void)
+{
+  struct shared_type s = { global_1 };
+
+  return func_2 (&s) + shared_func ();
+}
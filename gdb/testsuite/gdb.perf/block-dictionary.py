@@ -0,0 +1,52 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures symbol lookups in a large global block,
+# with each implementation of the block dictionaries.
+
+from perftest import perftest
+from perftest import utils
+
+
+class BlockDictionary(perftest.TestCaseComparingSettings):
+    def __init__(self, binfile, symbol_count, lookup_count):
+        super(BlockDictionary, self).__init__(
+            "block-dictionary",
+            perftest.setting_configurations(
+                "maint set global-block-dictionary",
+                ("chained", "open-addressing"),
+            ),
+        )
+        self.binfile = binfile
+        # Half of the lookups find a symbol, half of them don't.
+        step = max(1, 2 * symbol_count // lookup_count)
+        self.names = []
+        for i in range(0, symbol_count, step):
+            self.names.append("global_%d" % i)
+            self.names.append("missing_%d" % i)
+
+    def warm_up(self):
+        # Measure the dictionary, not the symbol cache.
+        utils.safe_execute("maint set symbol-cache-size 0")
+
+    def configure(self):
+        # Read the symbols again, with this dictionary.
+        utils.select_file(None)
+        utils.select_file(self.binfile)
+        utils.safe_execute("maint expand-symtabs")
+
+    def operation(self):
+        for name in self.names:
+            gdb.lookup_global_symbol(name)
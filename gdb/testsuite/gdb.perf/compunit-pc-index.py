@@ -0,0 +1,45 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures finding the symbol table of addresses, with
+# and without the index of the address ranges of the symbol tables.
+
+from perftest import perftest
+from perftest import utils
+
+
+class CompunitPcIndex(perftest.TestCaseComparingSettings):
+    def __init__(self, compunit_count, func_count):
+        super(CompunitPcIndex, self).__init__(
+            "compunit-pc-index",
+            perftest.setting_configurations(
+                "maint set compunit-pc-index", ("on", "off")
+            ),
+        )
+        self.names = []
+        for i in range(0, compunit_count):
+            for j in range(0, func_count):
+                self.names.append("func_%d_%d" % (i, j))
+
+    def warm_up(self):
+        utils.safe_execute("maint expand-symtabs")
+        self.pcs = []
+        for name in self.names:
+            sym = gdb.lookup_global_symbol(name)
+            self.pcs.append(int(sym.value().address))
+
+    def operation(self):
+        for pc in self.pcs:
+            gdb.find_pc_line(pc)
@@ -0,0 +1,40 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures unwinding every frame of a deep stack after
+# flushing the frame cache, as happens at each step, with and without
+# the DWARF CFI cache.
+
+from perftest import perftest
+
+
+class DwarfCfiCache(perftest.TestCaseComparingSettings):
+    def __init__(self):
+        super(DwarfCfiCache, self).__init__(
+            "dwarf-cfi-cache",
+            perftest.setting_configurations(
+                "maint set dwarf cfi-cache", ("on", "off"), "cfi-cache-%s"
+            ),
+        )
+
+    def warm_up(self):
+        self.operation()
+
+    def operation(self):
+        for _ in range(0, 20):
+            gdb.execute("maint flush register-cache", False, True)
+            frame = gdb.newest_frame()
+            while frame is not None:
+                frame = frame.older()
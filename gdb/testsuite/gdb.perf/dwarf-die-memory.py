@@ -0,0 +1,36 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures reading the full DIEs of a large CU.
+
+from perftest import perftest
+from perftest import utils
+
+
+class DwarfDieMemory(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, binfile):
+        super(DwarfDieMemory, self).__init__("dwarf-die-memory")
+        self.binfile = binfile
+
+    def warm_up(self):
+        pass
+
+    def _expand(self):
+        gdb.execute("maint expand-symtabs", False, True)
+
+    def execute_test(self):
+        for i in range(1, 4):
+            utils.select_file(self.binfile)
+            self.measure.measure(self._expand, i)
@@ -0,0 +1,48 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures printing the local variables of every frame
+# of a deep stack, with the fast DWARF expression evaluator and its
+# compiled expression cache, with the fast evaluator alone, and with
+# the general evaluator.
+
+from perftest import perftest
+
+
+class DwarfExprEval(perftest.TestCaseComparingSettings):
+    def __init__(self):
+        configurations = []
+        for name, fast, cache in (
+            ("cached", "on", "on"),
+            ("fast", "on", "off"),
+            ("general", "off", "off"),
+        ):
+            configurations.append(
+                (
+                    name,
+                    [
+                        "maint set dwarf fast-expression-evaluation " + fast,
+                        "maint set dwarf expression-cache " + cache,
+                    ],
+                )
+            )
+        super(DwarfExprEval, self).__init__("dwarf-expr-eval", configurations)
+
+    def warm_up(self):
+        gdb.execute("bt full", False, True)
+
+    def operation(self):
+        for _ in range(0, 5):
+            gdb.execute("bt full", False, True)
@@ -0,0 +1,38 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures stepping in the innermost frame of a deep
+# stack and printing a backtrace after each step, with and without the
+# frames kept across stops.
+
+from perftest import perftest
+
+
+class FrameCachePersist(perftest.TestCaseComparingSettings):
+    def __init__(self):
+        super(FrameCachePersist, self).__init__(
+            "frame-cache-persist",
+            perftest.setting_configurations(
+                "maint set frame-cache persist", ("on", "off"), "persist-%s"
+            ),
+        )
+
+    def warm_up(self):
+        self.operation()
+
+    def operation(self):
+        for _ in range(0, 20):
+            gdb.execute("next", False, True)
+            gdb.execute("bt", False, True)
@@ -17,6 +17,7 @@ from __future__ import absolute_import
 
 import perftest.testresult as testresult
 import perftest.reporter as reporter
+import perftest.utils as utils
 from perftest.measure import Measure
 from perftest.measure import MeasurementPerfCounter
 from perftest.measure import MeasurementProcessTime
@@ -79,3 +80,47 @@ class TestCaseWithBasicMeasurements(TestCase):
             MeasurementVmSize(result_factory.create_result()),
         ]
         super(TestCaseWithBasicMeasurements, self).__init__(name, Measure(measurements))
+
+
+class TestCaseComparingSettings(TestCaseWithBasicMeasurements):
+    """Test case measuring the same operation with different settings.
+
+    Sub-classes should override method operation, which does the GDB
+    operations to measure.  They can also override method configure,
+    which is called after the settings are changed, for instance to
+    read the symbols again.
+    """
+
+    def __init__(self, name, configurations):
+        """Constructor of TestCaseComparingSettings.
+
+        Parameter configurations is a list of (label, commands) pairs.
+        For each of them, the GDB commands in commands are executed,
+        and then the operation is measured under the name label.
+        """
+        super(TestCaseComparingSettings, self).__init__(name)
+        self.configurations = configurations
+
+    def operation(self):
+        """Abstract method to do the operations to measure."""
+        raise NotImplementedError("Abstract Method.")
+
+    def configure(self):
+        """Prepare for a measurement, once the settings are changed."""
+        pass
+
+    def execute_test(self):
+        for label, commands in self.configurations:
+            for command in commands:
+                utils.safe_execute(command)
+            self.configure()
+            self.measure.measure(self.operation, label)
+
+
+def setting_configurations(command, values, label_format="%s"):
+    """Return the configurations setting command to each of values.
+
+    The result is suitable for TestCaseComparingSettings.  The label
+    of each configuration is label_format applied to its value.
+    """
+    return [(label_format % value, ["%s %s" % (command, value)]) for value in values]
@@ -0,0 +1,45 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures looking up lines of a big source file, with
+# and without the line table indexes.
+
+from perftest import perftest
+from perftest import utils
+
+
+class LineTableIndex(perftest.TestCaseComparingSettings):
+    def __init__(self, srcfile, func_count, lookup_count):
+        super(LineTableIndex, self).__init__(
+            "line-table-index",
+            perftest.setting_configurations(
+                "maint set line-table-index", ("on", "off")
+            ),
+        )
+        # Each function takes 8 lines, after the first line of the file.
+        # Look up lines with code and lines without, spread over the
+        # whole file.
+        line_count = func_count * 8
+        step = max(line_count // lookup_count, 1)
+        self.specs = []
+        for line in range(2, line_count + 2, step):
+            self.specs.append("%s:%d" % (srcfile, line))
+
+    def warm_up(self):
+        utils.safe_execute("maint expand-symtabs")
+
+    def operation(self):
+        for spec in self.specs:
+            gdb.decode_line(spec)
@@ -0,0 +1,47 @@
+# Copyright (C) 2021 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures loading and unloading shared libraries with
+# many breakpoints, with and without incremental breakpoint re-sets.
+
+from perftest import perftest
+from perftest import utils
+
+
+class SolibBreakpoints(perftest.TestCaseComparingSettings):
+    def __init__(self, solib_count, breakpoint_count):
+        super(SolibBreakpoints, self).__init__(
+            "solib-breakpoints",
+            perftest.setting_configurations(
+                "maint set breakpoint-re-set-incremental", ("on", "off")
+            ),
+        )
+        self.solib_count = solib_count
+        self.breakpoint_count = breakpoint_count
+
+    def warm_up(self):
+        utils.safe_execute("set breakpoint pending on")
+        for i in range(0, self.breakpoint_count):
+            if i % 2 == 0:
+                name = "shr%d" % ((i // 2) % self.solib_count)
+            else:
+                name = "no_such_function_%d" % i
+            utils.safe_execute("break " + name)
+        utils.safe_execute("call do_test_load (%d)" % self.solib_count)
+        utils.safe_execute("call do_test_unload (%d)" % self.solib_count)
+
+    def operation(self):
+        utils.safe_execute("call do_test_load (%d)" % self.solib_count)
+        utils.safe_execute("call do_test_unload (%d)" % self.solib_count)
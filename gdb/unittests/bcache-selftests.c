@@ -0,0 +1,188 @@
+/* Self tests for bcache and concurrent_bcache
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "bcache.h"
+#include "safe-ctype.h"
+
+#if CXX_STD_THREAD
+#include "gdbsupport/block-signals.h"
+#include <atomic>
+#include <thread>
+#endif
+
+namespace selftests {
+namespace bcache {
+
+/* A bcache that considers strings that only differ in case as
+   equal.  */
+
+struct nocase_bcache : public gdb::bcache
+{
+  unsigned long hash (const void *addr, int length) override
+  {
+    const char *str = (const char *) addr;
+    unsigned long result = 0;
+
+    for (int i = 0; i < length; ++i)
+      result = result * 67 + TOLOWER (str[i]);
+    return result;
+  }
+
+  int compare (const void *left, const void *right, int length) override
+  {
+    return strncasecmp ((const char *) left, (const char *) right,
+			length) == 0;
+  }
+};
+
+/* Check that a concurrent_bcache eliminates duplicates like a
+   bcache, and uses the hash and compare methods of its shards.  */
+
+static void
+test_single_thread ()
+{
+  gdb::bcache serial;
+  gdb::concurrent_bcache<> cache;
+  bool added;
+
+  const void *a = cache.insert ("abc", 4, &added);
+  SELF_CHECK (added);
+  SELF_CHECK (memcmp (a, "abc", 4) == 0);
+  SELF_CHECK (cache.insert ("abc", 4, &added) == a);
+  SELF_CHECK (!added);
+  SELF_CHECK (cache.insert ("ABC", 4, &added) != a);
+  SELF_CHECK (added);
+
+  SELF_CHECK (serial.insert ("abc", 4, &added) != a);
+  SELF_CHECK (added);
+
+  /* Zero bytes are part of the strings.  */
+  const void *b = cache.insert ("a\0b", 3, &added);
+  SELF_CHECK (added);
+  SELF_CHECK (cache.insert ("a\0c", 3, &added) != b);
+  SELF_CHECK (added);
+
+  gdb::concurrent_bcache<nocase_bcache> nocase;
+  const void *c = nocase.insert ("Hello", 5, &added);
+  SELF_CHECK (added);
+  SELF_CHECK (nocase.insert ("hELLO", 5, &added) == c);
+  SELF_CHECK (!added);
+  SELF_CHECK (memcmp (c, "Hello", 5) == 0);
+
+  SELF_CHECK (cache.memory_used () > 0);
+}
+
+#if CXX_STD_THREAD
+
+/* Have N_THREADS threads insert the same strings into a
+   concurrent_bcache at the same time, each in a different order.
+   If VARY_CASE, the odd threads insert the strings in upper case.
+   Check that each string is added exactly once, and that all the
+   threads get the same copy of it.  */
+
+template<typename T>
+static void
+test_threads (int n_threads, bool vary_case)
+{
+#define NUMBER 5000
+
+  gdb::concurrent_bcache<T> cache;
+  std::vector<std::string> keys, upper_keys;
+  for (int i = 0; i < NUMBER; ++i)
+    {
+      keys.push_back (string_printf ("key-%d", i));
+      upper_keys.push_back (string_printf ("KEY-%d", i));
+    }
+
+  std::vector<std::vector<const void *>> results (n_threads);
+  std::vector<std::atomic<int>> added_count (NUMBER);
+
+  auto work = [&] (int thread)
+    {
+      std::vector<const void *> &result = results[thread];
+
+      result.resize (NUMBER);
+      for (int n = 0; n < NUMBER; ++n)
+	{
+	  /* Thread 0 goes up, thread 1 goes down, and the others
+	     start in the middle.  */
+	  int i;
+	  if (thread == 1)
+	    i = NUMBER - 1 - n;
+	  else
+	    i = (n + thread * (NUMBER / n_threads)) % NUMBER;
+
+	  bool added;
+	  const std::string &key
+	    = vary_case && thread % 2 == 1 ? upper_keys[i] : keys[i];
+	  result[i] = cache.insert (key.c_str (), key.size () + 1, &added);
+	  if (added)
+	    ++added_count[i];
+	}
+    };
+
+  {
+    gdb::block_signals blocker;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < n_threads; ++t)
+      threads.emplace_back (work, t);
+    for (std::thread &thread : threads)
+      thread.join ();
+  }
+
+  for (int i = 0; i < NUMBER; ++i)
+    {
+      SELF_CHECK (added_count[i] == 1);
+      SELF_CHECK (strcasecmp ((const char *) results[0][i],
+			      keys[i].c_str ()) == 0);
+      for (int t = 1; t < n_threads; ++t)
+	SELF_CHECK (results[t][i] == results[0][i]);
+    }
+
+#undef NUMBER
+}
+
+static void
+test_n_threads ()
+{
+  test_threads<gdb::bcache> (1, false);
+  test_threads<gdb::bcache> (2, false);
+  test_threads<gdb::bcache> (8, false);
+  test_threads<nocase_bcache> (8, true);
+}
+
+#endif /* CXX_STD_THREAD */
+
+}
+}
+
+void _initialize_bcache_selftests ();
+void
+_initialize_bcache_selftests ()
+{
+  selftests::register_test ("bcache",
+			    selftests::bcache::test_single_thread);
+#if CXX_STD_THREAD
+  selftests::register_test ("concurrent_bcache",
+			    selftests::bcache::test_n_threads);
+#endif /* CXX_STD_THREAD */
+}
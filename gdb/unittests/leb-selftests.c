@@ -0,0 +1,136 @@
+/* Self tests for LEB128 decoding for GDB, the GNU debugger.
+
+   Copyright (C) 2021 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "dwarf2/leb.h"
+
+namespace selftests {
+namespace leb {
+
+/* Append the unsigned LEB128 encoding of VALUE to BUF.  */
+
+static void
+encode_unsigned (std::vector<gdb_byte> &buf, ULONGEST value)
+{
+  do
+    {
+      gdb_byte byte = value & 0x7f;
+      value >>= 7;
+      if (value != 0)
+	byte |= 0x80;
+      buf.push_back (byte);
+    }
+  while (value != 0);
+}
+
+/* Append the signed LEB128 encoding of VALUE to BUF.  */
+
+static void
+encode_signed (std::vector<gdb_byte> &buf, LONGEST value)
+{
+  while (true)
+    {
+      gdb_byte byte = value & 0x7f;
+      /* Arithmetic shift, keeping the sign.  */
+      value = value < 0 ? ~(~value >> 7) : value >> 7;
+      if ((value == 0 && (byte & 0x40) == 0)
+	  || (value == -1 && (byte & 0x40) != 0))
+	{
+	  buf.push_back (byte);
+	  break;
+	}
+      buf.push_back (byte | 0x80);
+    }
+}
+
+static void
+test_unsigned ()
+{
+  static const ULONGEST values[] = {
+    0, 1, 63, 64, 127, 128, 129, 300, 16383, 16384, 2097151, 2097152,
+    0xffffffff, (ULONGEST) 1 << 63, ~(ULONGEST) 0,
+  };
+
+  for (ULONGEST value : values)
+    {
+      std::vector<gdb_byte> buf;
+      encode_unsigned (buf, value);
+      /* Make sure the decoder doesn't read past the end of the number.  */
+      buf.push_back (0xff);
+
+      unsigned int bytes_read;
+      SELF_CHECK (read_unsigned_leb128 (nullptr, buf.data (), &bytes_read)
+		  == value);
+      SELF_CHECK (bytes_read == buf.size () - 1);
+    }
+
+  /* A non-minimal encoding of 0.  */
+  static const gdb_byte padded[] = { 0x80, 0x80, 0x00 };
+  unsigned int bytes_read;
+  SELF_CHECK (read_unsigned_leb128 (nullptr, padded, &bytes_read) == 0);
+  SELF_CHECK (bytes_read == 3);
+
+  /* A non-minimal encoding of 1, longer than 64 bits.  */
+  static const gdb_byte overlong[]
+    = { 0x81, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x00 };
+  SELF_CHECK (read_unsigned_leb128 (nullptr, overlong, &bytes_read) == 1);
+  SELF_CHECK (bytes_read == sizeof (overlong));
+}
+
+static void
+test_signed ()
+{
+  static const LONGEST values[] = {
+    0, 1, -1, 63, -63, 64, -64, 65, -65, 127, -128, 8191, -8192, 8192,
+    -8193, 0x7fffffff, -0x7fffffff - 1,
+    std::numeric_limits<LONGEST>::max (),
+    std::numeric_limits<LONGEST>::min (),
+  };
+
+  for (LONGEST value : values)
+    {
+      std::vector<gdb_byte> buf;
+      encode_signed (buf, value);
+      buf.push_back (0xff);
+
+      unsigned int bytes_read;
+      SELF_CHECK (read_signed_leb128 (nullptr, buf.data (), &bytes_read)
+		  == value);
+      SELF_CHECK (bytes_read == buf.size () - 1);
+    }
+}
+
+static void
+run_tests ()
+{
+  test_unsigned ();
+  test_signed ();
+}
+
+} /* namespace leb */
+} /* namespace selftests */
+
+void _initialize_leb_selftests ();
+void
+_initialize_leb_selftests ()
+{
+  selftests::register_test ("leb128", selftests::leb::run_tests);
+}
@@ -24,6 +24,8 @@
 #if CXX_STD_THREAD
 
 #include "gdbsupport/thread-pool.h"
+#include <chrono>
+#include <future>
 
 namespace selftests {
 namespace parallel_for {
@@ -63,12 +65,211 @@ test (int n_threads)
 #undef NUMBER
 }
 
+/* Check that every element is processed exactly once when the cost
+   of the elements is very uneven, and when the caller provides a cost
+   estimate.  */
+
+static void
+test_skewed (int n_threads)
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+
+#define NUMBER 1000
+
+  /* Make the first few elements much more expensive than the rest, so
+     that a static split would leave most threads idle.  */
+  auto cost = [] (int i) -> size_t
+    {
+      return i < 10 ? 10000 : 1;
+    };
+
+  std::vector<std::atomic<int>> seen (NUMBER);
+  auto work = [&] (int start, int end)
+    {
+      for (int i = start; i < end; ++i)
+	{
+	  volatile size_t sink = 0;
+	  for (size_t j = 0; j < cost (i); ++j)
+	    sink += j;
+	  ++seen[i];
+	}
+    };
+
+  gdb::parallel_for_each (0, NUMBER, work);
+  for (int i = 0; i < NUMBER; ++i)
+    SELF_CHECK (seen[i] == 1);
+
+  gdb::parallel_for_each (0, NUMBER, work, cost);
+  for (int i = 0; i < NUMBER; ++i)
+    SELF_CHECK (seen[i] == 2);
+
+#undef NUMBER
+}
+
+/* Check that parallel_for_each can be called from its own callback
+   without deadlocking, even when the pool has a single thread.  */
+
+static void
+test_nested (int n_threads)
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+
+#define NUMBER 100
+
+  std::atomic<int> counter (0);
+  gdb::parallel_for_each (0, NUMBER,
+			  [&] (int start, int end)
+			  {
+			    for (int i = start; i < end; ++i)
+			      gdb::parallel_for_each
+				(0, NUMBER,
+				 [&] (int inner_start, int inner_end)
+				 {
+				   counter += inner_end - inner_start;
+				 });
+			  });
+
+  SELF_CHECK (counter == NUMBER * NUMBER);
+
+#undef NUMBER
+}
+
+/* Check that an exception thrown by the callback reaches the
+   caller.  */
+
+static void
+test_exception (int n_threads)
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+
+  bool caught = false;
+  try
+    {
+      gdb::parallel_for_each (0, 1000,
+			      [&] (int start, int end)
+			      {
+				if (start <= 500 && 500 < end)
+				  error (_("failed"));
+			      });
+    }
+  catch (const gdb_exception_error &)
+    {
+      caught = true;
+    }
+
+  SELF_CHECK (caught);
+}
+
+/* Split the range from FIRST to LAST into one slice per thread, as
+   parallel_for_each did before it handed out chunks dynamically, and
+   process them with CALLBACK.  This is the baseline of
+   test_skewed_benchmark.  */
+
+static void
+static_parallel_for_each (int first, int last,
+			  gdb::function_view<void (int, int)> callback)
+{
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+  size_t elts_per_thread = (last - first) / n_threads;
+  std::vector<std::future<void>> futures;
+
+  for (size_t i = 0; i + 1 < n_threads; ++i)
+    {
+      int end = first + elts_per_thread;
+      futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+			 ([=] ()
+			  {
+			    callback (first, end);
+			  }));
+      first = end;
+    }
+
+  callback (first, last);
+  for (auto &future : futures)
+    future.wait ();
+}
+
+/* Time parallel_for_each on a skewed workload, whose first elements
+   are much more costly than the others, against a static split of the
+   range.  The cost of an element is spent sleeping, so that the
+   timings show how the work is spread over the threads whatever the
+   number of cores.  They are printed by "maint selftest -verbose".  */
+
+static void
+test_skewed_benchmark ()
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool::g_thread_pool->set_thread_count (3);
+
+#define NUMBER 400
+#define N_EXPENSIVE 20
+
+  const std::chrono::milliseconds expensive_cost (4);
+  auto cost = [] (int i) -> size_t
+    {
+      return i < N_EXPENSIVE ? 4000 : 1;
+    };
+
+  std::vector<std::atomic<int>> seen (NUMBER);
+  auto work = [&] (int start, int end)
+    {
+      for (int i = start; i < end; ++i)
+	{
+	  if (i < N_EXPENSIVE)
+	    std::this_thread::sleep_for (expensive_cost);
+	  ++seen[i];
+	}
+    };
+
+  auto time = [&] (const char *what, gdb::function_view<void ()> run)
+    {
+      auto start = std::chrono::steady_clock::now ();
+      run ();
+      auto elapsed = std::chrono::steady_clock::now () - start;
+      if (run_verbose ())
+	printf_unfiltered
+	  ("parallel_for skewed workload, %s: %d ms\n", what,
+	   (int) std::chrono::duration_cast<std::chrono::milliseconds>
+	     (elapsed).count ());
+    };
+
+  time ("one slice per thread",
+	[&] () { static_parallel_for_each (0, NUMBER, work); });
+  time ("dynamic chunks",
+	[&] () { gdb::parallel_for_each (0, NUMBER, work); });
+  time ("dynamic chunks with cost hint",
+	[&] () { gdb::parallel_for_each (0, NUMBER, work, cost); });
+
+  for (int i = 0; i < NUMBER; ++i)
+    SELF_CHECK (seen[i] == 3);
+
+#undef N_EXPENSIVE
+#undef NUMBER
+}
+
 static void
 test_n_threads ()
 {
   test (0);
   test (1);
   test (3);
+
+  test_skewed (0);
+  test_skewed (1);
+  test_skewed (3);
+
+  test_nested (0);
+  test_nested (1);
+  test_nested (3);
+
+  test_exception (0);
+  test_exception (1);
+  test_exception (3);
+
+  test_skewed_benchmark ();
 }
 
 }
@@ -21,7 +21,14 @@
 #define GDBSUPPORT_PARALLEL_FOR_H
 
 #include <algorithm>
+#include <vector>
+#include "gdbsupport/function-view.h"
 #if CXX_STD_THREAD
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include "gdbsupport/thread-pool.h"
 #endif
@@ -29,56 +36,226 @@
 namespace gdb
 {
 
+namespace detail
+{
+
+/* Wrapping a type in this keeps a function parameter of that type
+   from taking part in template argument deduction, so that callers
+   of parallel_for_each can pass a lambda as the task size
+   estimator.  */
+
+template<typename T>
+struct non_deduced
+{
+  typedef T type;
+};
+
+/* Split the N_ELEMENTS elements starting at FIRST into chunks that
+   can be handed out to N_THREADS threads, and return the chunk
+   boundaries, as offsets from FIRST.  The result always starts with 0
+   and ends with N_ELEMENTS.
+
+   Several chunks are created per thread, so that a thread that
+   happens to get cheap elements can come back for more work instead
+   of idling while the others finish.  If TASK_SIZE is not NULL, it
+   estimates the cost of processing an element, and the chunks are
+   balanced by cost rather than by element count.  */
+
+template<class RandomIt>
+std::vector<size_t>
+compute_chunks (RandomIt first, size_t n_elements, size_t n_threads,
+		gdb::function_view<size_t (RandomIt)> task_size)
+{
+  /* How many chunks to create per thread.  More chunks make for a
+     better balance, at the cost of more synchronization.  */
+  const size_t chunks_per_thread = 8;
+  /* Arbitrarily require that there should be at least 10 elements in
+     a chunk, unless the caller told us how costly each element is.  */
+  const size_t min_elements_per_chunk = 10;
+
+  std::vector<size_t> boundaries;
+  boundaries.push_back (0);
+
+  size_t n_chunks = std::max (n_threads * chunks_per_thread, (size_t) 1);
+
+  if (task_size == nullptr)
+    {
+      size_t chunk_size = std::max (n_elements / n_chunks,
+				    min_elements_per_chunk);
+      for (size_t i = chunk_size; i < n_elements; i += chunk_size)
+	boundaries.push_back (i);
+    }
+  else
+    {
+      size_t total_size = 0;
+      for (size_t i = 0; i < n_elements; ++i)
+	total_size += task_size (first + i);
+
+      size_t target_size = std::max (total_size / n_chunks, (size_t) 1);
+      size_t current_size = 0;
+      for (size_t i = 0; i < n_elements; ++i)
+	{
+	  current_size += task_size (first + i);
+	  if (current_size >= target_size && i + 1 < n_elements)
+	    {
+	      boundaries.push_back (i + 1);
+	      current_size = 0;
+	    }
+	}
+    }
+
+  boundaries.push_back (n_elements);
+  return boundaries;
+}
+
+#if CXX_STD_THREAD
+
+/* The state of a parallel_for_each call that is shared between all
+   the threads working on it.  It is reference-counted, because a
+   worker thread may only get to run its task after all the work has
+   already been done by other threads.  */
+
+struct parallel_for_state
+{
+  explicit parallel_for_state (std::vector<size_t> &&boundaries_)
+    : boundaries (std::move (boundaries_)),
+      n_chunks (boundaries.size () - 1),
+      n_pending (n_chunks)
+  {
+  }
+
+  /* The chunk boundaries, see compute_chunks.  */
+  const std::vector<size_t> boundaries;
+
+  /* The number of chunks.  */
+  const size_t n_chunks;
+
+  /* The index of the next chunk to hand out.  */
+  std::atomic<size_t> next_chunk {0};
+
+  /* The number of chunks that have not been completed yet, and the
+     first exception thrown by the callback, if any.  Both are
+     protected by MUTEX; CV is notified when N_PENDING drops to
+     zero.  */
+  size_t n_pending;
+  std::exception_ptr exception;
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+/* Process chunks of the range starting at FIRST by calling CALLBACK,
+   until there are no more chunks to hand out.  CALLBACK is only
+   accessed while some chunk is still pending, so it is fine for it to
+   be destroyed once all the chunks are done.  */
+
+template<class RandomIt, class RangeFunction>
+void
+process_chunks (parallel_for_state &state, RandomIt first,
+		RangeFunction &callback)
+{
+  while (true)
+    {
+      size_t chunk = state.next_chunk++;
+      if (chunk >= state.n_chunks)
+	break;
+
+      std::exception_ptr exception;
+      try
+	{
+	  callback (first + state.boundaries[chunk],
+		    first + state.boundaries[chunk + 1]);
+	}
+      catch (...)
+	{
+	  exception = std::current_exception ();
+	}
+
+      std::lock_guard<std::mutex> guard (state.mutex);
+      if (exception != nullptr && state.exception == nullptr)
+	state.exception = exception;
+      if (--state.n_pending == 0)
+	state.cv.notify_all ();
+    }
+}
+
+#endif /* CXX_STD_THREAD */
+
+}
+
 /* A very simple "parallel for".  This splits the range of iterators
    into subranges, and then passes each subrange to the callback.  The
    work may or may not be done in separate threads.
 
    This approach was chosen over having the callback work on single
    items because it makes it simple for the caller to do
-   once-per-subrange initialization and destruction.  */
+   once-per-subrange initialization and destruction.
+
+   The range is split into more subranges than there are threads, and
+   the subranges are handed out dynamically: a thread that is done
+   with its subrange picks the next unprocessed one.  This way, a few
+   expensive elements do not leave the other threads idle.  If
+   TASK_SIZE is not NULL, it is called for each element to estimate
+   the cost of processing it, and the subranges are balanced using
+   these estimates.
+
+   The calling thread takes part in the work, and only waits for
+   subranges that have actually been started by other threads.  This
+   means that it is safe to call parallel_for_each from a callback of
+   another parallel_for_each, or from any other task running in the
+   thread pool.
+
+   If CALLBACK throws an exception, the other subranges are still
+   processed, and then the first exception is rethrown in the calling
+   thread.  */
 
 template<class RandomIt, class RangeFunction>
 void
-parallel_for_each (RandomIt first, RandomIt last, RangeFunction callback)
+parallel_for_each (RandomIt first, RandomIt last, RangeFunction callback,
+		   gdb::function_view
+		     <size_t (typename detail::non_deduced<RandomIt>::type)>
+		     task_size = nullptr)
 {
 #if CXX_STD_THREAD
-  /* So we can use a local array below.  */
-  const size_t local_max = 16;
-  size_t n_threads = std::min (thread_pool::g_thread_pool->thread_count (),
-			       local_max);
-  size_t n_actual_threads = 0;
-  std::future<void> futures[local_max];
-
+  size_t n_threads = thread_pool::g_thread_pool->thread_count ();
   size_t n_elements = last - first;
-  if (n_threads > 1)
+
+  if (n_threads > 0 && n_elements > 1)
     {
-      /* Arbitrarily require that there should be at least 10 elements
-	 in a thread.  */
-      if (n_elements / n_threads < 10)
-	n_threads = std::max (n_elements / 10, (size_t) 1);
-      size_t elts_per_thread = n_elements / n_threads;
-      n_actual_threads = n_threads - 1;
-      for (int i = 0; i < n_actual_threads; ++i)
+      /* Count the calling thread too.  */
+      std::vector<size_t> boundaries
+	= detail::compute_chunks (first, n_elements, n_threads + 1,
+				  task_size);
+
+      if (boundaries.size () > 2)
 	{
-	  RandomIt end = first + elts_per_thread;
-	  auto task = [=] ()
-		      {
-			callback (first, end);
-		      };
-
-	  futures[i] = gdb::thread_pool::g_thread_pool->post_task (task);
-	  first = end;
+	  auto state = std::make_shared<detail::parallel_for_state>
+	    (std::move (boundaries));
+
+	  size_t n_helpers = std::min (n_threads, state->n_chunks - 1);
+	  for (size_t i = 0; i < n_helpers; ++i)
+	    {
+	      RangeFunction *callback_ptr = &callback;
+	      gdb::thread_pool::g_thread_pool->post_task
+		([=] ()
+		 {
+		   detail::process_chunks (*state, first, *callback_ptr);
+		 });
+	    }
+
+	  detail::process_chunks (*state, first, callback);
+
+	  std::unique_lock<std::mutex> guard (state->mutex);
+	  while (state->n_pending > 0)
+	    state->cv.wait (guard);
+	  if (state->exception != nullptr)
+	    std::rethrow_exception (state->exception);
+	  return;
 	}
     }
 #endif /* CXX_STD_THREAD */
 
-  /* Process all the remaining elements in the main thread.  */
+  /* Process all the elements in the calling thread.  */
   callback (first, last);
-
-#if CXX_STD_THREAD
-  for (int i = 0; i < n_actual_threads; ++i)
-    futures[i].wait ();
-#endif /* CXX_STD_THREAD */
 }
 
 }
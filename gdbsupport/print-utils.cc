@@ -24,13 +24,15 @@
 /* Number of cells in the circular buffer.  */
 #define NUMCELLS 16
 
-/* Return the next entry in the circular buffer.  */
+/* Return the next entry in the circular buffer.  Each thread has its
+   own buffer, as these functions are used when formatting complaints
+   on worker threads.  */
 
 char *
 get_print_cell (void)
 {
-  static char buf[NUMCELLS][PRINT_CELL_SIZE];
-  static int cell = 0;
+  static thread_local char buf[NUMCELLS][PRINT_CELL_SIZE];
+  static thread_local int cell = 0;
 
   if (++cell >= NUMCELLS)
     cell = 0;